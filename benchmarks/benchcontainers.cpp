@@ -0,0 +1,172 @@
+#include "benchhelper.h"
+
+#include "toolboxqt/containers/array2d.h"
+#include "toolboxqt/containers/array2dallocator.h"
+
+#include <QVector>
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace bench
+{
+
+/*****************************/
+/* Constants definitions     */
+/*****************************/
+
+static const int NB_RUNS = 5;
+
+/*****************************/
+/* Functions implementation  */
+/*         Local             */
+/*****************************/
+
+template<typename Layout>
+static void fillArray(tbq::Array2D<float, Layout> &array)
+{
+    for(size_t row = 0; row < array.getRows(); ++row){
+        for(size_t col = 0; col < array.getCols(); ++col){
+            array(row, col) = static_cast<float>(row * array.getCols() + col);
+        }
+    }
+}
+
+template<typename Layout>
+static float sumByColumns(const tbq::Array2D<float, Layout> &array)
+{
+    float sum = 0.0f;
+    for(size_t col = 0; col < array.getCols(); ++col){
+        for(size_t row = 0; row < array.getRows(); ++row){
+            sum += array(row, col);
+        }
+    }
+
+    return sum;
+}
+
+static void benchTransposeSize(size_t nbRows, size_t nbCols)
+{
+    printTitle(QStringLiteral("Transpose float %1x%2").arg(nbRows).arg(nbCols));
+
+    tbq::Array2D<float> src(nbRows, nbCols);
+    fillArray(src);
+
+    /* Reference: naive double loop */
+    tbq::Array2D<float> dst(nbCols, nbRows);
+    const double msecNaive = measure(NB_RUNS, [&](){
+        for(size_t row = 0; row < nbRows; ++row){
+            for(size_t col = 0; col < nbCols; ++col){
+                dst(col, row) = src(row, col);
+            }
+        }
+        keep(dst(0, 0));
+    });
+    printResult(QStringLiteral("naive double loop"), msecNaive, msecNaive);
+
+    const double msecCopy = measure(NB_RUNS, [&](){
+        keep(src.transposed()(0, 0));
+    });
+    printResult(QStringLiteral("transposed()"), msecCopy, msecNaive);
+
+    if(nbRows == nbCols){
+        const double msecInPlace = measure(NB_RUNS, [&](){
+            src.transpose();
+            keep(src(0, 0));
+        });
+        printResult(QStringLiteral("transpose() in-place"), msecInPlace, msecNaive);
+    }
+
+    const double msecLayout = measure(NB_RUNS, [&](){
+        keep(tbq::Array2D<float, tbq::Array2DLayoutColMajor>(src)(0, 0));
+    });
+    printResult(QStringLiteral("row-major to column-major"), msecLayout, msecNaive);
+}
+
+static void benchColumnSweep(size_t nbRows, size_t nbCols)
+{
+    printTitle(QStringLiteral("Column-wise sweep float %1x%2").arg(nbRows).arg(nbCols));
+
+    tbq::Array2D<float> rowMajor(nbRows, nbCols);
+    fillArray(rowMajor);
+    const tbq::Array2D<float, tbq::Array2DLayoutColMajor> colMajor(rowMajor);
+
+    const double msecRowMajor = measure(NB_RUNS, [&](){
+        keep(sumByColumns(rowMajor));
+    });
+    printResult(QStringLiteral("row-major layout"), msecRowMajor, msecRowMajor);
+
+    const double msecColMajor = measure(NB_RUNS, [&](){
+        keep(sumByColumns(colMajor));
+    });
+    printResult(QStringLiteral("column-major layout"), msecColMajor, msecRowMajor);
+}
+
+/* Simulate a short-lived temporary: allocate, write and destroy */
+template<typename Allocator>
+static double measureTemporaries(size_t nbRows, size_t nbCols, int nbTemporaries)
+{
+    return measure(NB_RUNS, [&](){
+        for(int i = 0; i < nbTemporaries; ++i){
+            tbq::Array2D<float, tbq::Array2DLayoutRowMajor, Allocator> tmp(nbRows, nbCols);
+            tmp(nbRows - 1, nbCols - 1) = static_cast<float>(i);
+            keep(tmp(0, 0) + tmp(nbRows - 1, nbCols - 1));
+        }
+    });
+}
+
+static void benchAllocatorsSize(size_t nbRows, size_t nbCols, int nbTemporaries)
+{
+    printTitle(QStringLiteral("%1 temporaries float %2x%3").arg(nbTemporaries).arg(nbRows).arg(nbCols));
+
+    /* Reference: QVector backing */
+    const int size = static_cast<int>(nbRows * nbCols);
+    const double msecVector = measure(NB_RUNS, [&](){
+        for(int i = 0; i < nbTemporaries; ++i){
+            QVector<float> tmp(size);
+            tmp[size - 1] = static_cast<float>(i);
+            keep(tmp.at(0) + tmp.at(size - 1));
+        }
+    });
+    printResult(QStringLiteral("QVector"), msecVector, msecVector);
+
+    printResult(QStringLiteral("Array2DAllocatorHeap"), measureTemporaries<tbq::Array2DAllocatorHeap>(nbRows, nbCols, nbTemporaries), msecVector);
+    printResult(QStringLiteral("Array2DAllocatorAligned<64>"), measureTemporaries<tbq::Array2DAllocatorAligned<64> >(nbRows, nbCols, nbTemporaries), msecVector);
+    printResult(QStringLiteral("Array2DAllocatorPool"), measureTemporaries<tbq::Array2DAllocatorPool>(nbRows, nbCols, nbTemporaries), msecVector);
+}
+
+/*****************************/
+/* Functions implementation  */
+/*****************************/
+
+/*!
+ * \brief Compare cache-blocked transposition with a naive
+ * double loop, and column-wise sweeps of both layouts
+ */
+void benchTranspose()
+{
+    benchTransposeSize(1024, 1024);
+    benchTransposeSize(4096, 4096);
+    benchTransposeSize(3000, 5000);
+
+    benchColumnSweep(4096, 4096);
+}
+
+/*!
+ * \brief Compare allocator policies of tbq::Array2D with a
+ * \c QVector backing, on short-lived temporaries
+ */
+void benchAllocators()
+{
+    benchAllocatorsSize(64, 64, 20000);
+    benchAllocatorsSize(1024, 1024, 500);
+
+    tbq::Array2DAllocatorPool::releaseCached();
+}
+
+/*****************************/
+/* End namespace             */
+/*****************************/
+
+} // namespace bench
@@ -0,0 +1,108 @@
+#ifndef TBQ_BENCH_BENCHHELPER_H
+#define TBQ_BENCH_BENCHHELPER_H
+
+#include <QElapsedTimer>
+#include <QString>
+
+#include <cstdio>
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace bench
+{
+
+/*****************************/
+/* Functions definitions     */
+/*****************************/
+
+/*!
+ * \brief Measure duration of a function
+ * \details
+ * Function is run \c nbRuns times and best
+ * duration is kept, to filter system noise.
+ *
+ * \param[in] nbRuns
+ * Number of runs.
+ * \param[in] fct
+ * Function to measure.
+ *
+ * \return
+ * Returns best duration in milliseconds.
+ */
+template<typename Fct>
+double measure(int nbRuns, Fct fct)
+{
+    double best = -1.0;
+    for(int i = 0; i < nbRuns; ++i){
+        QElapsedTimer timer;
+        timer.start();
+        fct();
+
+        const double elapsed = static_cast<double>(timer.nsecsElapsed()) / 1e6;
+        if(best < 0.0 || elapsed < best){
+            best = elapsed;
+        }
+    }
+
+    return best;
+}
+
+/*!
+ * \brief Print title of a group of results
+ *
+ * \param[in] title
+ * Title to print.
+ */
+inline void printTitle(const QString &title)
+{
+    std::printf("\n%s\n", qPrintable(title));
+}
+
+/*!
+ * \brief Print a result, compared to a reference
+ *
+ * \param[in] name
+ * Name of measured case.
+ * \param[in] msec
+ * Duration of the case in milliseconds.
+ * \param[in] msecRef
+ * Duration of reference case in milliseconds, used to
+ * print speedup of this case.
+ */
+inline void printResult(const QString &name, double msec, double msecRef)
+{
+    std::printf("  %-40s %10.3f ms  x%.2f\n", qPrintable(name), msec, msec > 0.0 ? msecRef / msec : 0.0);
+}
+
+/*!
+ * \brief Prevent compiler from optimizing away
+ * a computed value
+ *
+ * \param[in] value
+ * Value to keep.
+ */
+template<typename T>
+void keep(const T &value)
+{
+    static volatile T sink;
+    sink = value;
+    Q_UNUSED(sink)
+}
+
+/*****************************/
+/* Benchmarks definitions    */
+/*****************************/
+
+void benchTranspose();
+void benchAllocators();
+void benchSettings();
+
+/*****************************/
+/* End namespace             */
+/*****************************/
+
+} // namespace bench
+
+#endif // TBQ_BENCH_BENCHHELPER_H
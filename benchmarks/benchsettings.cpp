@@ -0,0 +1,126 @@
+#include "benchhelper.h"
+
+#include "toolboxqt/core/iniparser.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QSettings>
+#include <QStringList>
+#include <QTemporaryDir>
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace bench
+{
+
+/*****************************/
+/* Constants definitions     */
+/*****************************/
+
+static const int NB_RUNS = 3;
+static const int NB_KEYS_PER_GROUP = 20;
+
+/*****************************/
+/* Functions implementation  */
+/*         Local             */
+/*****************************/
+
+/* Generate an INI file using integers, strings needing escaping and lists, like QSettings writes them */
+static bool generateFile(const QString &filePath, qint64 size)
+{
+    QByteArray content;
+    content.reserve(static_cast<int>(size + 1024));
+
+    for(int group = 0; content.size() < size; ++group){
+        content += "[group" + QByteArray::number(group) + "]\n";
+
+        for(int key = 0; key < NB_KEYS_PER_GROUP; ++key){
+            content += "key" + QByteArray::number(key);
+            switch(key % 4){
+                case 0: content += "=" + QByteArray::number(group * NB_KEYS_PER_GROUP + key) + "\n"; break;
+                case 1: content += "=some text value\n"; break;
+                case 2: content += "=\"quoted, with comma\\tand tab\"\n"; break;
+                default: content += "=first, second, third\n"; break;
+            }
+        }
+
+        content += "\n";
+    }
+
+    QFile file(filePath);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate)){
+        return false;
+    }
+
+    return file.write(content) == content.size();
+}
+
+static void benchLoadSize(const QString &dirPath, const QString &name, qint64 size)
+{
+    printTitle(QStringLiteral("Load INI file of %1").arg(name));
+
+    const QString filePath = dirPath + QStringLiteral("/bench-") + name + QStringLiteral(".ini");
+    if(!generateFile(filePath, size)){
+        std::fprintf(stderr, "  Unable to generate file: %s\n", qPrintable(filePath));
+        return;
+    }
+
+    /* Reference: QSettings path of tbq::SettingsIni */
+    const double msecSettings = measure(NB_RUNS, [&](){
+        tbq::IniParser::Values values;
+
+        QSettings settings(filePath, QSettings::IniFormat);
+        const QStringList keys = settings.allKeys();
+        for(const QString &key : keys){
+            values.insert(key, settings.value(key));
+        }
+
+        keep(values.size());
+    });
+    printResult(QStringLiteral("QSettings"), msecSettings, msecSettings);
+
+    const double msecMapped = measure(NB_RUNS, [&](){
+        tbq::IniParser::Values values;
+        tbq::IniParser::parseFile(filePath, values);
+        keep(values.size());
+    });
+    printResult(QStringLiteral("IniParser (mapped file)"), msecMapped, msecSettings);
+
+    const double msecRead = measure(NB_RUNS, [&](){
+        tbq::IniParser::Values values;
+        tbq::IniParser::parseFile(filePath, values, false);
+        keep(values.size());
+    });
+    printResult(QStringLiteral("IniParser (read file)"), msecRead, msecSettings);
+
+    QFile::remove(filePath);
+}
+
+/*****************************/
+/* Functions implementation  */
+/*****************************/
+
+/*!
+ * \brief Compare load time of tbq::IniParser with
+ * \c QSettings, on synthetic files of multiple sizes
+ */
+void benchSettings()
+{
+    QTemporaryDir dir;
+    if(!dir.isValid()){
+        std::fprintf(stderr, "Unable to create temporary directory\n");
+        return;
+    }
+
+    benchLoadSize(dir.path(), QStringLiteral("1KB"), 1024);
+    benchLoadSize(dir.path(), QStringLiteral("1MB"), 1024 * 1024);
+    benchLoadSize(dir.path(), QStringLiteral("50MB"), 50 * 1024 * 1024);
+}
+
+/*****************************/
+/* End namespace             */
+/*****************************/
+
+} // namespace bench
@@ -0,0 +1,37 @@
+#include "benchhelper.h"
+
+#include <QCoreApplication>
+#include <QStringList>
+
+/*****************************/
+/* Main method               */
+/*****************************/
+
+/*
+ * Usage: toolboxqt-benchmarks [group...]
+ * When no group is provided, all groups are run.
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QStringList groups = app.arguments().mid(1);
+    if(groups.isEmpty()){
+        groups << QStringLiteral("transpose") << QStringLiteral("allocators") << QStringLiteral("settings");
+    }
+
+    for(const QString &group : groups){
+        if(group == QLatin1String("transpose")){
+            bench::benchTranspose();
+        }else if(group == QLatin1String("allocators")){
+            bench::benchAllocators();
+        }else if(group == QLatin1String("settings")){
+            bench::benchSettings();
+        }else{
+            std::fprintf(stderr, "Unknown benchmark group: %s\n", qPrintable(group));
+            return 1;
+        }
+    }
+
+    return 0;
+}
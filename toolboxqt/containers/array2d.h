@@ -2,7 +2,11 @@
 #define TBQ_CONTAINER_ARRAY2D_H
 
 #include "toolboxqt/toolboxqt_global.h"
-#include <QVector>
+#include "toolboxqt/containers/array2dstorage.h"
+#include "toolboxqt/containers/array2dview.h"
+
+#include <algorithm>
+#include <utility>
 
 /*****************************/
 /* Start namespace           */
@@ -11,6 +15,52 @@
 namespace tbq
 {
 
+/*****************************/
+/*   Layouts definitions     */
+/*****************************/
+
+/*!
+ * \brief Layout storing elements row by row
+ * \details
+ * Element at position <tt>(row, col)</tt> is stored
+ * at index <tt>row * nbCols + col</tt>. \n
+ * This is the default layout of tbq::Array2D, suited
+ * for row-wise sweeps.
+ */
+struct Array2DLayoutRowMajor
+{
+    static constexpr bool IS_ROW_MAJOR = true;
+
+    static size_t index(size_t row, size_t col, size_t nbRows, size_t nbCols) { Q_UNUSED(nbRows) return row * nbCols + col; }
+    static size_t rowStride(size_t nbRows, size_t nbCols) { Q_UNUSED(nbRows) return nbCols; }
+    static size_t colStride(size_t nbRows, size_t nbCols) { Q_UNUSED(nbRows) Q_UNUSED(nbCols) return 1; }
+    static void position(size_t index, size_t nbRows, size_t nbCols, size_t &row, size_t &col) { Q_UNUSED(nbRows) row = index / nbCols; col = index % nbCols; }
+};
+
+/*!
+ * \brief Layout storing elements column by column
+ * \details
+ * Element at position <tt>(row, col)</tt> is stored
+ * at index <tt>col * nbRows + row</tt>. \n
+ * This layout is suited for column-wise sweeps.
+ */
+struct Array2DLayoutColMajor
+{
+    static constexpr bool IS_ROW_MAJOR = false;
+
+    static size_t index(size_t row, size_t col, size_t nbRows, size_t nbCols) { Q_UNUSED(nbCols) return col * nbRows + row; }
+    static size_t rowStride(size_t nbRows, size_t nbCols) { Q_UNUSED(nbRows) Q_UNUSED(nbCols) return 1; }
+    static size_t colStride(size_t nbRows, size_t nbCols) { Q_UNUSED(nbCols) return nbRows; }
+    static void position(size_t index, size_t nbRows, size_t nbCols, size_t &row, size_t &col) { Q_UNUSED(nbCols) col = index / nbRows; row = index % nbRows; }
+};
+
+/*****************************/
+/*   Forward declarations    */
+/*****************************/
+
+template <typename Derived>
+class Array2DExpr;
+
 /*****************************/
 /* Define template interface */
 /*****************************/
@@ -18,14 +68,35 @@ namespace tbq
 /*!
  * \class Array2D
  * \brief Use to manage a 2-dimensional array
+ * \details
+ * Storage order of elements is defined by \c Layout,
+ * which can be tbq::Array2DLayoutRowMajor (default) or
+ * tbq::Array2DLayoutColMajor.
+ *
+ * Elements are stored in a tbq::Array2DStorage, so number of
+ * elements is only limited by available memory (and not by
+ * \c int range like \c QVector on Qt 5). Memory is provided
+ * by \c Allocator policy, see tbq::Array2DAllocatorHeap (default),
+ * tbq::Array2DAllocatorAligned and tbq::Array2DAllocatorPool.
+ *
+ * Element-wise arithmetic is provided by expression templates,
+ * see tbq::Array2DExpr.
  */
-template <typename T>
+template <typename T, typename Layout = Array2DLayoutRowMajor, typename Allocator = Array2DAllocatorHeap>
 class TOOLBOXQT_EXPORT Array2D
 {
 
 public:
     explicit Array2D();
     explicit Array2D(size_t nbRows, size_t nbCols);
+    Array2D(const Array2D &other) = default;
+    Array2D(Array2D &&other) noexcept;
+
+    template<typename OtherLayout, typename OtherAllocator>
+    explicit Array2D(const Array2D<T, OtherLayout, OtherAllocator> &other);
+
+    template<typename Expr>
+    Array2D(const Array2DExpr<Expr> &expr);
 
 public:
     size_t getRows() const;
@@ -34,31 +105,63 @@ public:
 
 public:
     void clear();
-    void resize(size_t nbRows, size_t nbCols);
+    bool resize(size_t nbRows, size_t nbCols);
 
     void insert(size_t row, size_t col, const T &value);
 
+    void transpose();
+    Array2D transposed() const;
+
 public:
+    T* data();
+    const T* data() const;
+
+    Array2DLineView<T> rowView(size_t row);
+    Array2DLineView<const T> rowView(size_t row) const;
+
+    Array2DLineView<T> colView(size_t col);
+    Array2DLineView<const T> colView(size_t col) const;
+
+    Array2DView<T> view();
+    Array2DView<const T> view() const;
+
+    Array2DView<T> subView(size_t row, size_t col, size_t nbRows, size_t nbCols);
+    Array2DView<const T> subView(size_t row, size_t col, size_t nbRows, size_t nbCols) const;
+
+public:
+    Array2D& operator=(const Array2D &other) = default;
+    Array2D& operator=(Array2D &&other) noexcept;
+
+    template<typename Expr>
+    Array2D& operator=(const Array2DExpr<Expr> &expr);
+
     T& operator()(size_t row, size_t col);
     const T& operator()(size_t row, size_t col) const;
 
 public: // Friends operator defined using "Making new friends" idiom (https://en.wikibooks.org/wiki/More_C%2B%2B_Idioms/Making_New_Friends)
-    friend bool operator==(const Array2D<T> &left, const Array2D<T> &right)
+    friend bool operator==(const Array2D &left, const Array2D &right)
     {
         return left.m_rows == right.m_rows
             && left.m_cols == right.m_cols
             && left.m_data == right.m_data;
     }
 
-    friend bool operator!=(const Array2D<T> &left, const Array2D<T> &right)
+    friend bool operator!=(const Array2D &left, const Array2D &right)
     {
         return !(left == right);
     }
 
+private:
+    static void transposeCopy(const T *src, size_t srcStride, T *dst, size_t dstStride, size_t nbRows, size_t nbCols);
+    static void transposeSwap(T *data, size_t size);
+
+private:
+    static constexpr size_t TRANSPOSE_TILE = 16;
+
 private:
     size_t m_rows;
     size_t m_cols;
-    QVector<T> m_data;
+    Array2DStorage<T, Allocator> m_data;
 };
 
 /*****************************/
@@ -74,23 +177,74 @@ private:
  * Number of rows.
  * \param[in] nbCols
  * Number of colums
+ *
+ * \note
+ * If memory can't be allocated, array will be
+ * empty, use resize() to detect allocation failure.
  */
-template<typename T>
-Array2D<T>::Array2D(size_t nbRows, size_t nbCols)
+template<typename T, typename Layout, typename Allocator>
+Array2D<T, Layout, Allocator>::Array2D(size_t nbRows, size_t nbCols)
+    : m_rows(0), m_cols(0)
 {
-    resize(m_rows, m_cols);
+    resize(nbRows, nbCols);
 }
 
 /*!
  * \brief Construct an empty 2D array
  */
-template<typename T>
-Array2D<T>::Array2D()
+template<typename T, typename Layout, typename Allocator>
+Array2D<T, Layout, Allocator>::Array2D()
     : m_rows(0), m_cols(0)
 {
     /* Nothing to do */
 }
 
+/*!
+ * \brief Construct a 2D array by taking elements
+ * of another one
+ *
+ * \param[in, out] other
+ * Array to move, will be empty after the call.
+ */
+template<typename T, typename Layout, typename Allocator>
+Array2D<T, Layout, Allocator>::Array2D(Array2D &&other) noexcept
+    : m_rows(other.m_rows), m_cols(other.m_cols), m_data(std::move(other.m_data))
+{
+    other.m_rows = 0;
+    other.m_cols = 0;
+}
+
+/*!
+ * \brief Construct a 2D array from an array
+ * using another layout or allocator
+ * \details
+ * When layouts differ, a cache-blocked transposition of
+ * the storage is performed, so this is the efficient way to
+ * switch layout before a column-heavy (or row-heavy) workload.
+ *
+ * \param[in] other
+ * Array to copy.
+ */
+template<typename T, typename Layout, typename Allocator>
+template<typename OtherLayout, typename OtherAllocator>
+Array2D<T, Layout, Allocator>::Array2D(const Array2D<T, OtherLayout, OtherAllocator> &other)
+    : m_rows(0), m_cols(0)
+{
+    if(!resize(other.getRows(), other.getCols()) || getSize() == 0){
+        return;
+    }
+
+    if(Layout::IS_ROW_MAJOR == OtherLayout::IS_ROW_MAJOR){
+        std::copy(other.data(), other.data() + other.getSize(), data());
+        return;
+    }
+
+    /* Storage of other is the transposed storage of this layout */
+    const size_t otherStoreRows = OtherLayout::IS_ROW_MAJOR ? m_rows : m_cols;
+    const size_t otherStoreCols = OtherLayout::IS_ROW_MAJOR ? m_cols : m_rows;
+    transposeCopy(other.data(), otherStoreCols, data(), otherStoreRows, otherStoreRows, otherStoreCols);
+}
+
 /*!
  * \brief Get number of rows
  *
@@ -99,8 +253,8 @@ Array2D<T>::Array2D()
  *
  * \sa getCols(), getSize()
  */
-template<typename T>
-size_t Array2D<T>::getRows() const
+template<typename T, typename Layout, typename Allocator>
+size_t Array2D<T, Layout, Allocator>::getRows() const
 {
     return m_rows;
 }
@@ -113,8 +267,8 @@ size_t Array2D<T>::getRows() const
  *
  * \sa getRows(), getSize()
  */
-template<typename T>
-size_t Array2D<T>::getCols() const
+template<typename T, typename Layout, typename Allocator>
+size_t Array2D<T, Layout, Allocator>::getCols() const
 {
     return m_cols;
 }
@@ -128,8 +282,8 @@ size_t Array2D<T>::getCols() const
  *
  * \sa getRows(), getCols()
  */
-template<typename T>
-size_t Array2D<T>::getSize() const
+template<typename T, typename Layout, typename Allocator>
+size_t Array2D<T, Layout, Allocator>::getSize() const
 {
     return m_rows * m_cols;
 }
@@ -146,8 +300,8 @@ size_t Array2D<T>::getSize() const
  *
  * \sa resize()
  */
-template<typename T>
-void Array2D<T>::clear()
+template<typename T, typename Layout, typename Allocator>
+void Array2D<T, Layout, Allocator>::clear()
 {
     m_rows = 0;
     m_cols = 0;
@@ -162,16 +316,30 @@ void Array2D<T>::clear()
  * \param[in] nbCols
  * Number of colums
  *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if number of elements overflows or if memory
+ * can't be allocated, array is left unchanged.
+ *
  * \note
  * This method will only extend \b capacity of the 2D array,
  * no shrink operation will be performed.
  */
-template<typename T>
-void Array2D<T>::resize(size_t nbRows, size_t nbCols)
+template<typename T, typename Layout, typename Allocator>
+bool Array2D<T, Layout, Allocator>::resize(size_t nbRows, size_t nbCols)
 {
+    if(nbCols != 0 && nbRows > Array2DStorage<T, Allocator>::getMaxSize() / nbCols){
+        return false;
+    }
+
+    if(!m_data.resize(nbRows * nbCols)){
+        return false;
+    }
+
     m_rows = nbRows;
     m_cols = nbCols;
-    m_data.resize(m_rows * m_cols);
+
+    return true;
 }
 
 /*!
@@ -187,12 +355,232 @@ void Array2D<T>::resize(size_t nbRows, size_t nbCols)
  * \param[in] value
  * Value to insert
  */
-template<typename T>
-void Array2D<T>::insert(size_t row, size_t col, const T &value)
+template<typename T, typename Layout, typename Allocator>
+void Array2D<T, Layout, Allocator>::insert(size_t row, size_t col, const T &value)
 {
     (*this)(row, col) = value;
 }
 
+/*!
+ * \brief Transpose the 2D array
+ * \details
+ * Number of rows and columns are swapped and element
+ * at position <tt>(row, col)</tt> is moved to position
+ * <tt>(col, row)</tt>. \n
+ * Square arrays are transposed in-place using a cache-blocked
+ * algorithm, others require a temporary storage.
+ *
+ * \sa transposed()
+ */
+template<typename T, typename Layout, typename Allocator>
+void Array2D<T, Layout, Allocator>::transpose()
+{
+    if(m_rows == m_cols){
+        if(m_rows > 1){
+            transposeSwap(data(), m_rows);
+        }
+        return;
+    }
+
+    *this = transposed();
+}
+
+/*!
+ * \brief Get transposed copy of the 2D array
+ * \details
+ * Copy is performed using a cache-oblivious algorithm, so
+ * both source and destination are accessed by blocks fitting in
+ * cache, whatever the array size is.
+ *
+ * \return
+ * Returns array of size <tt>getCols() x getRows()</tt>
+ * where element <tt>(col, row)</tt> is element <tt>(row, col)</tt>
+ * of this array.
+ *
+ * \sa transpose()
+ */
+template<typename T, typename Layout, typename Allocator>
+Array2D<T, Layout, Allocator> Array2D<T, Layout, Allocator>::transposed() const
+{
+    Array2D<T, Layout, Allocator> result(m_cols, m_rows);
+    if(result.getSize() == 0){
+        return result;
+    }
+
+    /* Storage is a row-major matrix whatever the layout is, so transpose it */
+    const size_t storeRows = Layout::IS_ROW_MAJOR ? m_rows : m_cols;
+    const size_t storeCols = Layout::IS_ROW_MAJOR ? m_cols : m_rows;
+    transposeCopy(data(), storeCols, result.data(), storeRows, storeRows, storeCols);
+
+    return result;
+}
+
+/*!
+ * \brief Get pointer to underlying storage
+ * \details
+ * Element at position <tt>(row, col)</tt> is stored
+ * at index <tt>Layout::index(row, col, getRows(), getCols())</tt>.
+ *
+ * \return
+ * Returns pointer to first element, \c nullptr
+ * may be returned if array is empty.
+ */
+template<typename T, typename Layout, typename Allocator>
+T* Array2D<T, Layout, Allocator>::data()
+{
+    return m_data.data();
+}
+
+/*!
+ * \overload
+ */
+template<typename T, typename Layout, typename Allocator>
+const T* Array2D<T, Layout, Allocator>::data() const
+{
+    return m_data.data();
+}
+
+/*!
+ * \brief Get view of a row, no copy is performed
+ *
+ * \param[in] row
+ * Row index to use. \n
+ * Must be valid (i.e <tt>0 <= row < getRows()</tt>).
+ *
+ * \return
+ * Returns line view of the row (contiguous when using
+ * row-major layout). \n
+ * View is invalidated if array is resized or destroyed.
+ *
+ * \sa colView(), subView()
+ */
+template<typename T, typename Layout, typename Allocator>
+Array2DLineView<T> Array2D<T, Layout, Allocator>::rowView(size_t row)
+{
+    return view().rowView(row);
+}
+
+/*!
+ * \overload
+ */
+template<typename T, typename Layout, typename Allocator>
+Array2DLineView<const T> Array2D<T, Layout, Allocator>::rowView(size_t row) const
+{
+    return view().rowView(row);
+}
+
+/*!
+ * \brief Get view of a column, no copy is performed
+ *
+ * \param[in] col
+ * Column index to use. \n
+ * Must be valid (i.e <tt>0 <= col < getCols()</tt>).
+ *
+ * \return
+ * Returns line view of the column (contiguous when using
+ * column-major layout). \n
+ * View is invalidated if array is resized or destroyed.
+ *
+ * \sa rowView(), subView()
+ */
+template<typename T, typename Layout, typename Allocator>
+Array2DLineView<T> Array2D<T, Layout, Allocator>::colView(size_t col)
+{
+    return view().colView(col);
+}
+
+/*!
+ * \overload
+ */
+template<typename T, typename Layout, typename Allocator>
+Array2DLineView<const T> Array2D<T, Layout, Allocator>::colView(size_t col) const
+{
+    return view().colView(col);
+}
+
+/*!
+ * \brief Get view of the whole array, no copy is performed
+ *
+ * \return
+ * Returns view of the array. \n
+ * View is invalidated if array is resized or destroyed.
+ *
+ * \sa subView()
+ */
+template<typename T, typename Layout, typename Allocator>
+Array2DView<T> Array2D<T, Layout, Allocator>::view()
+{
+    return Array2DView<T>(data(), m_rows, m_cols, Layout::rowStride(m_rows, m_cols), Layout::colStride(m_rows, m_cols));
+}
+
+/*!
+ * \overload
+ */
+template<typename T, typename Layout, typename Allocator>
+Array2DView<const T> Array2D<T, Layout, Allocator>::view() const
+{
+    return Array2DView<const T>(data(), m_rows, m_cols, Layout::rowStride(m_rows, m_cols), Layout::colStride(m_rows, m_cols));
+}
+
+/*!
+ * \brief Get view of a rectangular region, no copy is performed
+ *
+ * \param[in] row
+ * Index of first row of the region.
+ * \param[in] col
+ * Index of first column of the region.
+ * \param[in] nbRows
+ * Number of rows of the region. \n
+ * Must be valid (i.e <tt>row + nbRows <= getRows()</tt>).
+ * \param[in] nbCols
+ * Number of columns of the region. \n
+ * Must be valid (i.e <tt>col + nbCols <= getCols()</tt>).
+ *
+ * \return
+ * Returns view of the region. \n
+ * View is invalidated if array is resized or destroyed.
+ *
+ * \sa view(), rowView(), colView()
+ */
+template<typename T, typename Layout, typename Allocator>
+Array2DView<T> Array2D<T, Layout, Allocator>::subView(size_t row, size_t col, size_t nbRows, size_t nbCols)
+{
+    return view().subView(row, col, nbRows, nbCols);
+}
+
+/*!
+ * \overload
+ */
+template<typename T, typename Layout, typename Allocator>
+Array2DView<const T> Array2D<T, Layout, Allocator>::subView(size_t row, size_t col, size_t nbRows, size_t nbCols) const
+{
+    return view().subView(row, col, nbRows, nbCols);
+}
+
+/*!
+ * \brief Take elements of another 2D array
+ *
+ * \param[in, out] other
+ * Array to move, will be empty after the call.
+ *
+ * \return
+ * Returns reference to this array
+ */
+template<typename T, typename Layout, typename Allocator>
+Array2D<T, Layout, Allocator>& Array2D<T, Layout, Allocator>::operator=(Array2D &&other) noexcept
+{
+    if(this != &other){
+        m_rows = other.m_rows;
+        m_cols = other.m_cols;
+        m_data = std::move(other.m_data);
+
+        other.m_rows = 0;
+        other.m_cols = 0;
+    }
+
+    return *this;
+}
+
 /*!
  * \brief Get modifiable reference to an element
  *
@@ -206,10 +594,10 @@ void Array2D<T>::insert(size_t row, size_t col, const T &value)
  * \return
  * Returns modifiable reference to an element
  */
-template<typename T>
-T& Array2D<T>::operator()(size_t row, size_t col)
+template<typename T, typename Layout, typename Allocator>
+T& Array2D<T, Layout, Allocator>::operator()(size_t row, size_t col)
 {
-    return m_data[row * m_cols + col];
+    return m_data[Layout::index(row, col, m_rows, m_cols)];
 }
 
 /*!
@@ -225,10 +613,91 @@ T& Array2D<T>::operator()(size_t row, size_t col)
  * \return
  * Returns constant reference to an element
  */
-template<typename T>
-const T& Array2D<T>::operator()(size_t row, size_t col) const
+template<typename T, typename Layout, typename Allocator>
+const T& Array2D<T, Layout, Allocator>::operator()(size_t row, size_t col) const
 {
-    return m_data[row * m_cols + col];
+    return m_data[Layout::index(row, col, m_rows, m_cols)];
+}
+
+/*!
+ * \brief Copy a row-major matrix into its transposed
+ * \details
+ * Matrix is recursively split along its largest dimension until
+ * blocks fit in a tile, so both source and destination are
+ * accessed by cache-friendly blocks.
+ *
+ * \param[in] src
+ * Source matrix.
+ * \param[in] srcStride
+ * Distance between two consecutive rows of source.
+ * \param[out] dst
+ * Destination matrix.
+ * \param[in] dstStride
+ * Distance between two consecutive rows of destination.
+ * \param[in] nbRows
+ * Number of rows of source.
+ * \param[in] nbCols
+ * Number of columns of source.
+ */
+template<typename T, typename Layout, typename Allocator>
+void Array2D<T, Layout, Allocator>::transposeCopy(const T *src, size_t srcStride, T *dst, size_t dstStride, size_t nbRows, size_t nbCols)
+{
+    if(nbRows <= TRANSPOSE_TILE && nbCols <= TRANSPOSE_TILE){
+        for(size_t row = 0; row < nbRows; ++row){
+            for(size_t col = 0; col < nbCols; ++col){
+                dst[col * dstStride + row] = src[row * srcStride + col];
+            }
+        }
+        return;
+    }
+
+    if(nbRows >= nbCols){
+        const size_t half = nbRows / 2;
+        transposeCopy(src, srcStride, dst, dstStride, half, nbCols);
+        transposeCopy(src + half * srcStride, srcStride, dst + half, dstStride, nbRows - half, nbCols);
+    }else{
+        const size_t half = nbCols / 2;
+        transposeCopy(src, srcStride, dst, dstStride, nbRows, half);
+        transposeCopy(src + half, srcStride, dst + half * dstStride, dstStride, nbRows, nbCols - half);
+    }
+}
+
+/*!
+ * \brief Transpose a square matrix in-place
+ * \details
+ * Matrix is processed by tiles, each tile being swapped
+ * with its mirror tile.
+ *
+ * \param[in, out] data
+ * Matrix to transpose.
+ * \param[in] size
+ * Number of rows (and columns) of the matrix.
+ */
+template<typename T, typename Layout, typename Allocator>
+void Array2D<T, Layout, Allocator>::transposeSwap(T *data, size_t size)
+{
+    using std::swap;
+
+    for(size_t rowTile = 0; rowTile < size; rowTile += TRANSPOSE_TILE){
+        const size_t rowEnd = qMin(size, rowTile + TRANSPOSE_TILE);
+
+        /* Diagonal tile: swap upper and lower triangles */
+        for(size_t row = rowTile; row < rowEnd; ++row){
+            for(size_t col = row + 1; col < rowEnd; ++col){
+                swap(data[row * size + col], data[col * size + row]);
+            }
+        }
+
+        /* Other tiles: swap with mirror tile */
+        for(size_t colTile = rowTile + TRANSPOSE_TILE; colTile < size; colTile += TRANSPOSE_TILE){
+            const size_t colEnd = qMin(size, colTile + TRANSPOSE_TILE);
+            for(size_t row = rowTile; row < rowEnd; ++row){
+                for(size_t col = colTile; col < colEnd; ++col){
+                    swap(data[row * size + col], data[col * size + row]);
+                }
+            }
+        }
+    }
 }
 
 } // namespace tbq
@@ -0,0 +1,185 @@
+#include "array2dalgorithms.h"
+
+#include <QSemaphore>
+
+#include <atomic>
+
+/*****************************/
+/* Functions documentations  */
+/*****************************/
+
+/*!
+ * \file array2dalgorithms.h
+ * \brief Parallel algorithms over 2-dimensional arrays
+ * \details
+ * Include with:
+ * \code{.cpp}
+ * #include "toolboxqt/containers/array2dalgorithms.h"
+ * \endcode
+ *
+ * Work is split into chunks of contiguous rows which are dispatched
+ * to a thread pool, calling thread also process chunks. Arrays
+ * smaller than tbq::PARALLEL_GRAIN_DEFAULT elements are processed
+ * serially on calling thread.
+ * \code{.cpp}
+ * tbq::Array2D<float> grid(4096, 4096);
+ * tbq::parallelForEach(grid, [](float &value){ value = std::sqrt(value); });
+ *
+ * const double sum = tbq::parallelReduce(grid, 0.0, [](double acc, float value){ return acc + value; }, std::plus<double>());
+ * \endcode
+ */
+
+/*****************************/
+/* Macro definitions         */
+/*****************************/
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/* Constants definitions     */
+/*****************************/
+
+/*****************************/
+/* Functions implementation  */
+/*****************************/
+
+/*!
+ * \brief Compute number of rows of a chunk
+ * \details
+ * Number of rows only depends on array size, this allow
+ * to have deterministic chunks whatever the number of threads is.
+ *
+ * \param[in] nbRows
+ * Number of rows of the array.
+ * \param[in] nbCols
+ * Number of columns of the array.
+ * \param[in] grain
+ * Minimum number of elements of a chunk.
+ *
+ * \return
+ * Returns number of rows of each chunk (last chunk
+ * may be smaller). \n
+ * Returns \c 0 if array is empty.
+ */
+size_t parallelChunkRows(size_t nbRows, size_t nbCols, size_t grain)
+{
+    if(nbRows == 0 || nbCols == 0){
+        return 0;
+    }
+
+    const size_t chunkRows = (qMax<size_t>(grain, 1) + nbCols - 1) / nbCols;
+    return qMin(chunkRows, nbRows);
+}
+
+/*!
+ * \brief Run a function for each chunk identifier, using
+ * multiple threads
+ * \details
+ * Calling thread also process chunks and this function returns once
+ * all chunks are processed. Only idle threads of the pool are used,
+ * so this function can safely be called from a task of the same pool.
+ *
+ * \param[in] nbChunks
+ * Number of chunks to process.
+ * \param[in] fct
+ * Function to call for each chunk, it will be called concurrently
+ * from multiple threads.
+ * \param[in] pool
+ * Thread pool to use, if \c nullptr, \c QThreadPool::globalInstance()
+ * will be used.
+ *
+ * \sa parallelForRows()
+ */
+void parallelForChunks(size_t nbChunks, const std::function<void(size_t idChunk)> &fct, QThreadPool *pool)
+{
+    if(nbChunks == 0){
+        return;
+    }
+
+    /* Use serial path when parallelism is useless */
+    if(!pool){
+        pool = QThreadPool::globalInstance();
+    }
+
+    const size_t nbWorkers = qMin(nbChunks, static_cast<size_t>(qMax(1, pool->maxThreadCount())));
+    if(nbWorkers <= 1){
+        for(size_t id = 0; id < nbChunks; ++id){
+            fct(id);
+        }
+        return;
+    }
+
+    /* Dispatch chunks to available threads */
+    std::atomic<size_t> nextChunk(0);
+    auto worker = [&](){
+        for(size_t id = nextChunk.fetch_add(1); id < nbChunks; id = nextChunk.fetch_add(1)){
+            fct(id);
+        }
+    };
+
+    QSemaphore semDone;
+    int nbStarted = 0;
+    for(size_t i = 1; i < nbWorkers; ++i){
+        const bool started = pool->tryStart([&](){
+            worker();
+            semDone.release();
+        });
+
+        if(!started){
+            break;
+        }
+        ++nbStarted;
+    }
+
+    /* Participate and wait for other workers */
+    worker();
+    semDone.acquire(nbStarted);
+}
+
+/*!
+ * \brief Run a function over ranges of rows, using
+ * multiple threads
+ *
+ * \param[in] nbRows
+ * Number of rows of the array.
+ * \param[in] nbCols
+ * Number of columns of the array.
+ * \param[in] fct
+ * Function to call for each range of rows <tt>[rowBegin, rowEnd)</tt>,
+ * it will be called concurrently from multiple threads.
+ * \param[in] pool
+ * Thread pool to use, if \c nullptr, \c QThreadPool::globalInstance()
+ * will be used.
+ * \param[in] grain
+ * Minimum number of elements of a range.
+ *
+ * \sa parallelForChunks(), parallelChunkRows()
+ */
+void parallelForRows(size_t nbRows, size_t nbCols, const std::function<void(size_t rowBegin, size_t rowEnd)> &fct, QThreadPool *pool, size_t grain)
+{
+    const size_t chunkRows = parallelChunkRows(nbRows, nbCols, grain);
+    if(chunkRows == 0){
+        return;
+    }
+
+    const size_t nbChunks = (nbRows + chunkRows - 1) / chunkRows;
+    parallelForChunks(nbChunks, [&](size_t idChunk){
+        const size_t rowBegin = idChunk * chunkRows;
+        fct(rowBegin, qMin(nbRows, rowBegin + chunkRows));
+    }, pool);
+}
+
+/*****************************/
+/* End namespace             */
+/*****************************/
+
+} // namespace tbq
+
+/*****************************/
+/* End file                  */
+/*****************************/
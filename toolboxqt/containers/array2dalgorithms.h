@@ -0,0 +1,222 @@
+#ifndef TBQ_CONTAINER_ARRAY2DALGORITHMS_H
+#define TBQ_CONTAINER_ARRAY2DALGORITHMS_H
+
+#include "toolboxqt/toolboxqt_global.h"
+#include "toolboxqt/containers/array2d.h"
+
+#include <QThreadPool>
+#include <QVector>
+
+#include <functional>
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/*   Constants definitions   */
+/*****************************/
+
+/*!
+ * \brief Default number of elements processed by a
+ * single task of parallel algorithms
+ * \details
+ * Arrays smaller than this value are processed serially.
+ */
+constexpr size_t PARALLEL_GRAIN_DEFAULT = 32768;
+
+/*****************************/
+/*   Functions definitions   */
+/*****************************/
+
+TOOLBOXQT_EXPORT size_t parallelChunkRows(size_t nbRows, size_t nbCols, size_t grain = PARALLEL_GRAIN_DEFAULT);
+TOOLBOXQT_EXPORT void parallelForChunks(size_t nbChunks, const std::function<void(size_t idChunk)> &fct, QThreadPool *pool = nullptr);
+TOOLBOXQT_EXPORT void parallelForRows(size_t nbRows, size_t nbCols, const std::function<void(size_t rowBegin, size_t rowEnd)> &fct, QThreadPool *pool = nullptr, size_t grain = PARALLEL_GRAIN_DEFAULT);
+
+/*****************************/
+/*   Template definitions    */
+/*****************************/
+
+/*!
+ * \brief Apply a function to each element of a 2D array,
+ * using multiple threads
+ *
+ * \param[in, out] array
+ * Array to use.
+ * \param[in] fct
+ * Function to apply, signature must be equivalent to <tt>void fct(T &value)</tt>. \n
+ * It will be called concurrently from multiple threads.
+ * \param[in] pool
+ * Thread pool to use, if \c nullptr, \c QThreadPool::globalInstance()
+ * will be used.
+ *
+ * \sa parallelTransform(), parallelReduce()
+ */
+template<typename T, typename Layout, typename Allocator, typename Fct>
+void parallelForEach(Array2D<T, Layout, Allocator> &array, Fct fct, QThreadPool *pool = nullptr)
+{
+    const size_t nbCols = array.getCols();
+    T *data = array.data();
+
+    parallelForRows(array.getRows(), nbCols, [&](size_t rowBegin, size_t rowEnd){
+        T *it = data + rowBegin * nbCols;
+        T *end = data + rowEnd * nbCols;
+        for(; it != end; ++it){
+            fct(*it);
+        }
+    }, pool);
+}
+
+/*!
+ * \overload
+ * \details
+ * Function signature must be equivalent to <tt>void fct(const T &value)</tt>.
+ */
+template<typename T, typename Layout, typename Allocator, typename Fct>
+void parallelForEach(const Array2D<T, Layout, Allocator> &array, Fct fct, QThreadPool *pool = nullptr)
+{
+    const size_t nbCols = array.getCols();
+    const T *data = array.data();
+
+    parallelForRows(array.getRows(), nbCols, [&](size_t rowBegin, size_t rowEnd){
+        const T *it = data + rowBegin * nbCols;
+        const T *end = data + rowEnd * nbCols;
+        for(; it != end; ++it){
+            fct(*it);
+        }
+    }, pool);
+}
+
+/*!
+ * \brief Transform each element of a 2D array into
+ * another 2D array, using multiple threads
+ *
+ * \param[in] input
+ * Array to transform.
+ * \param[out] output
+ * Transformed array, will be resized to the size of \c input. \n
+ * Can be the same object than \c input.
+ * \param[in] fct
+ * Function to apply, signature must be equivalent to <tt>U fct(const T &value)</tt>. \n
+ * It will be called concurrently from multiple threads.
+ * \param[in] pool
+ * Thread pool to use, if \c nullptr, \c QThreadPool::globalInstance()
+ * will be used.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if \c output can't be resized, it is
+ * left unchanged.
+ *
+ * \sa parallelForEach(), parallelReduce()
+ */
+template<typename T, typename U, typename Layout, typename Allocator, typename AllocatorOut, typename Fct>
+bool parallelTransform(const Array2D<T, Layout, Allocator> &input, Array2D<U, Layout, AllocatorOut> &output, Fct fct, QThreadPool *pool = nullptr)
+{
+    if(!output.resize(input.getRows(), input.getCols())){
+        return false;
+    }
+
+    /* Output is already sized, so input (which may be the same object) stays valid */
+    const size_t nbCols = input.getCols();
+    U *dataOut = output.data();
+    const T *dataIn = input.data();
+
+    parallelForRows(input.getRows(), nbCols, [&](size_t rowBegin, size_t rowEnd){
+        const size_t idBegin = rowBegin * nbCols;
+        const size_t idEnd = rowEnd * nbCols;
+        for(size_t i = idBegin; i < idEnd; ++i){
+            dataOut[i] = fct(dataIn[i]);
+        }
+    }, pool);
+
+    return true;
+}
+
+/*!
+ * \brief Reduce all elements of a 2D array to a single
+ * value, using multiple threads
+ * \details
+ * Array is split in chunks of rows which only depends on array
+ * size, each chunk is reduced starting from \c identity, then partial
+ * results are combined in chunk order. So result is deterministic
+ * (even for floating-point values) whatever the number of threads is.
+ *
+ * \param[in] array
+ * Array to reduce.
+ * \param[in] identity
+ * Initial value of each chunk, must be the identity value of
+ * the reduction (for example \c 0 for a sum).
+ * \param[in] accumulate
+ * Function used to accumulate an element, signature must be equivalent
+ * to <tt>Acc accumulate(const Acc &acc, const T &value)</tt>.
+ * \param[in] combine
+ * Function used to combine partial results, signature must be equivalent
+ * to <tt>Acc combine(const Acc &left, const Acc &right)</tt>.
+ * \param[in] pool
+ * Thread pool to use, if \c nullptr, \c QThreadPool::globalInstance()
+ * will be used.
+ *
+ * \return
+ * Returns reduced value.
+ *
+ * \sa parallelForEach(), parallelTransform()
+ */
+template<typename T, typename Layout, typename Allocator, typename Acc, typename FctAcc, typename FctCombine>
+Acc parallelReduce(const Array2D<T, Layout, Allocator> &array, const Acc &identity, FctAcc accumulate, FctCombine combine, QThreadPool *pool = nullptr)
+{
+    const size_t nbRows = array.getRows();
+    const size_t nbCols = array.getCols();
+    const T *data = array.data();
+
+    const size_t chunkRows = parallelChunkRows(nbRows, nbCols);
+    const size_t nbChunks = chunkRows > 0 ? (nbRows + chunkRows - 1) / chunkRows : 0;
+
+    /* Reduce each chunk */
+    QVector<Acc> partials(static_cast<int>(nbChunks), identity);
+    parallelForChunks(nbChunks, [&](size_t idChunk){
+        const size_t idBegin = idChunk * chunkRows * nbCols;
+        const size_t idEnd = qMin(nbRows, (idChunk + 1) * chunkRows) * nbCols;
+
+        Acc acc = identity;
+        for(size_t i = idBegin; i < idEnd; ++i){
+            acc = accumulate(acc, data[i]);
+        }
+        partials[static_cast<int>(idChunk)] = acc;
+    }, pool);
+
+    /* Combine partial results in order */
+    Acc result = identity;
+    for(const Acc &partial : partials){
+        result = combine(result, partial);
+    }
+
+    return result;
+}
+
+/*!
+ * \overload
+ * \details
+ * Same function is used to accumulate elements and combine
+ * partial results (like \c std::plus<>).
+ */
+template<typename T, typename Layout, typename Allocator, typename Acc, typename Fct>
+Acc parallelReduce(const Array2D<T, Layout, Allocator> &array, const Acc &identity, Fct fct, QThreadPool *pool = nullptr)
+{
+    return parallelReduce(array, identity, fct, fct, pool);
+}
+
+/*****************************/
+/* End namespace             */
+/*****************************/
+
+} // namespace tbq
+
+/*****************************/
+/* End file                  */
+/*****************************/
+
+#endif // TBQ_CONTAINER_ARRAY2DALGORITHMS_H
@@ -0,0 +1,216 @@
+#include "array2dallocator.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
+
+/*****************************/
+/* Class documentations      */
+/*****************************/
+
+/*!
+ * \class tbq::Array2DAllocatorPool
+ * \brief Allocator policy recycling released buffers
+ * \details
+ * Include with:
+ * \code{.cpp}
+ * #include "toolboxqt/containers/array2dallocator.h"
+ * \endcode
+ *
+ * Released buffers are kept in a process-wide pool, indexed by
+ * their size, and are reused by next allocation of the same size. This
+ * is suited for pipelines which create and destroy many temporary
+ * arrays of identical size:
+ * \code{.cpp}
+ * using Grid = tbq::Array2D<float, tbq::Array2DLayoutRowMajor, tbq::Array2DAllocatorPool>;
+ *
+ * for(int i = 0; i < nbFrames; ++i){
+ *     Grid tmp(1024, 1024); // Only first iteration allocates
+ *     // ...
+ * }
+ * \endcode
+ *
+ * Pool is thread-safe. Total size of cached buffers is limited (see
+ * setMaxCachedSize()), buffers released above this limit are freed.
+ */
+
+/*****************************/
+/* Macro definitions         */
+/*****************************/
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/* Constants definitions     */
+/*****************************/
+
+static const size_t POOL_MAX_CACHED_DEFAULT = 256 * 1024 * 1024;
+
+/*****************************/
+/* Private types             */
+/*****************************/
+
+struct PoolData
+{
+    QMutex mutex;
+    QHash<quint64, QVector<void*>> buffers;
+    size_t cachedSize = 0;
+    size_t maxCachedSize = POOL_MAX_CACHED_DEFAULT;
+};
+
+static PoolData& poolData()
+{
+    static PoolData data;
+    return data;
+}
+
+/*****************************/
+/* Functions implementation  */
+/*         Class             */
+/*****************************/
+
+/*!
+ * \brief Allocate a buffer
+ * \details
+ * A cached buffer of same size is returned if
+ * available, otherwise heap is used.
+ *
+ * \param[in] size
+ * Size in bytes of buffer.
+ *
+ * \return
+ * Returns allocated buffer. \n
+ * Returns \c nullptr if allocation failed.
+ */
+void* Array2DAllocatorPool::allocate(size_t size)
+{
+    PoolData &pool = poolData();
+    {
+        QMutexLocker locker(&pool.mutex);
+
+        auto it = pool.buffers.find(size);
+        if(it != pool.buffers.end() && !it->isEmpty()){
+            void *ptr = it->takeLast();
+            pool.cachedSize -= size;
+            return ptr;
+        }
+    }
+
+    return ::operator new(size, std::nothrow);
+}
+
+/*!
+ * \brief Release a buffer
+ * \details
+ * Buffer is kept in pool for a later reuse, unless
+ * maximum cached size would be exceeded.
+ *
+ * \param[in] ptr
+ * Buffer to release. \n
+ * Must have been allocated by allocate().
+ * \param[in] size
+ * Size used to allocate the buffer.
+ */
+void Array2DAllocatorPool::deallocate(void *ptr, size_t size)
+{
+    if(!ptr){
+        return;
+    }
+
+    PoolData &pool = poolData();
+    {
+        QMutexLocker locker(&pool.mutex);
+
+        if(pool.cachedSize <= pool.maxCachedSize && size <= pool.maxCachedSize - pool.cachedSize){
+            pool.buffers[size].append(ptr);
+            pool.cachedSize += size;
+            return;
+        }
+    }
+
+    ::operator delete(ptr);
+}
+
+/*!
+ * \brief Get size of cached buffers
+ *
+ * \return
+ * Returns size in bytes of buffers kept for reuse
+ */
+size_t Array2DAllocatorPool::getCachedSize()
+{
+    PoolData &pool = poolData();
+    QMutexLocker locker(&pool.mutex);
+
+    return pool.cachedSize;
+}
+
+/*!
+ * \brief Get maximum size of cached buffers
+ *
+ * \return
+ * Returns size in bytes, default is 256 MiB.
+ *
+ * \sa setMaxCachedSize()
+ */
+size_t Array2DAllocatorPool::getMaxCachedSize()
+{
+    PoolData &pool = poolData();
+    QMutexLocker locker(&pool.mutex);
+
+    return pool.maxCachedSize;
+}
+
+/*!
+ * \brief Set maximum size of cached buffers
+ * \details
+ * Already cached buffers are kept, even if
+ * new limit is exceeded.
+ *
+ * \param[in] size
+ * Size in bytes. \n
+ * Use \c 0 to disable caching.
+ *
+ * \sa getMaxCachedSize(), releaseCached()
+ */
+void Array2DAllocatorPool::setMaxCachedSize(size_t size)
+{
+    PoolData &pool = poolData();
+    QMutexLocker locker(&pool.mutex);
+
+    pool.maxCachedSize = size;
+}
+
+/*!
+ * \brief Free all cached buffers
+ */
+void Array2DAllocatorPool::releaseCached()
+{
+    PoolData &pool = poolData();
+    QMutexLocker locker(&pool.mutex);
+
+    for(auto it = pool.buffers.cbegin(); it != pool.buffers.cend(); ++it){
+        for(void *ptr : it.value()){
+            ::operator delete(ptr);
+        }
+    }
+
+    pool.buffers.clear();
+    pool.cachedSize = 0;
+}
+
+/*****************************/
+/* End namespace             */
+/*****************************/
+
+} // namespace tbq
+
+/*****************************/
+/* End file                  */
+/*****************************/
@@ -0,0 +1,78 @@
+#ifndef TBQ_CONTAINER_ARRAY2DALLOCATOR_H
+#define TBQ_CONTAINER_ARRAY2DALLOCATOR_H
+
+#include "toolboxqt/toolboxqt_global.h"
+
+#include <new>
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/*   Policies definitions    */
+/*****************************/
+
+/*!
+ * \brief Allocator policy using global heap
+ * \details
+ * This is the default allocator policy of tbq::Array2D.
+ *
+ * An allocator policy must provide:
+ * - <tt>static void* allocate(size_t size)</tt>: returns \c nullptr on failure,
+ * memory must be suitably aligned for any fundamental type.
+ * - <tt>static void deallocate(void *ptr, size_t size)</tt>: \c size is the
+ * one used for allocation.
+ */
+struct Array2DAllocatorHeap
+{
+    static void* allocate(size_t size) { return ::operator new(size, std::nothrow); }
+    static void deallocate(void *ptr, size_t size) { Q_UNUSED(size) ::operator delete(ptr); }
+};
+
+/*!
+ * \brief Allocator policy using aligned memory
+ * \details
+ * Useful to align rows on cache lines (default) or SIMD registers. \n
+ * Using an alignment of 2 MiB allows large arrays to be backed by
+ * transparent huge pages on Linux.
+ *
+ * \tparam Alignment
+ * Alignment in bytes, must be a power of 2.
+ */
+template <size_t Alignment = 64>
+struct Array2DAllocatorAligned
+{
+    static_assert(Alignment != 0 && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of 2");
+
+    static void* allocate(size_t size) { return qMallocAligned(size, Alignment); }
+    static void deallocate(void *ptr, size_t size) { Q_UNUSED(size) qFreeAligned(ptr); }
+};
+
+/*****************************/
+/*     Class definitions     */
+/*    Array2DAllocatorPool   */
+/*****************************/
+
+class TOOLBOXQT_EXPORT Array2DAllocatorPool
+{
+
+public:
+    static void* allocate(size_t size);
+    static void deallocate(void *ptr, size_t size);
+
+public:
+    static size_t getCachedSize();
+
+    static size_t getMaxCachedSize();
+    static void setMaxCachedSize(size_t size);
+
+    static void releaseCached();
+};
+
+} // namespace tbq
+
+#endif // TBQ_CONTAINER_ARRAY2DALLOCATOR_H
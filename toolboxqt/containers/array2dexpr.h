@@ -0,0 +1,534 @@
+#ifndef TBQ_CONTAINER_ARRAY2DEXPR_H
+#define TBQ_CONTAINER_ARRAY2DEXPR_H
+
+#include "toolboxqt/toolboxqt_global.h"
+#include "toolboxqt/containers/array2d.h"
+
+#include <type_traits>
+#include <utility>
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/*   Operations definitions  */
+/*****************************/
+
+/*
+ * Element-wise operations used by expressions: "ResultType" gives
+ * element type of result, "apply()" computes one element
+ */
+
+struct Array2DExprOpNegate
+{
+    template<typename A> using ResultType = decltype(-std::declval<A>());
+    template<typename A> static auto apply(const A &a) -> decltype(-a) { return -a; }
+};
+
+#define TBQ_ARRAY2DEXPR_OP_ARITHMETIC(Name, symbol) \
+    struct Name \
+    { \
+        template<typename A, typename B> using ResultType = decltype(std::declval<A>() symbol std::declval<B>()); \
+        template<typename A, typename B> static auto apply(const A &a, const B &b) -> decltype(a symbol b) { return a symbol b; } \
+    };
+
+#define TBQ_ARRAY2DEXPR_OP_COMPARISON(Name, symbol) \
+    struct Name \
+    { \
+        template<typename A, typename B> using ResultType = bool; \
+        template<typename A, typename B> static bool apply(const A &a, const B &b) { return a symbol b; } \
+    };
+
+TBQ_ARRAY2DEXPR_OP_ARITHMETIC(Array2DExprOpAdd, +)
+TBQ_ARRAY2DEXPR_OP_ARITHMETIC(Array2DExprOpSub, -)
+TBQ_ARRAY2DEXPR_OP_ARITHMETIC(Array2DExprOpMul, *)
+TBQ_ARRAY2DEXPR_OP_ARITHMETIC(Array2DExprOpDiv, /)
+
+TBQ_ARRAY2DEXPR_OP_COMPARISON(Array2DExprOpLess, <)
+TBQ_ARRAY2DEXPR_OP_COMPARISON(Array2DExprOpLessEqual, <=)
+TBQ_ARRAY2DEXPR_OP_COMPARISON(Array2DExprOpGreater, >)
+TBQ_ARRAY2DEXPR_OP_COMPARISON(Array2DExprOpGreaterEqual, >=)
+TBQ_ARRAY2DEXPR_OP_COMPARISON(Array2DExprOpEqual, ==)
+TBQ_ARRAY2DEXPR_OP_COMPARISON(Array2DExprOpNotEqual, !=)
+
+#undef TBQ_ARRAY2DEXPR_OP_ARITHMETIC
+#undef TBQ_ARRAY2DEXPR_OP_COMPARISON
+
+/*****************************/
+/*   Layouts combination     */
+/*****************************/
+
+/*!
+ * \brief Layout of an expression combining two operands
+ * \details
+ * Scalars have no layout (\c void), arrays of an expression
+ * must all have same layout.
+ */
+template <typename LeftLayout, typename RightLayout>
+struct Array2DExprLayout
+{
+    static_assert(std::is_void<LeftLayout>::value || std::is_void<RightLayout>::value || std::is_same<LeftLayout, RightLayout>::value,
+                  "Arrays of an expression must have same layout");
+
+    using Type = typename std::conditional<std::is_void<LeftLayout>::value, RightLayout, LeftLayout>::type;
+};
+
+/*****************************/
+/* Define template interface */
+/*****************************/
+
+/*!
+ * \class Array2DExpr
+ * \brief Base class of lazy element-wise expressions
+ * over 2D arrays
+ * \details
+ * Element-wise operators applied to tbq::Array2D don't compute
+ * anything: they build a lightweight expression (holding pointers
+ * to arrays data and scalars by value). Expression is evaluated
+ * when assigned to an array, in a single loop over elements, so no
+ * temporary array is allocated whatever the number of operators:
+ * \code{.cpp}
+ * #include "toolboxqt/containers/array2dexpr.h"
+ *
+ * tbq::Array2D<float> a(1024, 1024), b(1024, 1024), d(1024, 1024);
+ * tbq::Array2D<float> c;
+ *
+ * c = a * 0.5f + b - d;                    // One loop, no temporaries
+ * c = tbq::where(a > 0.0f, a, -a);         // Element-wise selection
+ *
+ * tbq::Array2D<float> e = a * a + b * b;   // Construction from an expression
+ * \endcode
+ *
+ * Available operations are:
+ * - Arithmetic operators <tt>+ - * /</tt> and unary \c -, between arrays,
+ *   expressions and arithmetic scalars
+ * - Comparison operators <tt>< <= > >=</tt>, producing \c bool elements.
+ *   Element-wise equality is provided by tbq::equalTo() and tbq::notEqualTo(),
+ *   since <tt>==</tt> and <tt>!=</tt> compare whole arrays
+ * - Selection with tbq::where()
+ *
+ * Element type of an arithmetic expression follows C++ rules (so
+ * <tt>quint8 + quint8</tt> gives \c int elements), comparisons produce
+ * \c bool. Result is converted to element type of destination array.
+ *
+ * All arrays of an expression must have same size and same layout
+ * (checked at compile-time). Since evaluation is element-wise, destination
+ * array can also be an operand (<tt>a = a * 2 + b</tt>).
+ *
+ * \warning
+ * Expressions refer to arrays, which must outlive them and must
+ * not be resized before evaluation.
+ *
+ * \sa tbq::evaluate()
+ */
+template <typename Derived>
+class Array2DExpr
+{
+
+public:
+    const Derived& derived() const { return static_cast<const Derived&>(*this); }
+
+    size_t getRows() const { return derived().getRows(); }
+    size_t getCols() const { return derived().getCols(); }
+    bool isValid() const { return derived().isValid(); }
+};
+
+/*!
+ * \brief Leaf expression referring to elements of a 2D array
+ */
+template <typename T, typename Layout>
+class Array2DExprArray : public Array2DExpr<Array2DExprArray<T, Layout>>
+{
+
+public:
+    using ValueType = T;
+    using LayoutType = Layout;
+
+    static constexpr bool IS_SCALAR = false;
+
+public:
+    explicit Array2DExprArray(const T *data, size_t nbRows, size_t nbCols) : m_data(data), m_rows(nbRows), m_cols(nbCols) {}
+
+    size_t getRows() const { return m_rows; }
+    size_t getCols() const { return m_cols; }
+    bool isValid() const { return true; }
+
+    T evalAt(size_t index) const { return m_data[index]; }
+
+private:
+    const T *m_data;
+    size_t m_rows;
+    size_t m_cols;
+};
+
+/*!
+ * \brief Leaf expression of a scalar, broadcasted
+ * to all elements
+ */
+template <typename T>
+class Array2DExprScalar : public Array2DExpr<Array2DExprScalar<T>>
+{
+
+public:
+    using ValueType = T;
+    using LayoutType = void;
+
+    static constexpr bool IS_SCALAR = true;
+
+public:
+    explicit Array2DExprScalar(const T &value) : m_value(value) {}
+
+    size_t getRows() const { return 0; }
+    size_t getCols() const { return 0; }
+    bool isValid() const { return true; }
+
+    T evalAt(size_t index) const { Q_UNUSED(index) return m_value; }
+
+private:
+    T m_value;
+};
+
+/*!
+ * \brief Expression applying an unary operation
+ * to each element of an expression
+ */
+template <typename Op, typename Operand>
+class Array2DExprUnary : public Array2DExpr<Array2DExprUnary<Op, Operand>>
+{
+
+public:
+    using ValueType = typename Op::template ResultType<typename Operand::ValueType>;
+    using LayoutType = typename Operand::LayoutType;
+
+    static constexpr bool IS_SCALAR = Operand::IS_SCALAR;
+
+public:
+    explicit Array2DExprUnary(const Operand &operand) : m_operand(operand) {}
+
+    size_t getRows() const { return m_operand.getRows(); }
+    size_t getCols() const { return m_operand.getCols(); }
+    bool isValid() const { return m_operand.isValid(); }
+
+    ValueType evalAt(size_t index) const { return static_cast<ValueType>(Op::apply(m_operand.evalAt(index))); }
+
+private:
+    Operand m_operand;
+};
+
+/*!
+ * \brief Expression applying a binary operation
+ * to each pair of elements of two expressions
+ */
+template <typename Op, typename Left, typename Right>
+class Array2DExprBinary : public Array2DExpr<Array2DExprBinary<Op, Left, Right>>
+{
+
+public:
+    using ValueType = typename Op::template ResultType<typename Left::ValueType, typename Right::ValueType>;
+    using LayoutType = typename Array2DExprLayout<typename Left::LayoutType, typename Right::LayoutType>::Type;
+
+    static constexpr bool IS_SCALAR = Left::IS_SCALAR && Right::IS_SCALAR;
+
+public:
+    explicit Array2DExprBinary(const Left &left, const Right &right) : m_left(left), m_right(right) {}
+
+    size_t getRows() const { return Left::IS_SCALAR ? m_right.getRows() : m_left.getRows(); }
+    size_t getCols() const { return Left::IS_SCALAR ? m_right.getCols() : m_left.getCols(); }
+
+    bool isValid() const
+    {
+        return m_left.isValid() && m_right.isValid()
+            && (Left::IS_SCALAR || Right::IS_SCALAR || (m_left.getRows() == m_right.getRows() && m_left.getCols() == m_right.getCols()));
+    }
+
+    ValueType evalAt(size_t index) const { return static_cast<ValueType>(Op::apply(m_left.evalAt(index), m_right.evalAt(index))); }
+
+private:
+    Left m_left;
+    Right m_right;
+};
+
+/*!
+ * \brief Expression selecting, for each element, element of
+ * first or second expression depending on a condition
+ *
+ * \sa tbq::where()
+ */
+template <typename Cond, typename Left, typename Right>
+class Array2DExprWhere : public Array2DExpr<Array2DExprWhere<Cond, Left, Right>>
+{
+
+public:
+    using ValueType = typename std::common_type<typename Left::ValueType, typename Right::ValueType>::type;
+    using LayoutType = typename Array2DExprLayout<typename Cond::LayoutType,
+                                                  typename Array2DExprLayout<typename Left::LayoutType, typename Right::LayoutType>::Type>::Type;
+
+    static constexpr bool IS_SCALAR = Cond::IS_SCALAR && Left::IS_SCALAR && Right::IS_SCALAR;
+
+public:
+    explicit Array2DExprWhere(const Cond &cond, const Left &left, const Right &right) : m_cond(cond), m_left(left), m_right(right) {}
+
+    size_t getRows() const { return !Cond::IS_SCALAR ? m_cond.getRows() : (!Left::IS_SCALAR ? m_left.getRows() : m_right.getRows()); }
+    size_t getCols() const { return !Cond::IS_SCALAR ? m_cond.getCols() : (!Left::IS_SCALAR ? m_left.getCols() : m_right.getCols()); }
+
+    bool isValid() const
+    {
+        const size_t nbRows = getRows();
+        const size_t nbCols = getCols();
+
+        return m_cond.isValid() && m_left.isValid() && m_right.isValid()
+            && (Cond::IS_SCALAR || (m_cond.getRows() == nbRows && m_cond.getCols() == nbCols))
+            && (Left::IS_SCALAR || (m_left.getRows() == nbRows && m_left.getCols() == nbCols))
+            && (Right::IS_SCALAR || (m_right.getRows() == nbRows && m_right.getCols() == nbCols));
+    }
+
+    ValueType evalAt(size_t index) const
+    {
+        return m_cond.evalAt(index) ? static_cast<ValueType>(m_left.evalAt(index)) : static_cast<ValueType>(m_right.evalAt(index));
+    }
+
+private:
+    Cond m_cond;
+    Left m_left;
+    Right m_right;
+};
+
+/*****************************/
+/*   Operands definitions    */
+/*****************************/
+
+/*!
+ * \brief Convert operands of element-wise operators
+ * to expressions
+ * \details
+ * Arrays are converted to tbq::Array2DExprArray, expressions are
+ * kept as is and arithmetic values are converted to
+ * tbq::Array2DExprScalar. Other types are not operands.
+ */
+template <typename X, typename Enable = void>
+struct Array2DExprOperand
+{
+    static constexpr bool IS_EXPR = false;
+    static constexpr bool IS_VALID = false;
+};
+
+template <typename T, typename Layout, typename Allocator>
+struct Array2DExprOperand<Array2D<T, Layout, Allocator>>
+{
+    static constexpr bool IS_EXPR = true;
+    static constexpr bool IS_VALID = true;
+
+    using Type = Array2DExprArray<T, Layout>;
+    static Type make(const Array2D<T, Layout, Allocator> &array) { return Type(array.data(), array.getRows(), array.getCols()); }
+};
+
+template <typename X>
+struct Array2DExprOperand<X, typename std::enable_if<std::is_base_of<Array2DExpr<X>, X>::value>::type>
+{
+    static constexpr bool IS_EXPR = true;
+    static constexpr bool IS_VALID = true;
+
+    using Type = X;
+    static const Type& make(const X &expr) { return expr; }
+};
+
+template <typename X>
+struct Array2DExprOperand<X, typename std::enable_if<std::is_arithmetic<X>::value>::type>
+{
+    static constexpr bool IS_EXPR = false;
+    static constexpr bool IS_VALID = true;
+
+    using Type = Array2DExprScalar<X>;
+    static Type make(const X &value) { return Type(value); }
+};
+
+/*!
+ * \brief Type of a binary expression, only defined when both
+ * operands are valid and at least one is an array or an expression
+ */
+template <typename Op, typename L, typename R>
+using Array2DExprBinaryType = typename std::enable_if<
+    Array2DExprOperand<L>::IS_VALID && Array2DExprOperand<R>::IS_VALID && (Array2DExprOperand<L>::IS_EXPR || Array2DExprOperand<R>::IS_EXPR),
+    Array2DExprBinary<Op, typename Array2DExprOperand<L>::Type, typename Array2DExprOperand<R>::Type>>::type;
+
+/*****************************/
+/*   Functions definitions   */
+/*****************************/
+
+#define TBQ_ARRAY2DEXPR_BINARY_FCT(Op, name) \
+    template<typename L, typename R> \
+    Array2DExprBinaryType<Op, L, R> name(const L &left, const R &right) \
+    { \
+        return Array2DExprBinaryType<Op, L, R>(Array2DExprOperand<L>::make(left), Array2DExprOperand<R>::make(right)); \
+    }
+
+TBQ_ARRAY2DEXPR_BINARY_FCT(Array2DExprOpAdd, operator+)
+TBQ_ARRAY2DEXPR_BINARY_FCT(Array2DExprOpSub, operator-)
+TBQ_ARRAY2DEXPR_BINARY_FCT(Array2DExprOpMul, operator*)
+TBQ_ARRAY2DEXPR_BINARY_FCT(Array2DExprOpDiv, operator/)
+
+TBQ_ARRAY2DEXPR_BINARY_FCT(Array2DExprOpLess, operator<)
+TBQ_ARRAY2DEXPR_BINARY_FCT(Array2DExprOpLessEqual, operator<=)
+TBQ_ARRAY2DEXPR_BINARY_FCT(Array2DExprOpGreater, operator>)
+TBQ_ARRAY2DEXPR_BINARY_FCT(Array2DExprOpGreaterEqual, operator>=)
+
+TBQ_ARRAY2DEXPR_BINARY_FCT(Array2DExprOpEqual, equalTo)
+TBQ_ARRAY2DEXPR_BINARY_FCT(Array2DExprOpNotEqual, notEqualTo)
+
+#undef TBQ_ARRAY2DEXPR_BINARY_FCT
+
+template<typename X>
+typename std::enable_if<Array2DExprOperand<X>::IS_EXPR, Array2DExprUnary<Array2DExprOpNegate, typename Array2DExprOperand<X>::Type>>::type
+operator-(const X &operand);
+
+template<typename C, typename L, typename R>
+typename std::enable_if<Array2DExprOperand<C>::IS_EXPR && Array2DExprOperand<L>::IS_VALID && Array2DExprOperand<R>::IS_VALID,
+    Array2DExprWhere<typename Array2DExprOperand<C>::Type, typename Array2DExprOperand<L>::Type, typename Array2DExprOperand<R>::Type>>::type
+where(const C &cond, const L &left, const R &right);
+
+template<typename Expr, typename T, typename Layout, typename Allocator>
+bool evaluate(const Array2DExpr<Expr> &expr, Array2D<T, Layout, Allocator> &array);
+
+/*****************************/
+/* Define template
+ *      implementation       */
+/*****************************/
+
+/*!
+ * \brief Negate each element of an array or expression
+ *
+ * \param[in] operand
+ * Array or expression.
+ *
+ * \return
+ * Returns lazy expression
+ */
+template<typename X>
+typename std::enable_if<Array2DExprOperand<X>::IS_EXPR, Array2DExprUnary<Array2DExprOpNegate, typename Array2DExprOperand<X>::Type>>::type
+operator-(const X &operand)
+{
+    using Type = Array2DExprUnary<Array2DExprOpNegate, typename Array2DExprOperand<X>::Type>;
+    return Type(Array2DExprOperand<X>::make(operand));
+}
+
+/*!
+ * \brief Select elements depending on a condition
+ * \details
+ * For each element, result is element of \c left if
+ * \c cond is \c true, element of \c right otherwise.
+ * \code{.cpp}
+ * out = tbq::where(grid < 0, 0, grid);    // Clamp negative values
+ * \endcode
+ *
+ * \param[in] cond
+ * Array or expression used as condition.
+ * \param[in] left
+ * Array, expression or scalar used when condition is \c true.
+ * \param[in] right
+ * Array, expression or scalar used when condition is \c false.
+ *
+ * \return
+ * Returns lazy expression
+ */
+template<typename C, typename L, typename R>
+typename std::enable_if<Array2DExprOperand<C>::IS_EXPR && Array2DExprOperand<L>::IS_VALID && Array2DExprOperand<R>::IS_VALID,
+    Array2DExprWhere<typename Array2DExprOperand<C>::Type, typename Array2DExprOperand<L>::Type, typename Array2DExprOperand<R>::Type>>::type
+where(const C &cond, const L &left, const R &right)
+{
+    using Type = Array2DExprWhere<typename Array2DExprOperand<C>::Type, typename Array2DExprOperand<L>::Type, typename Array2DExprOperand<R>::Type>;
+    return Type(Array2DExprOperand<C>::make(cond), Array2DExprOperand<L>::make(left), Array2DExprOperand<R>::make(right));
+}
+
+/*!
+ * \brief Evaluate an expression into an array
+ * \details
+ * Array is resized to size of expression, then each element
+ * is computed in a single loop (which compiler can vectorize).
+ *
+ * \param[in] expr
+ * Expression to evaluate.
+ * \param[out] array
+ * Destination array, can be an operand of the expression.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if arrays of expression don't have same
+ * size or if memory can't be allocated, array is left unchanged.
+ */
+template<typename Expr, typename T, typename Layout, typename Allocator>
+bool evaluate(const Array2DExpr<Expr> &expr, Array2D<T, Layout, Allocator> &array)
+{
+    static_assert(std::is_same<typename Expr::LayoutType, Layout>::value, "Destination array must have same layout than arrays of expression");
+
+    const Expr &e = expr.derived();
+    if(!e.isValid() || !array.resize(e.getRows(), e.getCols())){
+        return false;
+    }
+
+    T *out = array.data();
+    const size_t size = array.getSize();
+    for(size_t i = 0; i < size; ++i){
+        out[i] = static_cast<T>(e.evalAt(i));
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Construct a 2D array from an expression
+ * \details
+ * Requires to include \c toolboxqt/containers/array2dexpr.h.
+ *
+ * \param[in] expr
+ * Expression to evaluate.
+ *
+ * \note
+ * Arrays of expression must have same size, this is asserted
+ * in debug builds. \n
+ * If arrays sizes differ (release builds) or if memory can't be
+ * allocated, array will be empty. Use tbq::evaluate() to
+ * detect failure.
+ */
+template<typename T, typename Layout, typename Allocator>
+template<typename Expr>
+Array2D<T, Layout, Allocator>::Array2D(const Array2DExpr<Expr> &expr)
+    : Array2D()
+{
+    Q_ASSERT_X(expr.isValid(), "Array2D::Array2D()", "Arrays of expression must have same size");
+    evaluate(expr, *this);
+}
+
+/*!
+ * \brief Assign result of an expression
+ * \details
+ * Requires to include \c toolboxqt/containers/array2dexpr.h.
+ *
+ * \param[in] expr
+ * Expression to evaluate.
+ *
+ * \return
+ * Returns reference to this array
+ *
+ * \note
+ * Arrays of expression must have same size, this is asserted
+ * in debug builds. \n
+ * If arrays sizes differ (release builds) or if memory can't be
+ * allocated, array is left unchanged. Use tbq::evaluate() to
+ * detect failure.
+ */
+template<typename T, typename Layout, typename Allocator>
+template<typename Expr>
+Array2D<T, Layout, Allocator>& Array2D<T, Layout, Allocator>::operator=(const Array2DExpr<Expr> &expr)
+{
+    Q_ASSERT_X(expr.isValid(), "Array2D::operator=()", "Arrays of expression must have same size");
+    evaluate(expr, *this);
+    return *this;
+}
+
+} // namespace tbq
+
+#endif // TBQ_CONTAINER_ARRAY2DEXPR_H
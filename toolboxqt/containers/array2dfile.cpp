@@ -0,0 +1,312 @@
+#include "array2dfile.h"
+
+#include <cstring>
+#include <limits>
+
+/*****************************/
+/* Class documentations      */
+/*****************************/
+
+/*!
+ * \class tbq::Array2DFileHeader
+ * \brief Header used by binary files containing
+ * a 2-dimensional array
+ * \details
+ * Include with:
+ * \code{.cpp}
+ * #include "toolboxqt/containers/array2dfile.h"
+ * \endcode
+ *
+ * Binary file is composed of a header of tbq::Array2DFileHeader::SIZE
+ * bytes followed by elements stored in row-major order using native
+ * representation. Header layout is:
+ * | Offset | Size | Content |
+ * |:-:|:-:|:-:|
+ * | 0 | 8 | Magic value <tt>"TBQA2D"</tt> (padded with \c 0) |
+ * | 8 | 4 | Format version |
+ * | 12 | 4 | Byte-order mark <tt>0x01020304</tt> |
+ * | 16 | 4 | Element type (tbq::Array2DFileHeader::ElemType) |
+ * | 20 | 4 | Element size in bytes |
+ * | 24 | 8 | Number of rows |
+ * | 32 | 8 | Number of columns |
+ * | 40 | 8 | Offset of data |
+ * | 48 | 16 | Reserved |
+ *
+ * All fields use native byte-order, files written on an host using a
+ * different byte-order will be rejected. \n
+ * Data offset is aligned on 64 bytes, so a memory-mapping of the
+ * file can be used directly to access elements.
+ */
+
+/*****************************/
+/*      Custom types
+ *     documentations        */
+/*****************************/
+
+/*!
+ * \enum tbq::Array2DFileHeader::ElemType
+ * \brief List of element types identifiers.
+ *
+ * \sa tbq::Array2DFileElemType
+ */
+
+/*****************************/
+/* Macro definitions         */
+/*****************************/
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/* Constants definitions     */
+/*****************************/
+const qint64 Array2DFileHeader::SIZE = 64;
+
+static const char HEADER_MAGIC[8] = {'T', 'B', 'Q', 'A', '2', 'D', '\0', '\0'};
+static const quint32 HEADER_VERSION = 1;
+static const quint32 HEADER_BOM = 0x01020304;
+
+static const size_t HEADER_OFFSET_VERSION = 8;
+static const size_t HEADER_OFFSET_BOM = 12;
+static const size_t HEADER_OFFSET_TYPE = 16;
+static const size_t HEADER_OFFSET_ELEMSIZE = 20;
+static const size_t HEADER_OFFSET_ROWS = 24;
+static const size_t HEADER_OFFSET_COLS = 32;
+static const size_t HEADER_OFFSET_DATA = 40;
+
+/*****************************/
+/* Functions implementation  */
+/*         Class             */
+/*****************************/
+
+/*!
+ * \brief Construct an invalid header
+ */
+Array2DFileHeader::Array2DFileHeader()
+    : m_type(ELEM_CUSTOM), m_elemSize(0), m_rows(0), m_cols(0)
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Construct a header
+ *
+ * \param[in] type
+ * Type of elements.
+ * \param[in] elemSize
+ * Size in bytes of an element.
+ * \param[in] nbRows
+ * Number of rows.
+ * \param[in] nbCols
+ * Number of colums
+ *
+ * \sa fromType()
+ */
+Array2DFileHeader::Array2DFileHeader(ElemType type, quint32 elemSize, quint64 nbRows, quint64 nbCols)
+    : m_type(type), m_elemSize(elemSize), m_rows(nbRows), m_cols(nbCols)
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Get type of elements
+ *
+ * \return
+ * Returns element type identifier
+ */
+Array2DFileHeader::ElemType Array2DFileHeader::getElemType() const
+{
+    return m_type;
+}
+
+/*!
+ * \brief Get size of an element
+ *
+ * \return
+ * Returns size of an element in bytes
+ */
+quint32 Array2DFileHeader::getElemSize() const
+{
+    return m_elemSize;
+}
+
+/*!
+ * \brief Get number of rows
+ *
+ * \return
+ * Returns number of rows
+ */
+quint64 Array2DFileHeader::getRows() const
+{
+    return m_rows;
+}
+
+/*!
+ * \brief Get number of columns
+ *
+ * \return
+ * Returns number of columns
+ */
+quint64 Array2DFileHeader::getCols() const
+{
+    return m_cols;
+}
+
+/*!
+ * \brief Get offset of elements from start of file
+ *
+ * \return
+ * Returns offset in bytes
+ */
+qint64 Array2DFileHeader::getDataOffset() const
+{
+    return SIZE;
+}
+
+/*!
+ * \brief Get size of all elements
+ *
+ * \return
+ * Returns size in bytes. \n
+ * Returns \c -1 if header is invalid.
+ *
+ * \sa isValid()
+ */
+qint64 Array2DFileHeader::getDataSize() const
+{
+    if(!isValid()){
+        return -1;
+    }
+
+    return static_cast<qint64>(m_rows * m_cols * m_elemSize);
+}
+
+/*!
+ * \brief Use to know if header is valid
+ * \details
+ * Header is valid when element size is set and
+ * when size of data can be represented without overflow.
+ *
+ * \return
+ * Returns \c true if valid
+ */
+bool Array2DFileHeader::isValid() const
+{
+    if(m_elemSize == 0){
+        return false;
+    }
+
+    const quint64 maxSize = static_cast<quint64>(std::numeric_limits<qint64>::max() - SIZE);
+    if(m_cols != 0 && m_rows > maxSize / m_cols){
+        return false;
+    }
+
+    const quint64 nbElems = m_rows * m_cols;
+    return nbElems == 0 || m_elemSize <= maxSize / nbElems;
+}
+
+/*!
+ * \brief Use to know if header can be used with
+ * an element type
+ *
+ * \param[in] type
+ * Type of elements.
+ * \param[in] elemSize
+ * Size in bytes of an element.
+ *
+ * \return
+ * Returns \c true if compatible
+ */
+bool Array2DFileHeader::isCompatible(ElemType type, quint32 elemSize) const
+{
+    return isValid() && m_type == type && m_elemSize == elemSize;
+}
+
+/*!
+ * \brief Read header from a device
+ *
+ * \param[in, out] device
+ * Device to read from. \n
+ * Device position will be set just after the header (which
+ * is also the start of data).
+ *
+ * \return
+ * Returns \c true if a valid header has been read.
+ */
+bool Array2DFileHeader::read(QIODevice &device)
+{
+    char buffer[SIZE];
+    if(device.read(buffer, SIZE) != SIZE){
+        return false;
+    }
+
+    /* Verify header identity */
+    quint32 version = 0;
+    quint32 bom = 0;
+    quint64 offset = 0;
+
+    std::memcpy(&version, buffer + HEADER_OFFSET_VERSION, sizeof(version));
+    std::memcpy(&bom, buffer + HEADER_OFFSET_BOM, sizeof(bom));
+    std::memcpy(&offset, buffer + HEADER_OFFSET_DATA, sizeof(offset));
+
+    if(std::memcmp(buffer, HEADER_MAGIC, sizeof(HEADER_MAGIC)) != 0
+        || version != HEADER_VERSION
+        || bom != HEADER_BOM
+        || offset != static_cast<quint64>(SIZE)){
+        return false;
+    }
+
+    /* Retrieve array properties */
+    std::memcpy(&m_type, buffer + HEADER_OFFSET_TYPE, sizeof(m_type));
+    std::memcpy(&m_elemSize, buffer + HEADER_OFFSET_ELEMSIZE, sizeof(m_elemSize));
+    std::memcpy(&m_rows, buffer + HEADER_OFFSET_ROWS, sizeof(m_rows));
+    std::memcpy(&m_cols, buffer + HEADER_OFFSET_COLS, sizeof(m_cols));
+
+    return isValid();
+}
+
+/*!
+ * \brief Write header to a device
+ *
+ * \param[in, out] device
+ * Device to write to.
+ *
+ * \return
+ * Returns \c true if succeed.
+ */
+bool Array2DFileHeader::write(QIODevice &device) const
+{
+    if(!isValid()){
+        return false;
+    }
+
+    char buffer[SIZE];
+    std::memset(buffer, 0, sizeof(buffer));
+
+    const quint64 offset = static_cast<quint64>(SIZE);
+
+    std::memcpy(buffer, HEADER_MAGIC, sizeof(HEADER_MAGIC));
+    std::memcpy(buffer + HEADER_OFFSET_VERSION, &HEADER_VERSION, sizeof(HEADER_VERSION));
+    std::memcpy(buffer + HEADER_OFFSET_BOM, &HEADER_BOM, sizeof(HEADER_BOM));
+    std::memcpy(buffer + HEADER_OFFSET_TYPE, &m_type, sizeof(m_type));
+    std::memcpy(buffer + HEADER_OFFSET_ELEMSIZE, &m_elemSize, sizeof(m_elemSize));
+    std::memcpy(buffer + HEADER_OFFSET_ROWS, &m_rows, sizeof(m_rows));
+    std::memcpy(buffer + HEADER_OFFSET_COLS, &m_cols, sizeof(m_cols));
+    std::memcpy(buffer + HEADER_OFFSET_DATA, &offset, sizeof(offset));
+
+    return device.write(buffer, SIZE) == SIZE;
+}
+
+/*****************************/
+/* End namespace             */
+/*****************************/
+
+} // namespace tbq
+
+/*****************************/
+/* End file                  */
+/*****************************/
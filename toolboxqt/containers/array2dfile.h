@@ -0,0 +1,126 @@
+#ifndef TBQ_CONTAINER_ARRAY2DFILE_H
+#define TBQ_CONTAINER_ARRAY2DFILE_H
+
+#include "toolboxqt/toolboxqt_global.h"
+
+#include <QIODevice>
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/*     Class definitions     */
+/*     Array2DFileHeader     */
+/*****************************/
+
+class TOOLBOXQT_EXPORT Array2DFileHeader
+{
+
+public:
+    enum ElemType : quint32
+    {
+        ELEM_CUSTOM = 0,
+        ELEM_INT8,
+        ELEM_UINT8,
+        ELEM_INT16,
+        ELEM_UINT16,
+        ELEM_INT32,
+        ELEM_UINT32,
+        ELEM_INT64,
+        ELEM_UINT64,
+        ELEM_FLOAT,
+        ELEM_DOUBLE
+    };
+
+public:
+    static const qint64 SIZE;
+
+public:
+    explicit Array2DFileHeader();
+    explicit Array2DFileHeader(ElemType type, quint32 elemSize, quint64 nbRows, quint64 nbCols);
+
+public:
+    ElemType getElemType() const;
+    quint32 getElemSize() const;
+
+    quint64 getRows() const;
+    quint64 getCols() const;
+
+    qint64 getDataOffset() const;
+    qint64 getDataSize() const;
+
+    bool isValid() const;
+    bool isCompatible(ElemType type, quint32 elemSize) const;
+
+public:
+    bool read(QIODevice &device);
+    bool write(QIODevice &device) const;
+
+public:
+    template<typename T>
+    static Array2DFileHeader fromType(quint64 nbRows, quint64 nbCols);
+
+private:
+    ElemType m_type;
+    quint32 m_elemSize;
+    quint64 m_rows;
+    quint64 m_cols;
+};
+
+/*****************************/
+/*    Template definitions   */
+/*****************************/
+
+/*!
+ * \brief Trait used to associate a type to
+ * its tbq::Array2DFileHeader::ElemType identifier
+ * \details
+ * Types without dedicated identifier use
+ * tbq::Array2DFileHeader::ELEM_CUSTOM, only
+ * their size will be checked.
+ */
+template<typename T> struct Array2DFileElemType          { static const Array2DFileHeader::ElemType value = Array2DFileHeader::ELEM_CUSTOM; };
+template<> struct Array2DFileElemType<qint8>             { static const Array2DFileHeader::ElemType value = Array2DFileHeader::ELEM_INT8; };
+template<> struct Array2DFileElemType<quint8>            { static const Array2DFileHeader::ElemType value = Array2DFileHeader::ELEM_UINT8; };
+template<> struct Array2DFileElemType<qint16>            { static const Array2DFileHeader::ElemType value = Array2DFileHeader::ELEM_INT16; };
+template<> struct Array2DFileElemType<quint16>           { static const Array2DFileHeader::ElemType value = Array2DFileHeader::ELEM_UINT16; };
+template<> struct Array2DFileElemType<qint32>            { static const Array2DFileHeader::ElemType value = Array2DFileHeader::ELEM_INT32; };
+template<> struct Array2DFileElemType<quint32>           { static const Array2DFileHeader::ElemType value = Array2DFileHeader::ELEM_UINT32; };
+template<> struct Array2DFileElemType<qint64>            { static const Array2DFileHeader::ElemType value = Array2DFileHeader::ELEM_INT64; };
+template<> struct Array2DFileElemType<quint64>           { static const Array2DFileHeader::ElemType value = Array2DFileHeader::ELEM_UINT64; };
+template<> struct Array2DFileElemType<float>             { static const Array2DFileHeader::ElemType value = Array2DFileHeader::ELEM_FLOAT; };
+template<> struct Array2DFileElemType<double>            { static const Array2DFileHeader::ElemType value = Array2DFileHeader::ELEM_DOUBLE; };
+
+/*!
+ * \brief Build header associated to a 2D array
+ * of type \c T
+ *
+ * \param[in] nbRows
+ * Number of rows.
+ * \param[in] nbCols
+ * Number of colums
+ *
+ * \return
+ * Returns header to use.
+ */
+template<typename T>
+Array2DFileHeader Array2DFileHeader::fromType(quint64 nbRows, quint64 nbCols)
+{
+    return Array2DFileHeader(Array2DFileElemType<T>::value, sizeof(T), nbRows, nbCols);
+}
+
+/*****************************/
+/* End namespace             */
+/*****************************/
+
+} // namespace tbq
+
+/*****************************/
+/* End file                  */
+/*****************************/
+
+#endif // TBQ_CONTAINER_ARRAY2DFILE_H
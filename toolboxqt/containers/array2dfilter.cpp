@@ -0,0 +1,215 @@
+#include "array2dfilter.h"
+
+/*****************************/
+/* Class documentations      */
+/*****************************/
+
+/*!
+ * \class tbq::Array2DFilter
+ * \brief Convolution and stencil filters over 2-dimensional arrays
+ * \details
+ * Include with:
+ * \code{.cpp}
+ * #include "toolboxqt/containers/array2dfilter.h"
+ * \endcode
+ *
+ * Filters read a source array and write a destination array of same
+ * size, which can use another element type (for example, to compute
+ * \c float derivatives of a \c quint8 image):
+ * \code{.cpp}
+ * tbq::Array2D<quint8> image = loadImage();
+ *
+ * tbq::Array2D<quint8> blurred;
+ * tbq::Array2DFilter::gaussianBlur(image, blurred, 1.5);
+ *
+ * tbq::Array2D<float> gradX;
+ * tbq::Array2DFilter::sobel(image, gradX, tbq::Array2DFilter::SOBEL_X);
+ * \endcode
+ *
+ * Elements outside of source array are extrapolated according
+ * to tbq::Array2DFilter::BorderMode. Computations are performed with
+ * \c float (or \c double for 32-bit integers and \c double elements),
+ * results are rounded and saturated when destination type is an
+ * integer type.
+ *
+ * Rows are split in bands processed across threads (see
+ * tbq::parallelForRows()) and each row is accumulated by tiles of
+ * columns, so working data stay in cache and inner loops are
+ * vectorized by the compiler. Separable filters (box, gaussian,
+ * Sobel, erosion and dilation) use one horizontal and one vertical
+ * pass, their cost is proportional to kernel width plus height.
+ */
+
+/*****************************/
+/*      Custom types
+ *     documentations        */
+/*****************************/
+
+/*!
+ * \enum tbq::Array2DFilter::BorderMode
+ * \brief List of modes used to extrapolate elements
+ * outside of an array
+ * \details
+ * Examples are given for a row <tt>abcd</tt>.
+ *
+ * \var tbq::Array2DFilter::BORDER_CONSTANT
+ * Use a constant value: <tt>vv|abcd|vv</tt>
+ *
+ * \var tbq::Array2DFilter::BORDER_REPLICATE
+ * Repeat nearest element: <tt>aa|abcd|dd</tt>
+ *
+ * \var tbq::Array2DFilter::BORDER_REFLECT
+ * Mirror elements, edge included: <tt>ba|abcd|dc</tt>
+ *
+ * \var tbq::Array2DFilter::BORDER_WRAP
+ * Wrap around array: <tt>cd|abcd|ab</tt>
+ */
+
+/*!
+ * \enum tbq::Array2DFilter::SobelDirection
+ * \brief List of derivative directions of Sobel operator
+ *
+ * \var tbq::Array2DFilter::SOBEL_X
+ * Derivative along columns (horizontal).
+ *
+ * \var tbq::Array2DFilter::SOBEL_Y
+ * Derivative along rows (vertical).
+ */
+
+/*****************************/
+/* Macro definitions         */
+/*****************************/
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/* Constants definitions     */
+/*****************************/
+
+constexpr size_t Array2DFilter::TILE_COLS;
+
+/*****************************/
+/* Functions implementation  */
+/*         Class             */
+/*****************************/
+
+/*!
+ * \brief Map an index to an index inside an array
+ *
+ * \param[in] index
+ * Index to map, can be outside of <tt>[0, size[</tt>.
+ * \param[in] size
+ * Number of elements, must be strictly positive.
+ * \param[in] border
+ * Mode used to extrapolate elements.
+ *
+ * \return
+ * Returns mapped index. \n
+ * Returns \c -1 if \c index is outside of array and \c border
+ * is tbq::Array2DFilter::BORDER_CONSTANT.
+ */
+qint64 Array2DFilter::borderIndex(qint64 index, qint64 size, BorderMode border)
+{
+    if(index >= 0 && index < size){
+        return index;
+    }
+
+    switch(border){
+        case BORDER_REPLICATE:{
+            return index < 0 ? 0 : size - 1;
+        }
+
+        case BORDER_REFLECT:{
+            const qint64 period = 2 * size;
+            qint64 mapped = index % period;
+            if(mapped < 0){
+                mapped += period;
+            }
+            return mapped < size ? mapped : period - 1 - mapped;
+        }
+
+        case BORDER_WRAP:{
+            const qint64 mapped = index % size;
+            return mapped < 0 ? mapped + size : mapped;
+        }
+
+        case BORDER_CONSTANT:
+        default:{
+            return -1;
+        }
+    }
+}
+
+/*!
+ * \brief Build kernel of a box filter
+ *
+ * \param[in] radius
+ * Radius of kernel.
+ *
+ * \return
+ * Returns normalized kernel of <tt>2 * radius + 1</tt> elements. \n
+ * Returns empty kernel if \c radius is negative.
+ *
+ * \sa gaussianKernel()
+ */
+QVector<double> Array2DFilter::boxKernel(int radius)
+{
+    if(radius < 0){
+        return QVector<double>();
+    }
+
+    const int size = 2 * radius + 1;
+    return QVector<double>(size, 1.0 / size);
+}
+
+/*!
+ * \brief Build kernel of a gaussian filter
+ * \details
+ * Kernel is truncated at <tt>3 * sigma</tt>.
+ *
+ * \param[in] sigma
+ * Standard deviation of gaussian, in elements.
+ *
+ * \return
+ * Returns normalized kernel of <tt>2 * ceil(3 * sigma) + 1</tt> elements. \n
+ * Returns empty kernel if \c sigma is not strictly positive.
+ *
+ * \sa boxKernel()
+ */
+QVector<double> Array2DFilter::gaussianKernel(double sigma)
+{
+    if(!(sigma > 0.0)){
+        return QVector<double>();
+    }
+
+    const int radius = static_cast<int>(std::ceil(3.0 * sigma));
+    QVector<double> kernel(2 * radius + 1);
+
+    double sum = 0.0;
+    for(int i = -radius; i <= radius; ++i){
+        const double value = std::exp(-(i * i) / (2.0 * sigma * sigma));
+        kernel[i + radius] = value;
+        sum += value;
+    }
+
+    for(double &value : kernel){
+        value /= sum;
+    }
+
+    return kernel;
+}
+
+/*****************************/
+/* End namespace             */
+/*****************************/
+
+} // namespace tbq
+
+/*****************************/
+/* End file                  */
+/*****************************/
@@ -0,0 +1,892 @@
+#ifndef TBQ_CONTAINER_ARRAY2DFILTER_H
+#define TBQ_CONTAINER_ARRAY2DFILTER_H
+
+#include "toolboxqt/toolboxqt_global.h"
+#include "toolboxqt/containers/array2d.h"
+#include "toolboxqt/containers/array2dalgorithms.h"
+#include "toolboxqt/containers/array2dstorage.h"
+
+#include <QThreadPool>
+#include <QVector>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/*     Class definitions     */
+/*       Array2DFilter       */
+/*****************************/
+
+class TOOLBOXQT_EXPORT Array2DFilter
+{
+
+public:
+    enum BorderMode
+    {
+        BORDER_CONSTANT = 0,
+        BORDER_REPLICATE,
+        BORDER_REFLECT,
+        BORDER_WRAP
+    };
+
+    enum SobelDirection
+    {
+        SOBEL_X = 0,
+        SOBEL_Y
+    };
+
+public:
+    static qint64 borderIndex(qint64 index, qint64 size, BorderMode border);
+
+    static QVector<double> boxKernel(int radius);
+    static QVector<double> gaussianKernel(double sigma);
+
+public:
+    template<typename T, typename U, typename Layout, typename Allocator, typename OutAllocator>
+    static bool convolve(const Array2D<T, Layout, Allocator> &src, Array2D<U, Layout, OutAllocator> &dst, const Array2D<double> &kernel, BorderMode border = BORDER_REPLICATE, double borderValue = 0, QThreadPool *pool = nullptr);
+
+    template<typename T, typename U, typename Layout, typename Allocator, typename OutAllocator>
+    static bool convolveSeparable(const Array2D<T, Layout, Allocator> &src, Array2D<U, Layout, OutAllocator> &dst, const QVector<double> &kernelX, const QVector<double> &kernelY, BorderMode border = BORDER_REPLICATE, double borderValue = 0, QThreadPool *pool = nullptr);
+
+public:
+    template<typename T, typename U, typename Layout, typename Allocator, typename OutAllocator>
+    static bool boxBlur(const Array2D<T, Layout, Allocator> &src, Array2D<U, Layout, OutAllocator> &dst, int radius, BorderMode border = BORDER_REPLICATE, QThreadPool *pool = nullptr);
+
+    template<typename T, typename U, typename Layout, typename Allocator, typename OutAllocator>
+    static bool gaussianBlur(const Array2D<T, Layout, Allocator> &src, Array2D<U, Layout, OutAllocator> &dst, double sigma, BorderMode border = BORDER_REPLICATE, QThreadPool *pool = nullptr);
+
+    template<typename T, typename U, typename Layout, typename Allocator, typename OutAllocator>
+    static bool sobel(const Array2D<T, Layout, Allocator> &src, Array2D<U, Layout, OutAllocator> &dst, SobelDirection direction, BorderMode border = BORDER_REPLICATE, QThreadPool *pool = nullptr);
+
+    template<typename T, typename U, typename Layout, typename Allocator, typename OutAllocator>
+    static bool erode(const Array2D<T, Layout, Allocator> &src, Array2D<U, Layout, OutAllocator> &dst, int radiusY, int radiusX, BorderMode border = BORDER_REPLICATE, QThreadPool *pool = nullptr);
+
+    template<typename T, typename U, typename Layout, typename Allocator, typename OutAllocator>
+    static bool dilate(const Array2D<T, Layout, Allocator> &src, Array2D<U, Layout, OutAllocator> &dst, int radiusY, int radiusX, BorderMode border = BORDER_REPLICATE, QThreadPool *pool = nullptr);
+
+private:
+    template<typename T>
+    using IsPrecise = std::integral_constant<bool, !(std::is_same<T, float>::value || (std::is_integral<T>::value && sizeof(T) <= 2))>;
+
+    template<typename T, typename U>
+    using AccType = typename std::conditional<IsPrecise<T>::value || IsPrecise<U>::value, double, float>::type;
+
+    template<typename A>
+    struct OpWeighted
+    {
+        const A *weights;
+        size_t size;
+        size_t anchor;
+
+        A init() const { return A(0); }
+        void apply(A &acc, A value, size_t k) const { acc += weights[k] * value; }
+    };
+
+    template<typename A>
+    struct OpMin
+    {
+        size_t size;
+        size_t anchor;
+
+        A init() const { return std::numeric_limits<A>::max(); }
+        void apply(A &acc, A value, size_t k) const { Q_UNUSED(k) acc = value < acc ? value : acc; }
+    };
+
+    template<typename A>
+    struct OpMax
+    {
+        size_t size;
+        size_t anchor;
+
+        A init() const { return std::numeric_limits<A>::lowest(); }
+        void apply(A &acc, A value, size_t k) const { Q_UNUSED(k) acc = value > acc ? value : acc; }
+    };
+
+private:
+    static constexpr size_t TILE_COLS = 2048;
+
+private:
+    template<typename T, typename U, typename Layout, typename Allocator, typename OutAllocator>
+    static bool filterSeparable(const Array2D<T, Layout, Allocator> &src, Array2D<U, Layout, OutAllocator> &dst, const QVector<double> &weightsX, const QVector<double> &weightsY, BorderMode border, double borderValue, QThreadPool *pool);
+
+    template<typename T, typename U, typename Layout, typename Allocator, typename OutAllocator>
+    static bool filterMorphology(const Array2D<T, Layout, Allocator> &src, Array2D<U, Layout, OutAllocator> &dst, int radiusY, int radiusX, bool isMin, BorderMode border, QThreadPool *pool);
+
+    template<typename T, typename U, typename A>
+    static bool correlateStorage(const T *src, U *dst, size_t nbRows, size_t nbCols, const Array2D<double> &kernel, BorderMode border, A borderValue, QThreadPool *pool);
+
+    template<typename T, typename U, typename A, typename OpX, typename OpY>
+    static bool separableStorage(const T *src, U *dst, size_t nbRows, size_t nbCols, const OpX &opX, const OpY &opY, BorderMode border, A borderValueX, A borderValueY, QThreadPool *pool);
+
+    template<typename T, typename A>
+    static void padRow(const T *row, size_t size, size_t padBefore, size_t padAfter, BorderMode border, A borderValue, A *out);
+
+    template<typename U, typename A>
+    static U castResult(A value, std::true_type isIntegral);
+    template<typename U, typename A>
+    static U castResult(A value, std::false_type isIntegral);
+
+    template<typename T, typename U, typename Layout, typename Allocator, typename OutAllocator>
+    static bool isSameArray(const Array2D<T, Layout, Allocator> &src, const Array2D<U, Layout, OutAllocator> &dst);
+};
+
+/*****************************/
+/*   Template definitions    */
+/*****************************/
+
+/*!
+ * \brief Convolve a 2D array with a kernel
+ * \details
+ * Kernel anchor is its center (<tt>(kernel.getRows() - 1) / 2,
+ * (kernel.getCols() - 1) / 2</tt>), odd kernel sizes should
+ * be preferred. \n
+ * Use convolveSeparable() when kernel is separable, cost
+ * per element is then proportional to <tt>rows + cols</tt> of
+ * kernel instead of <tt>rows * cols</tt>.
+ *
+ * \param[in] src
+ * Array to filter.
+ * \param[out] dst
+ * Filtered array, resized to size of \c src. \n
+ * Results are rounded and saturated when \c U is
+ * an integer type. \n
+ * Can be the same object than \c src.
+ * \param[in] kernel
+ * Convolution kernel. \n
+ * Must not be empty.
+ * \param[in] border
+ * Mode used to extrapolate elements outside of \c src.
+ * \param[in] borderValue
+ * Value used when \c border is tbq::Array2DFilter::BORDER_CONSTANT.
+ * \param[in] pool
+ * Thread pool to use, if \c nullptr, \c QThreadPool::globalInstance()
+ * will be used.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if kernel is empty or if \c dst
+ * or buffers of a band can't be allocated.
+ */
+template<typename T, typename U, typename Layout, typename Allocator, typename OutAllocator>
+bool Array2DFilter::convolve(const Array2D<T, Layout, Allocator> &src, Array2D<U, Layout, OutAllocator> &dst, const Array2D<double> &kernel, BorderMode border, double borderValue, QThreadPool *pool)
+{
+    typedef AccType<T, U> A;
+
+    if(kernel.getSize() == 0){
+        return false;
+    }
+
+    if(isSameArray(src, dst)){
+        Array2D<U, Layout, OutAllocator> result;
+        if(!convolve(src, result, kernel, border, borderValue, pool)){
+            return false;
+        }
+
+        dst = std::move(result);
+        return true;
+    }
+
+    if(!dst.resize(src.getRows(), src.getCols())){
+        return false;
+    }
+
+    /* Convolution is a correlation with flipped kernel, storage of column-major arrays is transposed */
+    const size_t kRows = Layout::IS_ROW_MAJOR ? kernel.getRows() : kernel.getCols();
+    const size_t kCols = Layout::IS_ROW_MAJOR ? kernel.getCols() : kernel.getRows();
+
+    Array2D<double> weights;
+    if(!weights.resize(kRows, kCols)){
+        return false;
+    }
+
+    for(size_t row = 0; row < kRows; ++row){
+        for(size_t col = 0; col < kCols; ++col){
+            const size_t kRow = kernel.getRows() - 1 - (Layout::IS_ROW_MAJOR ? row : col);
+            const size_t kCol = kernel.getCols() - 1 - (Layout::IS_ROW_MAJOR ? col : row);
+            weights(row, col) = kernel(kRow, kCol);
+        }
+    }
+
+    const size_t storeRows = Layout::IS_ROW_MAJOR ? src.getRows() : src.getCols();
+    const size_t storeCols = Layout::IS_ROW_MAJOR ? src.getCols() : src.getRows();
+    return correlateStorage(src.data(), dst.data(), storeRows, storeCols, weights, border, static_cast<A>(borderValue), pool);
+}
+
+/*!
+ * \brief Convolve a 2D array with a separable kernel
+ * \details
+ * Result is the convolution with kernel <tt>kernelY^T * kernelX</tt>,
+ * computed with one horizontal pass and one vertical pass. \n
+ * Anchor of each kernel is its center (<tt>(size - 1) / 2</tt>).
+ *
+ * \param[in] src
+ * Array to filter.
+ * \param[out] dst
+ * Filtered array, resized to size of \c src. \n
+ * Results are rounded and saturated when \c U is
+ * an integer type. \n
+ * Can be the same object than \c src.
+ * \param[in] kernelX
+ * Kernel applied along each row. \n
+ * Must not be empty.
+ * \param[in] kernelY
+ * Kernel applied along each column. \n
+ * Must not be empty.
+ * \param[in] border
+ * Mode used to extrapolate elements outside of \c src.
+ * \param[in] borderValue
+ * Value used when \c border is tbq::Array2DFilter::BORDER_CONSTANT.
+ * \param[in] pool
+ * Thread pool to use, if \c nullptr, \c QThreadPool::globalInstance()
+ * will be used.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if a kernel is empty or if memory
+ * can't be allocated.
+ */
+template<typename T, typename U, typename Layout, typename Allocator, typename OutAllocator>
+bool Array2DFilter::convolveSeparable(const Array2D<T, Layout, Allocator> &src, Array2D<U, Layout, OutAllocator> &dst, const QVector<double> &kernelX, const QVector<double> &kernelY, BorderMode border, double borderValue, QThreadPool *pool)
+{
+    /* Convolution is a correlation with flipped kernels */
+    QVector<double> weightsX(kernelX);
+    QVector<double> weightsY(kernelY);
+    std::reverse(weightsX.begin(), weightsX.end());
+    std::reverse(weightsY.begin(), weightsY.end());
+
+    return filterSeparable(src, dst, weightsX, weightsY, border, borderValue, pool);
+}
+
+/*!
+ * \brief Blur a 2D array with a box filter
+ * \details
+ * Each element is replaced by the mean of elements
+ * in a square window of size <tt>2 * radius + 1</tt>.
+ *
+ * \param[in] src
+ * Array to filter.
+ * \param[out] dst
+ * Filtered array, resized to size of \c src. \n
+ * Can be the same object than \c src.
+ * \param[in] radius
+ * Radius of window.
+ * \param[in] border
+ * Mode used to extrapolate elements outside of \c src.
+ * \param[in] pool
+ * Thread pool to use, if \c nullptr, \c QThreadPool::globalInstance()
+ * will be used.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if \c radius is negative or if memory
+ * can't be allocated.
+ *
+ * \sa boxKernel()
+ */
+template<typename T, typename U, typename Layout, typename Allocator, typename OutAllocator>
+bool Array2DFilter::boxBlur(const Array2D<T, Layout, Allocator> &src, Array2D<U, Layout, OutAllocator> &dst, int radius, BorderMode border, QThreadPool *pool)
+{
+    const QVector<double> kernel = boxKernel(radius);
+    return filterSeparable(src, dst, kernel, kernel, border, 0, pool);
+}
+
+/*!
+ * \brief Blur a 2D array with a gaussian filter
+ *
+ * \param[in] src
+ * Array to filter.
+ * \param[out] dst
+ * Filtered array, resized to size of \c src. \n
+ * Can be the same object than \c src.
+ * \param[in] sigma
+ * Standard deviation of gaussian, in elements.
+ * \param[in] border
+ * Mode used to extrapolate elements outside of \c src.
+ * \param[in] pool
+ * Thread pool to use, if \c nullptr, \c QThreadPool::globalInstance()
+ * will be used.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if \c sigma is not strictly positive or if
+ * memory can't be allocated.
+ *
+ * \sa gaussianKernel()
+ */
+template<typename T, typename U, typename Layout, typename Allocator, typename OutAllocator>
+bool Array2DFilter::gaussianBlur(const Array2D<T, Layout, Allocator> &src, Array2D<U, Layout, OutAllocator> &dst, double sigma, BorderMode border, QThreadPool *pool)
+{
+    const QVector<double> kernel = gaussianKernel(sigma);
+    return filterSeparable(src, dst, kernel, kernel, border, 0, pool);
+}
+
+/*!
+ * \brief Compute derivative of a 2D array using
+ * 3x3 Sobel operator
+ * \details
+ * Result is positive when values increase along
+ * \c direction. \n
+ * A signed type (like \c float or \c qint32) should be used
+ * for \c dst.
+ *
+ * \param[in] src
+ * Array to filter.
+ * \param[out] dst
+ * Filtered array, resized to size of \c src. \n
+ * Can be the same object than \c src.
+ * \param[in] direction
+ * Direction of derivative.
+ * \param[in] border
+ * Mode used to extrapolate elements outside of \c src.
+ * \param[in] pool
+ * Thread pool to use, if \c nullptr, \c QThreadPool::globalInstance()
+ * will be used.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if memory can't be allocated.
+ */
+template<typename T, typename U, typename Layout, typename Allocator, typename OutAllocator>
+bool Array2DFilter::sobel(const Array2D<T, Layout, Allocator> &src, Array2D<U, Layout, OutAllocator> &dst, SobelDirection direction, BorderMode border, QThreadPool *pool)
+{
+    const QVector<double> derivative = {-1.0, 0.0, 1.0};
+    const QVector<double> smooth = {1.0, 2.0, 1.0};
+
+    if(direction == SOBEL_X){
+        return filterSeparable(src, dst, derivative, smooth, border, 0, pool);
+    }
+
+    return filterSeparable(src, dst, smooth, derivative, border, 0, pool);
+}
+
+/*!
+ * \brief Apply a morphological erosion to a 2D array
+ * \details
+ * Each element is replaced by the minimum of elements in a
+ * rectangular window of size <tt>(2 * radiusY + 1) x (2 * radiusX + 1)</tt>. \n
+ * With tbq::Array2DFilter::BORDER_CONSTANT, elements outside
+ * of \c src are ignored.
+ *
+ * \param[in] src
+ * Array to filter.
+ * \param[out] dst
+ * Filtered array, resized to size of \c src. \n
+ * Can be the same object than \c src.
+ * \param[in] radiusY
+ * Vertical radius of window.
+ * \param[in] radiusX
+ * Horizontal radius of window.
+ * \param[in] border
+ * Mode used to extrapolate elements outside of \c src.
+ * \param[in] pool
+ * Thread pool to use, if \c nullptr, \c QThreadPool::globalInstance()
+ * will be used.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if a radius is negative or if memory
+ * can't be allocated.
+ *
+ * \sa dilate()
+ */
+template<typename T, typename U, typename Layout, typename Allocator, typename OutAllocator>
+bool Array2DFilter::erode(const Array2D<T, Layout, Allocator> &src, Array2D<U, Layout, OutAllocator> &dst, int radiusY, int radiusX, BorderMode border, QThreadPool *pool)
+{
+    return filterMorphology(src, dst, radiusY, radiusX, true, border, pool);
+}
+
+/*!
+ * \brief Apply a morphological dilation to a 2D array
+ * \details
+ * Each element is replaced by the maximum of elements in a
+ * rectangular window of size <tt>(2 * radiusY + 1) x (2 * radiusX + 1)</tt>. \n
+ * With tbq::Array2DFilter::BORDER_CONSTANT, elements outside
+ * of \c src are ignored.
+ *
+ * \param[in] src
+ * Array to filter.
+ * \param[out] dst
+ * Filtered array, resized to size of \c src. \n
+ * Can be the same object than \c src.
+ * \param[in] radiusY
+ * Vertical radius of window.
+ * \param[in] radiusX
+ * Horizontal radius of window.
+ * \param[in] border
+ * Mode used to extrapolate elements outside of \c src.
+ * \param[in] pool
+ * Thread pool to use, if \c nullptr, \c QThreadPool::globalInstance()
+ * will be used.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if a radius is negative or if memory
+ * can't be allocated.
+ *
+ * \sa erode()
+ */
+template<typename T, typename U, typename Layout, typename Allocator, typename OutAllocator>
+bool Array2DFilter::dilate(const Array2D<T, Layout, Allocator> &src, Array2D<U, Layout, OutAllocator> &dst, int radiusY, int radiusX, BorderMode border, QThreadPool *pool)
+{
+    return filterMorphology(src, dst, radiusY, radiusX, false, border, pool);
+}
+
+/*!
+ * \brief Apply separable correlation weights to a 2D array
+ *
+ * \param[in] src
+ * Array to filter.
+ * \param[out] dst
+ * Filtered array.
+ * \param[in] weightsX
+ * Correlation weights applied along each row.
+ * \param[in] weightsY
+ * Correlation weights applied along each column.
+ * \param[in] border
+ * Mode used to extrapolate elements outside of \c src.
+ * \param[in] borderValue
+ * Value used when \c border is tbq::Array2DFilter::BORDER_CONSTANT.
+ * \param[in] pool
+ * Thread pool to use.
+ *
+ * \return
+ * Returns \c true if succeed.
+ */
+template<typename T, typename U, typename Layout, typename Allocator, typename OutAllocator>
+bool Array2DFilter::filterSeparable(const Array2D<T, Layout, Allocator> &src, Array2D<U, Layout, OutAllocator> &dst, const QVector<double> &weightsX, const QVector<double> &weightsY, BorderMode border, double borderValue, QThreadPool *pool)
+{
+    typedef AccType<T, U> A;
+
+    if(weightsX.isEmpty() || weightsY.isEmpty()){
+        return false;
+    }
+
+    if(isSameArray(src, dst)){
+        Array2D<U, Layout, OutAllocator> result;
+        if(!filterSeparable(src, result, weightsX, weightsY, border, borderValue, pool)){
+            return false;
+        }
+
+        dst = std::move(result);
+        return true;
+    }
+
+    if(!dst.resize(src.getRows(), src.getCols())){
+        return false;
+    }
+
+    /* Storage of column-major arrays is transposed, so swap passes */
+    const QVector<double> &storeWeightsX = Layout::IS_ROW_MAJOR ? weightsX : weightsY;
+    const QVector<double> &storeWeightsY = Layout::IS_ROW_MAJOR ? weightsY : weightsX;
+
+    const QVector<A> wx(storeWeightsX.cbegin(), storeWeightsX.cend());
+    const QVector<A> wy(storeWeightsY.cbegin(), storeWeightsY.cend());
+
+    const OpWeighted<A> opX = {wx.constData(), static_cast<size_t>(wx.size()), static_cast<size_t>(wx.size() - 1) / 2};
+    const OpWeighted<A> opY = {wy.constData(), static_cast<size_t>(wy.size()), static_cast<size_t>(wy.size() - 1) / 2};
+
+    /* Rows outside of array are constant rows filtered by horizontal pass */
+    A sumX = 0;
+    for(const A weight : wx){
+        sumX += weight;
+    }
+
+    const size_t storeRows = Layout::IS_ROW_MAJOR ? src.getRows() : src.getCols();
+    const size_t storeCols = Layout::IS_ROW_MAJOR ? src.getCols() : src.getRows();
+    return separableStorage(src.data(), dst.data(), storeRows, storeCols, opX, opY, border, static_cast<A>(borderValue), static_cast<A>(borderValue) * sumX, pool);
+}
+
+/*!
+ * \brief Apply morphological minimum or maximum
+ * to a 2D array
+ *
+ * \param[in] src
+ * Array to filter.
+ * \param[out] dst
+ * Filtered array.
+ * \param[in] radiusY
+ * Vertical radius of window.
+ * \param[in] radiusX
+ * Horizontal radius of window.
+ * \param[in] isMin
+ * Use \c true for minimum, \c false for maximum.
+ * \param[in] border
+ * Mode used to extrapolate elements outside of \c src.
+ * \param[in] pool
+ * Thread pool to use.
+ *
+ * \return
+ * Returns \c true if succeed.
+ */
+template<typename T, typename U, typename Layout, typename Allocator, typename OutAllocator>
+bool Array2DFilter::filterMorphology(const Array2D<T, Layout, Allocator> &src, Array2D<U, Layout, OutAllocator> &dst, int radiusY, int radiusX, bool isMin, BorderMode border, QThreadPool *pool)
+{
+    typedef AccType<T, U> A;
+
+    if(radiusY < 0 || radiusX < 0){
+        return false;
+    }
+
+    if(isSameArray(src, dst)){
+        Array2D<U, Layout, OutAllocator> result;
+        if(!filterMorphology(src, result, radiusY, radiusX, isMin, border, pool)){
+            return false;
+        }
+
+        dst = std::move(result);
+        return true;
+    }
+
+    if(!dst.resize(src.getRows(), src.getCols())){
+        return false;
+    }
+
+    /* Storage of column-major arrays is transposed, so swap radius */
+    const size_t storeRadiusX = static_cast<size_t>(Layout::IS_ROW_MAJOR ? radiusX : radiusY);
+    const size_t storeRadiusY = static_cast<size_t>(Layout::IS_ROW_MAJOR ? radiusY : radiusX);
+
+    const size_t storeRows = Layout::IS_ROW_MAJOR ? src.getRows() : src.getCols();
+    const size_t storeCols = Layout::IS_ROW_MAJOR ? src.getCols() : src.getRows();
+
+    /* Neutral element is used as constant border, so outside elements are ignored */
+    if(isMin){
+        const OpMin<A> opX = {2 * storeRadiusX + 1, storeRadiusX};
+        const OpMin<A> opY = {2 * storeRadiusY + 1, storeRadiusY};
+        return separableStorage(src.data(), dst.data(), storeRows, storeCols, opX, opY, border, opX.init(), opX.init(), pool);
+    }
+
+    const OpMax<A> opX = {2 * storeRadiusX + 1, storeRadiusX};
+    const OpMax<A> opY = {2 * storeRadiusY + 1, storeRadiusY};
+    return separableStorage(src.data(), dst.data(), storeRows, storeCols, opX, opY, border, opX.init(), opX.init(), pool);
+}
+
+/*!
+ * \brief Apply correlation kernel to a row-major storage
+ * \details
+ * Rows are processed by bands across threads. Each band keeps
+ * a ring of padded source rows (each source row is padded once) and
+ * accumulates by tiles of tbq::Array2DFilter::TILE_COLS columns, so
+ * accumulators stay in cache for all kernel coefficients.
+ *
+ * \param[in] src
+ * Source storage.
+ * \param[out] dst
+ * Destination storage.
+ * \param[in] nbRows
+ * Number of rows of storage.
+ * \param[in] nbCols
+ * Number of columns of storage.
+ * \param[in] kernel
+ * Correlation weights.
+ * \param[in] border
+ * Mode used to extrapolate elements outside of \c src.
+ * \param[in] borderValue
+ * Value used when \c border is tbq::Array2DFilter::BORDER_CONSTANT.
+ * \param[in] pool
+ * Thread pool to use.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if buffers of a band can't be
+ * allocated, \c dst is then incomplete.
+ */
+template<typename T, typename U, typename A>
+bool Array2DFilter::correlateStorage(const T *src, U *dst, size_t nbRows, size_t nbCols, const Array2D<double> &kernel, BorderMode border, A borderValue, QThreadPool *pool)
+{
+    const size_t kRows = kernel.getRows();
+    const size_t kCols = kernel.getCols();
+    const size_t anchorY = (kRows - 1) / 2;
+    const size_t anchorX = (kCols - 1) / 2;
+    const size_t paddedCols = nbCols + kCols - 1;
+
+    QVector<A> weights(static_cast<int>(kRows * kCols));
+    std::copy(kernel.data(), kernel.data() + kernel.getSize(), weights.begin());
+
+    std::atomic<bool> failed(false);
+    parallelForRows(nbRows, nbCols * kRows * kCols, [&](size_t rowBegin, size_t rowEnd){
+        Array2DStorage<A> ring;
+        Array2DStorage<A> acc;
+        if(!ring.resize(kRows * paddedCols) || !acc.resize(TILE_COLS)){
+            failed.store(true, std::memory_order_relaxed);
+            return;
+        }
+
+        /* Fill padded source row at its ring slot */
+        auto loadRow = [&](qint64 logicalRow){
+            const size_t slot = static_cast<size_t>(((logicalRow % static_cast<qint64>(kRows)) + static_cast<qint64>(kRows)) % static_cast<qint64>(kRows));
+            A *out = ring.data() + slot * paddedCols;
+
+            const qint64 srcRow = borderIndex(logicalRow, static_cast<qint64>(nbRows), border);
+            if(srcRow < 0){
+                std::fill(out, out + paddedCols, borderValue);
+            }else{
+                padRow(src + static_cast<size_t>(srcRow) * nbCols, nbCols, anchorX, kCols - 1 - anchorX, border, borderValue, out);
+            }
+        };
+
+        const qint64 firstLogical = static_cast<qint64>(rowBegin) - static_cast<qint64>(anchorY);
+        for(size_t ky = 0; ky + 1 < kRows; ++ky){
+            loadRow(firstLogical + static_cast<qint64>(ky));
+        }
+
+        for(size_t row = rowBegin; row < rowEnd; ++row){
+            const qint64 rowLogical = static_cast<qint64>(row) - static_cast<qint64>(anchorY);
+            loadRow(rowLogical + static_cast<qint64>(kRows) - 1);
+
+            for(size_t colTile = 0; colTile < nbCols; colTile += TILE_COLS){
+                const size_t tileSize = qMin(TILE_COLS, nbCols - colTile);
+                A *accData = acc.data();
+                std::fill(accData, accData + tileSize, A(0));
+
+                for(size_t ky = 0; ky < kRows; ++ky){
+                    const qint64 logical = rowLogical + static_cast<qint64>(ky);
+                    const size_t slot = static_cast<size_t>(((logical % static_cast<qint64>(kRows)) + static_cast<qint64>(kRows)) % static_cast<qint64>(kRows));
+                    const A *padded = ring.data() + slot * paddedCols + colTile;
+
+                    for(size_t kx = 0; kx < kCols; ++kx){
+                        const A weight = weights[static_cast<int>(ky * kCols + kx)];
+                        const A *in = padded + kx;
+                        for(size_t x = 0; x < tileSize; ++x){
+                            accData[x] += weight * in[x];
+                        }
+                    }
+                }
+
+                U *out = dst + row * nbCols + colTile;
+                for(size_t x = 0; x < tileSize; ++x){
+                    out[x] = castResult<U>(accData[x], std::is_integral<U>());
+                }
+            }
+        }
+    }, pool);
+
+    return !failed.load(std::memory_order_relaxed);
+}
+
+/*!
+ * \brief Apply separable operation to a row-major storage
+ * \details
+ * Horizontal pass writes an intermediate storage, then vertical
+ * pass reads it by tiles of tbq::Array2DFilter::TILE_COLS
+ * columns. Both passes are processed by bands across threads.
+ *
+ * \param[in] src
+ * Source storage.
+ * \param[out] dst
+ * Destination storage.
+ * \param[in] nbRows
+ * Number of rows of storage.
+ * \param[in] nbCols
+ * Number of columns of storage.
+ * \param[in] opX
+ * Operation applied along rows.
+ * \param[in] opY
+ * Operation applied along columns.
+ * \param[in] border
+ * Mode used to extrapolate elements outside of \c src.
+ * \param[in] borderValueX
+ * Value of elements outside of \c src used by horizontal pass
+ * when \c border is tbq::Array2DFilter::BORDER_CONSTANT.
+ * \param[in] borderValueY
+ * Value of rows outside of \c src after horizontal pass, used by vertical
+ * pass when \c border is tbq::Array2DFilter::BORDER_CONSTANT.
+ * \param[in] pool
+ * Thread pool to use.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if intermediate storage or buffers
+ * of a band can't be allocated, \c dst is then incomplete.
+ */
+template<typename T, typename U, typename A, typename OpX, typename OpY>
+bool Array2DFilter::separableStorage(const T *src, U *dst, size_t nbRows, size_t nbCols, const OpX &opX, const OpY &opY, BorderMode border, A borderValueX, A borderValueY, QThreadPool *pool)
+{
+    Array2DStorage<A> tmp;
+    Array2DStorage<A> constRow;
+    if(!tmp.resize(nbRows * nbCols) || !constRow.resize(nbCols)){
+        return false;
+    }
+    std::fill(constRow.data(), constRow.data() + nbCols, borderValueY);
+
+    /* Horizontal pass */
+    std::atomic<bool> failed(false);
+    const size_t paddedCols = nbCols + opX.size - 1;
+    parallelForRows(nbRows, nbCols * opX.size, [&](size_t rowBegin, size_t rowEnd){
+        Array2DStorage<A> padded;
+        if(!padded.resize(paddedCols)){
+            failed.store(true, std::memory_order_relaxed);
+            return;
+        }
+
+        for(size_t row = rowBegin; row < rowEnd; ++row){
+            padRow(src + row * nbCols, nbCols, opX.anchor, opX.size - 1 - opX.anchor, border, borderValueX, padded.data());
+
+            A *out = tmp.data() + row * nbCols;
+            for(size_t colTile = 0; colTile < nbCols; colTile += TILE_COLS){
+                const size_t tileSize = qMin(TILE_COLS, nbCols - colTile);
+                A *accData = out + colTile;
+                std::fill(accData, accData + tileSize, opX.init());
+
+                for(size_t k = 0; k < opX.size; ++k){
+                    const A *in = padded.data() + colTile + k;
+                    for(size_t x = 0; x < tileSize; ++x){
+                        opX.apply(accData[x], in[x], k);
+                    }
+                }
+            }
+        }
+    }, pool);
+
+    /* Rows of intermediate storage may be missing, vertical pass would read them */
+    if(failed.load(std::memory_order_relaxed)){
+        return false;
+    }
+
+    /* Vertical pass */
+    parallelForRows(nbRows, nbCols * opY.size, [&](size_t rowBegin, size_t rowEnd){
+        Array2DStorage<A> acc;
+        if(!acc.resize(TILE_COLS)){
+            failed.store(true, std::memory_order_relaxed);
+            return;
+        }
+
+        for(size_t row = rowBegin; row < rowEnd; ++row){
+            for(size_t colTile = 0; colTile < nbCols; colTile += TILE_COLS){
+                const size_t tileSize = qMin(TILE_COLS, nbCols - colTile);
+                A *accData = acc.data();
+                std::fill(accData, accData + tileSize, opY.init());
+
+                for(size_t k = 0; k < opY.size; ++k){
+                    const qint64 srcRow = borderIndex(static_cast<qint64>(row + k) - static_cast<qint64>(opY.anchor), static_cast<qint64>(nbRows), border);
+                    const A *in = (srcRow < 0 ? constRow.data() : tmp.data() + static_cast<size_t>(srcRow) * nbCols) + colTile;
+                    for(size_t x = 0; x < tileSize; ++x){
+                        opY.apply(accData[x], in[x], k);
+                    }
+                }
+
+                U *out = dst + row * nbCols + colTile;
+                for(size_t x = 0; x < tileSize; ++x){
+                    out[x] = castResult<U>(accData[x], std::is_integral<U>());
+                }
+            }
+        }
+    }, pool);
+
+    return !failed.load(std::memory_order_relaxed);
+}
+
+/*!
+ * \brief Copy a row with extrapolated elements on
+ * each side
+ *
+ * \param[in] row
+ * Row to copy.
+ * \param[in] size
+ * Number of elements of row.
+ * \param[in] padBefore
+ * Number of elements to extrapolate before row.
+ * \param[in] padAfter
+ * Number of elements to extrapolate after row.
+ * \param[in] border
+ * Mode used to extrapolate elements.
+ * \param[in] borderValue
+ * Value used when \c border is tbq::Array2DFilter::BORDER_CONSTANT.
+ * \param[out] out
+ * Padded row, must contain <tt>padBefore + size + padAfter</tt>
+ * elements.
+ */
+template<typename T, typename A>
+void Array2DFilter::padRow(const T *row, size_t size, size_t padBefore, size_t padAfter, BorderMode border, A borderValue, A *out)
+{
+    for(size_t i = 0; i < size; ++i){
+        out[padBefore + i] = static_cast<A>(row[i]);
+    }
+
+    const qint64 sizeRow = static_cast<qint64>(size);
+    for(size_t i = 0; i < padBefore; ++i){
+        const qint64 index = borderIndex(static_cast<qint64>(i) - static_cast<qint64>(padBefore), sizeRow, border);
+        out[i] = index < 0 ? borderValue : static_cast<A>(row[index]);
+    }
+    for(size_t i = 0; i < padAfter; ++i){
+        const qint64 index = borderIndex(sizeRow + static_cast<qint64>(i), sizeRow, border);
+        out[padBefore + size + i] = index < 0 ? borderValue : static_cast<A>(row[index]);
+    }
+}
+
+/*!
+ * \brief Convert accumulated value to an integer
+ * element, rounding to nearest and saturating
+ *
+ * \param[in] value
+ * Value to convert.
+ * \param[in] isIntegral
+ * Tag used to select implementation.
+ *
+ * \return
+ * Returns converted value
+ */
+template<typename U, typename A>
+U Array2DFilter::castResult(A value, std::true_type isIntegral)
+{
+    Q_UNUSED(isIntegral)
+
+    const A rounded = std::floor(value + A(0.5));
+    if(!(rounded > static_cast<A>(std::numeric_limits<U>::lowest()))){
+        return std::numeric_limits<U>::lowest();
+    }
+    if(rounded >= static_cast<A>(std::numeric_limits<U>::max())){
+        return std::numeric_limits<U>::max();
+    }
+
+    return static_cast<U>(rounded);
+}
+
+/*!
+ * \brief Convert accumulated value to a floating-point
+ * element
+ *
+ * \param[in] value
+ * Value to convert.
+ * \param[in] isIntegral
+ * Tag used to select implementation.
+ *
+ * \return
+ * Returns converted value
+ */
+template<typename U, typename A>
+U Array2DFilter::castResult(A value, std::false_type isIntegral)
+{
+    Q_UNUSED(isIntegral)
+    return static_cast<U>(value);
+}
+
+/*!
+ * \brief Use to know if two arrays are the same object
+ *
+ * \param[in] src
+ * First array.
+ * \param[in] dst
+ * Second array.
+ *
+ * \return
+ * Returns \c true if both arrays are the same object
+ */
+template<typename T, typename U, typename Layout, typename Allocator, typename OutAllocator>
+bool Array2DFilter::isSameArray(const Array2D<T, Layout, Allocator> &src, const Array2D<U, Layout, OutAllocator> &dst)
+{
+    return static_cast<const void*>(&src) == static_cast<const void*>(&dst);
+}
+
+} // namespace tbq
+
+#endif // TBQ_CONTAINER_ARRAY2DFILTER_H
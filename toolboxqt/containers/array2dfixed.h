@@ -0,0 +1,356 @@
+#ifndef TBQ_CONTAINER_ARRAY2DFIXED_H
+#define TBQ_CONTAINER_ARRAY2DFIXED_H
+
+#include "toolboxqt/toolboxqt_global.h"
+#include "toolboxqt/containers/array2d.h"
+#include "toolboxqt/containers/array2dview.h"
+
+#include <array>
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/* Define template interface */
+/*****************************/
+
+/*!
+ * \class Array2DFixed
+ * \brief Use to manage a 2-dimensional array whose
+ * size is known at compile-time
+ * \details
+ * Elements are stored inline (no heap allocation) in row-major
+ * order, so indexing is resolved to constant offsets when indexes
+ * are known at compile-time. This class is suited for small
+ * matrices like convolution kernels or transforms and can be used
+ * in \c constexpr contexts:
+ * \code{.cpp}
+ * constexpr tbq::Array2DFixed<int, 3, 3> sobelX = {
+ *     -1, 0, 1,
+ *     -2, 0, 2,
+ *     -1, 0, 1
+ * };
+ * static_assert(sobelX(1, 2) == 2, "Invalid kernel");
+ * \endcode
+ *
+ * \note
+ * With C++11, only construction from elements and constant
+ * accessors are \c constexpr. Other methods (fill(), insert(),
+ * transposed(), comparison, etc...) are \c constexpr since C++14.
+ */
+template <typename T, size_t Rows, size_t Cols>
+class Array2DFixed
+{
+    static_assert(Rows * Cols > 0, "Array2DFixed must contain at least one element");
+
+public:
+    constexpr explicit Array2DFixed();
+    Q_DECL_RELAXED_CONSTEXPR explicit Array2DFixed(const std::array<T, Rows * Cols> &data);
+
+    template<typename... Args>
+    constexpr Array2DFixed(const T &first, const Args&... others);
+
+public:
+    static constexpr size_t getRows() { return Rows; }
+    static constexpr size_t getCols() { return Cols; }
+    static constexpr size_t getSize() { return Rows * Cols; }
+
+public:
+    Q_DECL_RELAXED_CONSTEXPR void fill(const T &value);
+    Q_DECL_RELAXED_CONSTEXPR void insert(size_t row, size_t col, const T &value);
+
+    Q_DECL_RELAXED_CONSTEXPR Array2DFixed<T, Cols, Rows> transposed() const;
+
+    Array2D<T> toArray2D() const;
+
+public:
+    T* data();
+    const T* data() const;
+
+    Array2DLineView<T> rowView(size_t row);
+    Array2DLineView<const T> rowView(size_t row) const;
+
+    Array2DLineView<T> colView(size_t col);
+    Array2DLineView<const T> colView(size_t col) const;
+
+    Array2DView<T> view();
+    Array2DView<const T> view() const;
+
+public:
+    Q_DECL_RELAXED_CONSTEXPR T& operator()(size_t row, size_t col);
+    constexpr const T& operator()(size_t row, size_t col) const;
+
+public: // Friends operator defined using "Making new friends" idiom (https://en.wikibooks.org/wiki/More_C%2B%2B_Idioms/Making_New_Friends)
+    friend Q_DECL_RELAXED_CONSTEXPR bool operator==(const Array2DFixed &left, const Array2DFixed &right)
+    {
+        for(size_t i = 0; i < Rows * Cols; ++i){
+            if(!(left.m_data[i] == right.m_data[i])){
+                return false;
+            }
+        }
+        return true;
+    }
+
+    friend Q_DECL_RELAXED_CONSTEXPR bool operator!=(const Array2DFixed &left, const Array2DFixed &right)
+    {
+        return !(left == right);
+    }
+
+private:
+    T m_data[Rows * Cols];
+};
+
+/*****************************/
+/* Define template
+ *      implementation       */
+/*****************************/
+
+/*!
+ * \brief Construct a 2D array with value-initialized
+ * elements (\c 0 for arithmetic types)
+ */
+template<typename T, size_t Rows, size_t Cols>
+constexpr Array2DFixed<T, Rows, Cols>::Array2DFixed()
+    : m_data()
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Construct a 2D array from row-major elements
+ *
+ * \param[in] data
+ * Elements to use, in row-major order.
+ */
+template<typename T, size_t Rows, size_t Cols>
+Q_DECL_RELAXED_CONSTEXPR Array2DFixed<T, Rows, Cols>::Array2DFixed(const std::array<T, Rows * Cols> &data)
+    : m_data()
+{
+    for(size_t i = 0; i < Rows * Cols; ++i){
+        m_data[i] = data[i];
+    }
+}
+
+/*!
+ * \brief Construct a 2D array from row-major elements
+ *
+ * \param[in] first
+ * First element.
+ * \param[in] others
+ * Other elements, in row-major order. \n
+ * Exactly <tt>Rows * Cols</tt> elements must be provided.
+ */
+template<typename T, size_t Rows, size_t Cols>
+template<typename... Args>
+constexpr Array2DFixed<T, Rows, Cols>::Array2DFixed(const T &first, const Args&... others)
+    : m_data{first, static_cast<T>(others)...}
+{
+    static_assert(sizeof...(Args) + 1 == Rows * Cols, "Number of elements must match size of the array");
+}
+
+/*!
+ * \brief Set all elements to a value
+ *
+ * \param[in] value
+ * Value to use
+ */
+template<typename T, size_t Rows, size_t Cols>
+Q_DECL_RELAXED_CONSTEXPR void Array2DFixed<T, Rows, Cols>::fill(const T &value)
+{
+    for(size_t i = 0; i < Rows * Cols; ++i){
+        m_data[i] = value;
+    }
+}
+
+/*!
+ * \brief Use to insert a value at specified
+ * indexes.
+ *
+ * \param[in] row
+ * Row index to use. \n
+ * Must be valid (i.e <tt>0 <= row < getRows()</tt>).
+ * \param[in] col
+ * Column index to use. \n
+ * Must be valid (i.e <tt>0 <= col < getCols()</tt>).
+ * \param[in] value
+ * Value to insert
+ */
+template<typename T, size_t Rows, size_t Cols>
+Q_DECL_RELAXED_CONSTEXPR void Array2DFixed<T, Rows, Cols>::insert(size_t row, size_t col, const T &value)
+{
+    (*this)(row, col) = value;
+}
+
+/*!
+ * \brief Get transposed copy of the 2D array
+ *
+ * \return
+ * Returns array where element <tt>(col, row)</tt> is
+ * element <tt>(row, col)</tt> of this array.
+ */
+template<typename T, size_t Rows, size_t Cols>
+Q_DECL_RELAXED_CONSTEXPR Array2DFixed<T, Cols, Rows> Array2DFixed<T, Rows, Cols>::transposed() const
+{
+    Array2DFixed<T, Cols, Rows> result;
+    for(size_t row = 0; row < Rows; ++row){
+        for(size_t col = 0; col < Cols; ++col){
+            result(col, row) = (*this)(row, col);
+        }
+    }
+
+    return result;
+}
+
+/*!
+ * \brief Copy elements into a dynamically sized
+ * 2D array
+ *
+ * \return
+ * Returns copy of the array
+ */
+template<typename T, size_t Rows, size_t Cols>
+Array2D<T> Array2DFixed<T, Rows, Cols>::toArray2D() const
+{
+    Array2D<T> array(Rows, Cols);
+    std::copy(m_data, m_data + Rows * Cols, array.data());
+
+    return array;
+}
+
+/*!
+ * \brief Get pointer to row-major elements
+ *
+ * \return
+ * Returns pointer to first element
+ */
+template<typename T, size_t Rows, size_t Cols>
+T* Array2DFixed<T, Rows, Cols>::data()
+{
+    return m_data;
+}
+
+/*!
+ * \overload
+ */
+template<typename T, size_t Rows, size_t Cols>
+const T* Array2DFixed<T, Rows, Cols>::data() const
+{
+    return m_data;
+}
+
+/*!
+ * \brief Get view of a row, no copy is performed
+ *
+ * \param[in] row
+ * Row index to use. \n
+ * Must be valid (i.e <tt>0 <= row < getRows()</tt>).
+ *
+ * \return
+ * Returns contiguous line view of the row
+ */
+template<typename T, size_t Rows, size_t Cols>
+Array2DLineView<T> Array2DFixed<T, Rows, Cols>::rowView(size_t row)
+{
+    return view().rowView(row);
+}
+
+/*!
+ * \overload
+ */
+template<typename T, size_t Rows, size_t Cols>
+Array2DLineView<const T> Array2DFixed<T, Rows, Cols>::rowView(size_t row) const
+{
+    return view().rowView(row);
+}
+
+/*!
+ * \brief Get view of a column, no copy is performed
+ *
+ * \param[in] col
+ * Column index to use. \n
+ * Must be valid (i.e <tt>0 <= col < getCols()</tt>).
+ *
+ * \return
+ * Returns strided line view of the column
+ */
+template<typename T, size_t Rows, size_t Cols>
+Array2DLineView<T> Array2DFixed<T, Rows, Cols>::colView(size_t col)
+{
+    return view().colView(col);
+}
+
+/*!
+ * \overload
+ */
+template<typename T, size_t Rows, size_t Cols>
+Array2DLineView<const T> Array2DFixed<T, Rows, Cols>::colView(size_t col) const
+{
+    return view().colView(col);
+}
+
+/*!
+ * \brief Get view of the whole array, no copy is performed
+ *
+ * \return
+ * Returns view of the array
+ */
+template<typename T, size_t Rows, size_t Cols>
+Array2DView<T> Array2DFixed<T, Rows, Cols>::view()
+{
+    return Array2DView<T>(data(), Rows, Cols, Cols);
+}
+
+/*!
+ * \overload
+ */
+template<typename T, size_t Rows, size_t Cols>
+Array2DView<const T> Array2DFixed<T, Rows, Cols>::view() const
+{
+    return Array2DView<const T>(data(), Rows, Cols, Cols);
+}
+
+/*!
+ * \brief Get modifiable reference to an element
+ *
+ * \param[in] row
+ * Row index to use. \n
+ * Must be valid (i.e <tt>0 <= row < getRows()</tt>).
+ * \param[in] col
+ * Column index to use. \n
+ * Must be valid (i.e <tt>0 <= col < getCols()</tt>).
+ *
+ * \return
+ * Returns modifiable reference to an element
+ */
+template<typename T, size_t Rows, size_t Cols>
+Q_DECL_RELAXED_CONSTEXPR T& Array2DFixed<T, Rows, Cols>::operator()(size_t row, size_t col)
+{
+    return m_data[row * Cols + col];
+}
+
+/*!
+ * \brief Get constant reference to an element
+ *
+ * \param[in] row
+ * Row index to use. \n
+ * Must be valid (i.e <tt>0 <= row < getRows()</tt>).
+ * \param[in] col
+ * Column index to use. \n
+ * Must be valid (i.e <tt>0 <= col < getCols()</tt>).
+ *
+ * \return
+ * Returns constant reference to an element
+ */
+template<typename T, size_t Rows, size_t Cols>
+constexpr const T& Array2DFixed<T, Rows, Cols>::operator()(size_t row, size_t col) const
+{
+    return m_data[row * Cols + col];
+}
+
+} // namespace tbq
+
+#endif // TBQ_CONTAINER_ARRAY2DFIXED_H
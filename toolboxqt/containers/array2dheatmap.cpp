@@ -0,0 +1,447 @@
+#include "array2dheatmap.h"
+
+#include "toolboxqt/containers/array2dnumeric.h"
+
+#include <limits>
+
+/*****************************/
+/* Class documentations      */
+/*****************************/
+
+/*!
+ * \class tbq::Array2DHeatmap
+ * \brief Render numeric 2-dimensional arrays to images
+ * through a colormap
+ * \details
+ * Include with:
+ * \code{.cpp}
+ * #include "toolboxqt/containers/array2dheatmap.h"
+ * \endcode
+ *
+ * Each element is mapped to a color of a precomputed lookup
+ * table (LUT): values of range <tt>[min, max]</tt> (see setRange())
+ * are spread over the table, values outside of range are clamped
+ * to first or last color. Supported element types are \c quint8,
+ * \c quint16, \c qint32, \c float and \c double.
+ *
+ * Rendered image uses format \c QImage::Format_RGB32 and is
+ * reused between renders, so no allocation occurs while array
+ * size doesn't change. Image can directly be displayed with
+ * tbq::LabelScl:
+ * \code{.cpp}
+ * tbq::Array2DHeatmap heatmap(tbq::Array2DHeatmap::COLORMAP_INFERNO);
+ * heatmap.setRange(0.0, 1.0);
+ *
+ * // On each new frame
+ * label->setImg(heatmap.render(frame));
+ * \endcode
+ *
+ * Rows are processed across threads (see tbq::parallelForRows()), and
+ * written directly to image scanlines. For \c quint8 and \c quint16
+ * elements, a color is precomputed for each possible value, so
+ * rendering is a single lookup per element. For other types, value
+ * to index conversion is vectorized (with runtime selection of AVX2
+ * instructions, see tbq::Array2DNumeric::getSimdLevel()).
+ *
+ * \note
+ * \c NaN values are rendered with first color of LUT. \n
+ * An instance must not be used concurrently from multiple threads.
+ */
+
+/*****************************/
+/*      Custom types
+ *     documentations        */
+/*****************************/
+
+/*!
+ * \enum tbq::Array2DHeatmap::Colormap
+ * \brief List of predefined colormaps
+ *
+ * \var tbq::Array2DHeatmap::COLORMAP_GRAY
+ * Black to white.
+ *
+ * \var tbq::Array2DHeatmap::COLORMAP_VIRIDIS
+ * Perceptually uniform, dark blue to yellow.
+ *
+ * \var tbq::Array2DHeatmap::COLORMAP_INFERNO
+ * Perceptually uniform, black to light yellow
+ * through purple and orange.
+ *
+ * \var tbq::Array2DHeatmap::COLORMAP_JET
+ * Rainbow, dark blue to dark red.
+ */
+
+/*****************************/
+/* Macro definitions         */
+/*****************************/
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#   define TBQ_HEATMAP_DISPATCH_X86 1
+#   define TBQ_HEATMAP_INLINE       inline __attribute__((always_inline))
+#   define TBQ_HEATMAP_TARGET_AVX2  __attribute__((target("avx2")))
+#else
+#   define TBQ_HEATMAP_DISPATCH_X86 0
+#   define TBQ_HEATMAP_INLINE       inline
+#endif
+
+#if TBQ_HEATMAP_DISPATCH_X86
+#   define TBQ_HEATMAP_DISPATCH(kernel, ...) (isAvx2Available() ? kernel##Avx2(__VA_ARGS__) : kernel(__VA_ARGS__))
+#else
+#   define TBQ_HEATMAP_DISPATCH(kernel, ...) kernel(__VA_ARGS__)
+#endif
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/* Constants definitions     */
+/*****************************/
+
+constexpr int Array2DHeatmap::LUT_SIZE_DEFAULT;
+
+/* Colormaps are defined by evenly spaced stops, interpolated linearly */
+static const int COLORMAP_NB_STOPS = 9;
+
+static const QRgb COLORMAP_STOPS_VIRIDIS[COLORMAP_NB_STOPS] = {
+    0x440154, 0x472d7b, 0x3b528b, 0x2c728e, 0x21918c, 0x28ae80, 0x5ec962, 0xaddc30, 0xfde725
+};
+
+static const QRgb COLORMAP_STOPS_INFERNO[COLORMAP_NB_STOPS] = {
+    0x000004, 0x1b0c41, 0x4a0c6b, 0x781c6d, 0xa52c60, 0xcf4446, 0xed6925, 0xfb9b06, 0xfcffa4
+};
+
+static const QRgb COLORMAP_STOPS_JET[COLORMAP_NB_STOPS] = {
+    0x00007f, 0x0000ff, 0x007fff, 0x00ffff, 0x7fff7f, 0xffff00, 0xff7f00, 0xff0000, 0x7f0000
+};
+
+static const QRgb COLORMAP_STOPS_GRAY[COLORMAP_NB_STOPS] = {
+    0x000000, 0x202020, 0x404040, 0x606060, 0x808080, 0x9f9f9f, 0xbfbfbf, 0xdfdfdf, 0xffffff
+};
+
+/*****************************/
+/* Kernels implementation    */
+/*****************************/
+
+template<typename T>
+TBQ_HEATMAP_INLINE void kernelDirect(const T *in, size_t size, size_t step, QRgb *out, const QRgb *lut)
+{
+    if(step == 1){
+        for(size_t i = 0; i < size; ++i){
+            out[i] = lut[static_cast<size_t>(in[i])];
+        }
+    }else{
+        for(size_t i = 0; i < size; ++i){
+            out[i] = lut[static_cast<size_t>(in[i * step])];
+        }
+    }
+}
+
+template<typename T, typename Real>
+TBQ_HEATMAP_INLINE void kernelScaled(const T *in, size_t size, size_t step, QRgb *out, const QRgb *lut, Real offset, Real scale, Real maxIndex)
+{
+    /* Comparisons are written so NaN values are mapped to index 0 */
+    if(step == 1){
+        for(size_t i = 0; i < size; ++i){
+            Real index = (static_cast<Real>(in[i]) - offset) * scale;
+            index = index >= Real(0) ? index : Real(0);
+            index = index <= maxIndex ? index : maxIndex;
+            out[i] = lut[static_cast<qint32>(index)];
+        }
+    }else{
+        for(size_t i = 0; i < size; ++i){
+            Real index = (static_cast<Real>(in[i * step]) - offset) * scale;
+            index = index >= Real(0) ? index : Real(0);
+            index = index <= maxIndex ? index : maxIndex;
+            out[i] = lut[static_cast<qint32>(index)];
+        }
+    }
+}
+
+/*****************************/
+/*  Kernels dispatch (x86)   */
+/*****************************/
+
+#if TBQ_HEATMAP_DISPATCH_X86
+
+static bool isAvx2Available()
+{
+    static const bool available = Array2DNumeric::getSimdLevel() == Array2DNumeric::SIMD_AVX2;
+    return available;
+}
+
+template<typename T>
+TBQ_HEATMAP_TARGET_AVX2 void kernelDirectAvx2(const T *in, size_t size, size_t step, QRgb *out, const QRgb *lut)
+{
+    kernelDirect(in, size, step, out, lut);
+}
+
+template<typename T, typename Real>
+TBQ_HEATMAP_TARGET_AVX2 void kernelScaledAvx2(const T *in, size_t size, size_t step, QRgb *out, const QRgb *lut, Real offset, Real scale, Real maxIndex)
+{
+    kernelScaled(in, size, step, out, lut, offset, scale, maxIndex);
+}
+
+#endif
+
+/*****************************/
+/* Functions implementation  */
+/*         Class             */
+/*****************************/
+
+/*!
+ * \brief Construct a heatmap renderer
+ * \details
+ * Default range is <tt>[0, 1]</tt>.
+ *
+ * \param[in] colormap
+ * Colormap to use.
+ * \param[in] lutSize
+ * Number of colors of LUT.
+ *
+ * \sa setColormap(), setRange()
+ */
+Array2DHeatmap::Array2DHeatmap(Colormap colormap, int lutSize)
+    : m_lut(buildLut(colormap, lutSize)), m_min(0.0), m_max(1.0), m_directBits(0)
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Get colors lookup table
+ *
+ * \return
+ * Returns colors used from minimum to
+ * maximum of range.
+ */
+const QVector<QRgb>& Array2DHeatmap::getLut() const
+{
+    return m_lut;
+}
+
+/*!
+ * \brief Get minimum of range
+ *
+ * \return
+ * Returns value mapped to first color of LUT
+ *
+ * \sa setRange()
+ */
+double Array2DHeatmap::getRangeMin() const
+{
+    return m_min;
+}
+
+/*!
+ * \brief Get maximum of range
+ *
+ * \return
+ * Returns value mapped to last color of LUT
+ *
+ * \sa setRange()
+ */
+double Array2DHeatmap::getRangeMax() const
+{
+    return m_max;
+}
+
+/*!
+ * \brief Get internal image
+ *
+ * \return
+ * Returns image of last call to render()
+ */
+const QImage& Array2DHeatmap::getImage() const
+{
+    return m_image;
+}
+
+/*!
+ * \brief Set colormap to use
+ *
+ * \param[in] colormap
+ * Predefined colormap.
+ * \param[in] lutSize
+ * Number of colors of LUT. \n
+ * If lower than \c 2, \c 2 is used.
+ *
+ * \sa setLut()
+ */
+void Array2DHeatmap::setColormap(Colormap colormap, int lutSize)
+{
+    m_lut = buildLut(colormap, lutSize);
+    m_directBits = 0;
+}
+
+/*!
+ * \brief Set custom colors lookup table
+ * \details
+ * Alpha channel of colors is ignored.
+ *
+ * \param[in] lut
+ * Colors used from minimum to maximum of range.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if \c lut is empty.
+ *
+ * \sa setColormap()
+ */
+bool Array2DHeatmap::setLut(const QVector<QRgb> &lut)
+{
+    if(lut.isEmpty()){
+        return false;
+    }
+
+    m_lut = lut;
+    m_directBits = 0;
+
+    return true;
+}
+
+/*!
+ * \brief Set range of values mapped to LUT
+ * \details
+ * Values lower or equal to \c min use first color,
+ * values greater or equal to \c max use last one. \n
+ * If \c max is not greater than \c min, all values use
+ * first color. \n
+ * Use tbq::Array2DNumeric::minMax() to fit range to
+ * an array.
+ *
+ * \param[in] min
+ * Value mapped to first color.
+ * \param[in] max
+ * Value mapped to last color.
+ */
+void Array2DHeatmap::setRange(double min, double max)
+{
+    m_min = min;
+    m_max = max;
+    m_directBits = 0;
+}
+
+/*!
+ * \brief Build lookup table of a predefined colormap
+ *
+ * \param[in] colormap
+ * Colormap to use.
+ * \param[in] size
+ * Number of colors. \n
+ * If lower than \c 2, \c 2 is used.
+ *
+ * \return
+ * Returns list of colors
+ */
+QVector<QRgb> Array2DHeatmap::buildLut(Colormap colormap, int size)
+{
+    const QRgb *stops = nullptr;
+    switch(colormap){
+        case COLORMAP_VIRIDIS:  stops = COLORMAP_STOPS_VIRIDIS; break;
+        case COLORMAP_INFERNO:  stops = COLORMAP_STOPS_INFERNO; break;
+        case COLORMAP_JET:      stops = COLORMAP_STOPS_JET; break;
+        case COLORMAP_GRAY:
+        default:                stops = COLORMAP_STOPS_GRAY; break;
+    }
+
+    size = qMax(size, 2);
+    QVector<QRgb> lut(size);
+
+    for(int i = 0; i < size; ++i){
+        const double pos = static_cast<double>(i) * (COLORMAP_NB_STOPS - 1) / (size - 1);
+        const int idStop = qMin(static_cast<int>(pos), COLORMAP_NB_STOPS - 2);
+        const double ratio = pos - idStop;
+
+        const QRgb first = stops[idStop];
+        const QRgb second = stops[idStop + 1];
+        lut[i] = qRgb(qRound(qRed(first) + ratio * (qRed(second) - qRed(first))),
+                      qRound(qGreen(first) + ratio * (qGreen(second) - qGreen(first))),
+                      qRound(qBlue(first) + ratio * (qBlue(second) - qBlue(first))));
+    }
+
+    return lut;
+}
+
+/*!
+ * \brief Map a row of elements to colors
+ *
+ * \param[in] in
+ * First element of row.
+ * \param[in] size
+ * Number of elements.
+ * \param[in] step
+ * Distance between two consecutive elements.
+ * \param[out] out
+ * Colors of elements.
+ * \param[in] ctx
+ * Mapping context.
+ */
+template<typename T>
+void Array2DHeatmap::renderLine(const T *in, size_t size, size_t step, QRgb *out, const LineContext &ctx)
+{
+    typedef typename std::conditional<std::is_same<T, float>::value, float, double>::type Real;
+
+    if(HasDirectLut<T>::value){
+        TBQ_HEATMAP_DISPATCH(kernelDirect, in, size, step, out, ctx.lut);
+        return;
+    }
+
+    TBQ_HEATMAP_DISPATCH(kernelScaled, in, size, step, out, ctx.lut, static_cast<Real>(ctx.offset), static_cast<Real>(ctx.scale), static_cast<Real>(ctx.maxIndex));
+}
+
+/*!
+ * \brief Prepare an image to render an array
+ *
+ * \param[in, out] image
+ * Image to prepare, reallocated if its size or
+ * format doesn't match.
+ * \param[in] nbRows
+ * Number of rows of array.
+ * \param[in] nbCols
+ * Number of columns of array.
+ *
+ * \return
+ * Returns \c true if image is ready.
+ */
+bool Array2DHeatmap::prepareImage(QImage &image, size_t nbRows, size_t nbCols)
+{
+    if(nbRows == 0 || nbCols == 0){
+        return false;
+    }
+
+    const size_t maxDim = static_cast<size_t>(std::numeric_limits<int>::max());
+    if(nbRows > maxDim || nbCols > maxDim){
+        return false;
+    }
+
+    const int width = static_cast<int>(nbCols);
+    const int height = static_cast<int>(nbRows);
+    if(image.width() != width || image.height() != height || image.format() != QImage::Format_RGB32){
+        image = QImage(width, height, QImage::Format_RGB32);
+    }
+
+    return !image.isNull();
+}
+
+/*****************************/
+/* Explicit instantiations   */
+/*****************************/
+
+template void Array2DHeatmap::renderLine<quint8>(const quint8*, size_t, size_t, QRgb*, const LineContext&);
+template void Array2DHeatmap::renderLine<quint16>(const quint16*, size_t, size_t, QRgb*, const LineContext&);
+template void Array2DHeatmap::renderLine<qint32>(const qint32*, size_t, size_t, QRgb*, const LineContext&);
+template void Array2DHeatmap::renderLine<float>(const float*, size_t, size_t, QRgb*, const LineContext&);
+template void Array2DHeatmap::renderLine<double>(const double*, size_t, size_t, QRgb*, const LineContext&);
+
+/*****************************/
+/* End namespace             */
+/*****************************/
+
+} // namespace tbq
+
+/*****************************/
+/* End file                  */
+/*****************************/
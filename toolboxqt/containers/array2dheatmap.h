@@ -0,0 +1,251 @@
+#ifndef TBQ_CONTAINER_ARRAY2DHEATMAP_H
+#define TBQ_CONTAINER_ARRAY2DHEATMAP_H
+
+#include "toolboxqt/toolboxqt_global.h"
+#include "toolboxqt/containers/array2d.h"
+#include "toolboxqt/containers/array2dalgorithms.h"
+
+#include <QImage>
+#include <QRgb>
+#include <QThreadPool>
+#include <QVector>
+
+#include <type_traits>
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/*     Class definitions     */
+/*      Array2DHeatmap       */
+/*****************************/
+
+class TOOLBOXQT_EXPORT Array2DHeatmap
+{
+
+public:
+    enum Colormap
+    {
+        COLORMAP_GRAY = 0,
+        COLORMAP_VIRIDIS,
+        COLORMAP_INFERNO,
+        COLORMAP_JET
+    };
+
+public:
+    static constexpr int LUT_SIZE_DEFAULT = 1024;
+
+public:
+    explicit Array2DHeatmap(Colormap colormap = COLORMAP_VIRIDIS, int lutSize = LUT_SIZE_DEFAULT);
+
+public:
+    const QVector<QRgb>& getLut() const;
+    double getRangeMin() const;
+    double getRangeMax() const;
+
+    const QImage& getImage() const;
+
+public:
+    void setColormap(Colormap colormap, int lutSize = LUT_SIZE_DEFAULT);
+    bool setLut(const QVector<QRgb> &lut);
+    void setRange(double min, double max);
+
+public:
+    template<typename T, typename Layout, typename Allocator>
+    const QImage& render(const Array2D<T, Layout, Allocator> &array, QThreadPool *pool = nullptr);
+
+    template<typename T, typename Layout, typename Allocator>
+    bool render(const Array2D<T, Layout, Allocator> &array, QImage &image, QThreadPool *pool = nullptr);
+
+public:
+    static QVector<QRgb> buildLut(Colormap colormap, int size = LUT_SIZE_DEFAULT);
+
+private:
+    template<typename T>
+    using IsSupported = std::integral_constant<bool,
+        std::is_same<T, quint8>::value || std::is_same<T, quint16>::value || std::is_same<T, qint32>::value ||
+        std::is_same<T, float>::value || std::is_same<T, double>::value>;
+
+    template<typename T>
+    using HasDirectLut = std::integral_constant<bool, std::is_integral<T>::value && sizeof(T) <= 2>;
+
+    struct LineContext
+    {
+        const QRgb *lut;
+        double offset;
+        double scale;
+        double maxIndex;
+    };
+
+private:
+    template<typename T>
+    static void renderLine(const T *in, size_t size, size_t step, QRgb *out, const LineContext &ctx);
+
+    template<typename T>
+    LineContext prepareContext(std::true_type hasDirectLut);
+    template<typename T>
+    LineContext prepareContext(std::false_type hasDirectLut);
+
+    static bool prepareImage(QImage &image, size_t nbRows, size_t nbCols);
+
+private:
+    QVector<QRgb> m_lut;
+    double m_min;
+    double m_max;
+
+    QVector<QRgb> m_directLut;
+    int m_directBits;
+
+    QImage m_image;
+};
+
+/*****************************/
+/*   Template definitions    */
+/*****************************/
+
+/*!
+ * \brief Render a 2D array to internal image
+ * \details
+ * Internal image is reused between calls, and only
+ * reallocated when array size changes.
+ *
+ * \param[in] array
+ * Array to render.
+ * \param[in] pool
+ * Thread pool to use, if \c nullptr, \c QThreadPool::globalInstance()
+ * will be used.
+ *
+ * \return
+ * Returns rendered image. \n
+ * Returns null image if array is empty or too large
+ * for a \c QImage, or if image can't be allocated.
+ *
+ * \sa getImage()
+ */
+template<typename T, typename Layout, typename Allocator>
+const QImage& Array2DHeatmap::render(const Array2D<T, Layout, Allocator> &array, QThreadPool *pool)
+{
+    if(!render(array, m_image, pool)){
+        m_image = QImage();
+    }
+
+    return m_image;
+}
+
+/*!
+ * \brief Render a 2D array to an image
+ * \details
+ * Element at position <tt>(row, col)</tt> is rendered to
+ * pixel <tt>(x = col, y = row)</tt>. Rows are processed across
+ * threads and written directly to image scanlines.
+ *
+ * \param[in] array
+ * Array to render.
+ * \param[in, out] image
+ * Image to write. \n
+ * It is reused if its size matches array size and its format
+ * is \c QImage::Format_RGB32, otherwise it is reallocated.
+ * \param[in] pool
+ * Thread pool to use, if \c nullptr, \c QThreadPool::globalInstance()
+ * will be used.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if array is empty or too large for a \c QImage,
+ * or if image can't be allocated.
+ */
+template<typename T, typename Layout, typename Allocator>
+bool Array2DHeatmap::render(const Array2D<T, Layout, Allocator> &array, QImage &image, QThreadPool *pool)
+{
+    static_assert(IsSupported<T>::value, "Array2DHeatmap supports quint8, quint16, qint32, float and double elements");
+
+    const size_t nbRows = array.getRows();
+    const size_t nbCols = array.getCols();
+    if(!prepareImage(image, nbRows, nbCols)){
+        return false;
+    }
+
+    const LineContext ctx = prepareContext<T>(HasDirectLut<T>());
+    const T *data = array.data();
+    const size_t step = Layout::colStride(nbRows, nbCols);
+
+    /* Detach once, so scanlines can be written concurrently */
+    uchar *bits = image.bits();
+    const size_t bytesPerLine = static_cast<size_t>(image.bytesPerLine());
+
+    parallelForRows(nbRows, nbCols, [&](size_t rowBegin, size_t rowEnd){
+        for(size_t row = rowBegin; row < rowEnd; ++row){
+            QRgb *out = reinterpret_cast<QRgb*>(bits + row * bytesPerLine);
+            renderLine(data + Layout::index(row, 0, nbRows, nbCols), nbCols, step, out, ctx);
+        }
+    }, pool);
+
+    return true;
+}
+
+/*!
+ * \brief Prepare context of integer types with
+ * a small range of values
+ * \details
+ * A table giving color of each possible value is built
+ * (and cached until LUT or range changes), so mapping
+ * is a single lookup per element.
+ *
+ * \param[in] hasDirectLut
+ * Tag used to select implementation.
+ *
+ * \return
+ * Returns context of renderLine()
+ */
+template<typename T>
+Array2DHeatmap::LineContext Array2DHeatmap::prepareContext(std::true_type hasDirectLut)
+{
+    Q_UNUSED(hasDirectLut)
+
+    const int bits = static_cast<int>(sizeof(T) * 8);
+    if(m_directBits != bits){
+        const int nbValues = 1 << bits;
+        const double scale = m_max > m_min ? (m_lut.size() - 1) / (m_max - m_min) : 0.0;
+        const double maxIndex = m_lut.size() - 1;
+
+        m_directLut.resize(nbValues);
+        for(int value = 0; value < nbValues; ++value){
+            double index = (value - m_min) * scale;
+            index = index >= 0.0 ? index : 0.0;
+            index = index <= maxIndex ? index : maxIndex;
+            m_directLut[value] = m_lut[static_cast<int>(index)];
+        }
+
+        m_directBits = bits;
+    }
+
+    const LineContext ctx = {m_directLut.constData(), 0.0, 0.0, 0.0};
+    return ctx;
+}
+
+/*!
+ * \brief Prepare context of other types
+ *
+ * \param[in] hasDirectLut
+ * Tag used to select implementation.
+ *
+ * \return
+ * Returns context of renderLine()
+ */
+template<typename T>
+Array2DHeatmap::LineContext Array2DHeatmap::prepareContext(std::false_type hasDirectLut)
+{
+    Q_UNUSED(hasDirectLut)
+
+    const double scale = m_max > m_min ? (m_lut.size() - 1) / (m_max - m_min) : 0.0;
+    const LineContext ctx = {m_lut.constData(), m_min, scale, static_cast<double>(m_lut.size() - 1)};
+    return ctx;
+}
+
+} // namespace tbq
+
+#endif // TBQ_CONTAINER_ARRAY2DHEATMAP_H
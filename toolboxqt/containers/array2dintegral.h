@@ -0,0 +1,615 @@
+#ifndef TBQ_CONTAINER_ARRAY2DINTEGRAL_H
+#define TBQ_CONTAINER_ARRAY2DINTEGRAL_H
+
+#include "toolboxqt/toolboxqt_global.h"
+#include "toolboxqt/containers/array2d.h"
+#include "toolboxqt/containers/array2dalgorithms.h"
+
+#include <QRect>
+#include <QThreadPool>
+#include <QVector>
+
+#include <algorithm>
+#include <type_traits>
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/* Define template interface */
+/*****************************/
+
+/*!
+ * \class Array2DIntegral
+ * \brief Use to compute sum of any rectangular region of
+ * a 2D array in constant time
+ * \details
+ * Array is converted to its <em>summed-area table</em> (also
+ * called <em>integral image</em>): each cell of the table contains
+ * sum of all elements above and left of it. Table is built once (rows
+ * then columns prefix sums, across threads), then sum() and mean()
+ * of a region only need four table reads, whatever its size.
+ *
+ * \code{.cpp}
+ * tbq::Array2D<quint16> grid = acquire();
+ * tbq::Array2DIntegral<quint16> integral(grid);
+ *
+ * // On each mouse move
+ * const double avg = integral.mean(selection);
+ * \endcode
+ *
+ * Single cells can also be modified with setValue() or add(): changes
+ * are kept in a pending list used by queries (cost of queries grows
+ * with number of pending changes), and applied to table in a single
+ * pass once tbq::Array2DIntegral::PENDING_MAX changes are pending, or
+ * when flush() is called.
+ *
+ * Sums are accumulated as \c qint64 for integer types and \c double
+ * for floating-point types (see tbq::Array2DIntegral::SumType).
+ */
+template <typename T>
+class Array2DIntegral
+{
+    static_assert(std::is_arithmetic<T>::value, "Array2DIntegral requires an arithmetic type");
+
+public:
+    using SumType = typename std::conditional<std::is_floating_point<T>::value, double, qint64>::type;
+
+    static constexpr int PENDING_MAX = 256;
+
+public:
+    Array2DIntegral();
+
+    template<typename Layout, typename Allocator>
+    explicit Array2DIntegral(const Array2D<T, Layout, Allocator> &array, QThreadPool *pool = nullptr);
+
+public:
+    template<typename Layout, typename Allocator>
+    bool build(const Array2D<T, Layout, Allocator> &array, QThreadPool *pool = nullptr);
+
+    void clear();
+
+public:
+    size_t getRows() const;
+    size_t getCols() const;
+    bool isEmpty() const;
+
+    int getPendingCount() const;
+
+public:
+    SumType sum(size_t row, size_t col, size_t nbRows, size_t nbCols) const;
+    SumType sum(const QRect &rect) const;
+
+    double mean(size_t row, size_t col, size_t nbRows, size_t nbCols) const;
+    double mean(const QRect &rect) const;
+
+    SumType getValue(size_t row, size_t col) const;
+
+public:
+    void add(size_t row, size_t col, SumType delta);
+    void setValue(size_t row, size_t col, SumType value);
+
+    void flush(QThreadPool *pool = nullptr);
+
+private:
+    struct Pending
+    {
+        size_t row;
+        size_t col;
+        SumType delta;
+    };
+
+private:
+    bool clip(size_t &row, size_t &col, size_t &nbRows, size_t &nbCols) const;
+    bool clip(const QRect &rect, size_t &row, size_t &col, size_t &nbRows, size_t &nbCols) const;
+
+    SumType regionSum(size_t row, size_t col, size_t nbRows, size_t nbCols) const;
+
+private:
+    size_t m_rows;
+    size_t m_cols;
+
+    Array2D<SumType> m_table;
+    QVector<Pending> m_pending;
+};
+
+/*****************************/
+/* Define template
+ *      implementation       */
+/*****************************/
+
+/*!
+ * \brief Construct an empty summed-area table
+ */
+template<typename T>
+Array2DIntegral<T>::Array2DIntegral()
+    : m_rows(0), m_cols(0)
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Construct summed-area table of a 2D array
+ * \details
+ * If table can't be allocated, object is empty.
+ *
+ * \param[in] array
+ * Array to use.
+ * \param[in] pool
+ * Thread pool to use, if \c nullptr, \c QThreadPool::globalInstance()
+ * will be used.
+ *
+ * \sa build()
+ */
+template<typename T>
+template<typename Layout, typename Allocator>
+Array2DIntegral<T>::Array2DIntegral(const Array2D<T, Layout, Allocator> &array, QThreadPool *pool)
+    : m_rows(0), m_cols(0)
+{
+    build(array, pool);
+}
+
+/*!
+ * \brief Build summed-area table of a 2D array
+ * \details
+ * Pending changes are discarded. \n
+ * Table is built in two passes across threads: prefix
+ * sums of each row, then prefix sums of each column.
+ *
+ * \param[in] array
+ * Array to use.
+ * \param[in] pool
+ * Thread pool to use, if \c nullptr, \c QThreadPool::globalInstance()
+ * will be used.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if table can't be allocated, object is then empty.
+ */
+template<typename T>
+template<typename Layout, typename Allocator>
+bool Array2DIntegral<T>::build(const Array2D<T, Layout, Allocator> &array, QThreadPool *pool)
+{
+    clear();
+
+    const size_t nbRows = array.getRows();
+    const size_t nbCols = array.getCols();
+    if(nbRows == 0 || nbCols == 0){
+        return true;
+    }
+
+    /* Table has a leading row and column of zeros, so no region needs special case */
+    if(nbCols + 1 < nbCols || nbRows + 1 < nbRows || !m_table.resize(nbRows + 1, nbCols + 1)){
+        m_table = Array2D<SumType>();
+        return false;
+    }
+
+    m_rows = nbRows;
+    m_cols = nbCols;
+
+    const size_t stride = nbCols + 1;
+    SumType *table = m_table.data();
+    std::fill(table, table + stride, SumType(0));
+
+    /* Prefix sums of rows */
+    parallelForRows(nbRows, nbCols, [&](size_t rowBegin, size_t rowEnd){
+        for(size_t row = rowBegin; row < rowEnd; ++row){
+            SumType *out = table + (row + 1) * stride;
+            SumType acc = 0;
+
+            out[0] = 0;
+            for(size_t col = 0; col < nbCols; ++col){
+                acc += static_cast<SumType>(array(row, col));
+                out[col + 1] = acc;
+            }
+        }
+    }, pool);
+
+    /* Prefix sums of columns, each task owns a range of columns */
+    parallelForRows(stride, nbRows, [&](size_t colBegin, size_t colEnd){
+        for(size_t row = 2; row <= nbRows; ++row){
+            const SumType *above = table + (row - 1) * stride;
+            SumType *out = table + row * stride;
+            for(size_t col = colBegin; col < colEnd; ++col){
+                out[col] += above[col];
+            }
+        }
+    }, pool);
+
+    return true;
+}
+
+/*!
+ * \brief Clear summed-area table
+ * \details
+ * Table is empty after this call, pending changes
+ * are discarded.
+ */
+template<typename T>
+void Array2DIntegral<T>::clear()
+{
+    m_rows = 0;
+    m_cols = 0;
+
+    m_table.clear();
+    m_pending.clear();
+}
+
+/*!
+ * \brief Get number of rows of source array
+ *
+ * \return
+ * Returns number of rows
+ */
+template<typename T>
+size_t Array2DIntegral<T>::getRows() const
+{
+    return m_rows;
+}
+
+/*!
+ * \brief Get number of columns of source array
+ *
+ * \return
+ * Returns number of columns
+ */
+template<typename T>
+size_t Array2DIntegral<T>::getCols() const
+{
+    return m_cols;
+}
+
+/*!
+ * \brief Use to know if table is empty
+ *
+ * \return
+ * Returns \c true if source array was empty or if
+ * table hasn't been built
+ */
+template<typename T>
+bool Array2DIntegral<T>::isEmpty() const
+{
+    return m_rows == 0 || m_cols == 0;
+}
+
+/*!
+ * \brief Get number of changes not applied to table yet
+ *
+ * \return
+ * Returns number of pending changes
+ *
+ * \sa flush()
+ */
+template<typename T>
+int Array2DIntegral<T>::getPendingCount() const
+{
+    return m_pending.size();
+}
+
+/*!
+ * \brief Compute sum of a rectangular region
+ * \details
+ * Region is clipped to array bounds.
+ *
+ * \param[in] row
+ * Index of first row of region.
+ * \param[in] col
+ * Index of first column of region.
+ * \param[in] nbRows
+ * Number of rows of region.
+ * \param[in] nbCols
+ * Number of columns of region.
+ *
+ * \return
+ * Returns sum of elements of region. \n
+ * Returns \c 0 if region is empty.
+ */
+template<typename T>
+typename Array2DIntegral<T>::SumType Array2DIntegral<T>::sum(size_t row, size_t col, size_t nbRows, size_t nbCols) const
+{
+    if(!clip(row, col, nbRows, nbCols)){
+        return 0;
+    }
+
+    return regionSum(row, col, nbRows, nbCols);
+}
+
+/*!
+ * \overload
+ * \details
+ * Coordinates \c x and \c y of \c rect are respectively
+ * column and row indexes.
+ */
+template<typename T>
+typename Array2DIntegral<T>::SumType Array2DIntegral<T>::sum(const QRect &rect) const
+{
+    size_t row, col, nbRows, nbCols;
+    if(!clip(rect, row, col, nbRows, nbCols)){
+        return 0;
+    }
+
+    return regionSum(row, col, nbRows, nbCols);
+}
+
+/*!
+ * \brief Compute mean of a rectangular region
+ * \details
+ * Region is clipped to array bounds, mean is computed
+ * over clipped region.
+ *
+ * \param[in] row
+ * Index of first row of region.
+ * \param[in] col
+ * Index of first column of region.
+ * \param[in] nbRows
+ * Number of rows of region.
+ * \param[in] nbCols
+ * Number of columns of region.
+ *
+ * \return
+ * Returns mean of elements of region. \n
+ * Returns \c 0 if region is empty.
+ */
+template<typename T>
+double Array2DIntegral<T>::mean(size_t row, size_t col, size_t nbRows, size_t nbCols) const
+{
+    if(!clip(row, col, nbRows, nbCols)){
+        return 0.0;
+    }
+
+    return static_cast<double>(regionSum(row, col, nbRows, nbCols)) / (static_cast<double>(nbRows) * static_cast<double>(nbCols));
+}
+
+/*!
+ * \overload
+ * \details
+ * Coordinates \c x and \c y of \c rect are respectively
+ * column and row indexes.
+ */
+template<typename T>
+double Array2DIntegral<T>::mean(const QRect &rect) const
+{
+    size_t row, col, nbRows, nbCols;
+    if(!clip(rect, row, col, nbRows, nbCols)){
+        return 0.0;
+    }
+
+    return static_cast<double>(regionSum(row, col, nbRows, nbCols)) / (static_cast<double>(nbRows) * static_cast<double>(nbCols));
+}
+
+/*!
+ * \brief Get value of an element
+ * \details
+ * Value is deduced from table, pending changes
+ * included.
+ *
+ * \param[in] row
+ * Row index of element.
+ * \param[in] col
+ * Column index of element.
+ *
+ * \return
+ * Returns value of element. \n
+ * Returns \c 0 if element is out of bounds.
+ */
+template<typename T>
+typename Array2DIntegral<T>::SumType Array2DIntegral<T>::getValue(size_t row, size_t col) const
+{
+    return sum(row, col, 1, 1);
+}
+
+/*!
+ * \brief Add a value to an element
+ * \details
+ * Change is kept as pending, table is updated
+ * once tbq::Array2DIntegral::PENDING_MAX changes
+ * are pending.
+ *
+ * \param[in] row
+ * Row index of element.
+ * \param[in] col
+ * Column index of element.
+ * \param[in] delta
+ * Value to add. \n
+ * Ignored if element is out of bounds.
+ *
+ * \sa setValue(), flush()
+ */
+template<typename T>
+void Array2DIntegral<T>::add(size_t row, size_t col, SumType delta)
+{
+    if(row >= m_rows || col >= m_cols){
+        return;
+    }
+
+    m_pending.append(Pending{row, col, delta});
+    if(m_pending.size() >= PENDING_MAX){
+        flush();
+    }
+}
+
+/*!
+ * \brief Set value of an element
+ *
+ * \param[in] row
+ * Row index of element.
+ * \param[in] col
+ * Column index of element.
+ * \param[in] value
+ * New value of element. \n
+ * Ignored if element is out of bounds.
+ *
+ * \sa add()
+ */
+template<typename T>
+void Array2DIntegral<T>::setValue(size_t row, size_t col, SumType value)
+{
+    add(row, col, value - getValue(row, col));
+}
+
+/*!
+ * \brief Apply pending changes to table
+ * \details
+ * Changes are applied in a single pass over rows
+ * below first changed row, across threads.
+ *
+ * \param[in] pool
+ * Thread pool to use, if \c nullptr, \c QThreadPool::globalInstance()
+ * will be used.
+ *
+ * \sa getPendingCount()
+ */
+template<typename T>
+void Array2DIntegral<T>::flush(QThreadPool *pool)
+{
+    if(m_pending.isEmpty()){
+        return;
+    }
+
+    std::sort(m_pending.begin(), m_pending.end(), [](const Pending &left, const Pending &right){
+        return left.row < right.row;
+    });
+
+    /* Table row "i" receives deltas of elements of rows lower than "i" */
+    const size_t stride = m_cols + 1;
+    const size_t firstRow = m_pending.first().row + 1;
+    const size_t nbRows = m_rows + 1 - firstRow;
+    SumType *table = m_table.data() + firstRow * stride;
+    const Pending *pending = m_pending.constData();
+    const int nbPending = m_pending.size();
+
+    parallelForRows(nbRows, stride, [&](size_t rowBegin, size_t rowEnd){
+        QVector<SumType> colDeltas(static_cast<int>(stride), SumType(0));
+        int idPending = 0;
+
+        for(size_t row = rowBegin; row < rowEnd; ++row){
+            const size_t tableRow = firstRow + row;
+            for(; idPending < nbPending && pending[idPending].row < tableRow; ++idPending){
+                colDeltas[static_cast<int>(pending[idPending].col + 1)] += pending[idPending].delta;
+            }
+
+            SumType *out = table + row * stride;
+            SumType acc = 0;
+            for(size_t col = 1; col < stride; ++col){
+                acc += colDeltas[static_cast<int>(col)];
+                out[col] += acc;
+            }
+        }
+    }, pool);
+
+    m_pending.clear();
+}
+
+/*!
+ * \brief Clip a region to array bounds
+ *
+ * \param[in, out] row
+ * Index of first row of region.
+ * \param[in, out] col
+ * Index of first column of region.
+ * \param[in, out] nbRows
+ * Number of rows of region.
+ * \param[in, out] nbCols
+ * Number of columns of region.
+ *
+ * \return
+ * Returns \c false if clipped region is empty.
+ */
+template<typename T>
+bool Array2DIntegral<T>::clip(size_t &row, size_t &col, size_t &nbRows, size_t &nbCols) const
+{
+    if(row >= m_rows || col >= m_cols){
+        return false;
+    }
+
+    nbRows = std::min(nbRows, m_rows - row);
+    nbCols = std::min(nbCols, m_cols - col);
+
+    return nbRows > 0 && nbCols > 0;
+}
+
+/*!
+ * \overload
+ *
+ * \param[in] rect
+ * Region to clip.
+ * \param[out] row
+ * Index of first row of clipped region.
+ * \param[out] col
+ * Index of first column of clipped region.
+ * \param[out] nbRows
+ * Number of rows of clipped region.
+ * \param[out] nbCols
+ * Number of columns of clipped region.
+ */
+template<typename T>
+bool Array2DIntegral<T>::clip(const QRect &rect, size_t &row, size_t &col, size_t &nbRows, size_t &nbCols) const
+{
+    if(rect.width() <= 0 || rect.height() <= 0){
+        return false;
+    }
+
+    const qint64 top = std::max<qint64>(rect.y(), 0);
+    const qint64 left = std::max<qint64>(rect.x(), 0);
+    const qint64 bottom = static_cast<qint64>(rect.y()) + rect.height();
+    const qint64 right = static_cast<qint64>(rect.x()) + rect.width();
+    if(bottom <= top || right <= left){
+        return false;
+    }
+
+    row = static_cast<size_t>(top);
+    col = static_cast<size_t>(left);
+    nbRows = static_cast<size_t>(bottom - top);
+    nbCols = static_cast<size_t>(right - left);
+
+    return clip(row, col, nbRows, nbCols);
+}
+
+/*!
+ * \brief Compute sum of a region inside array bounds
+ * \details
+ * Pending changes are included.
+ *
+ * \param[in] row
+ * Index of first row of region.
+ * \param[in] col
+ * Index of first column of region.
+ * \param[in] nbRows
+ * Number of rows of region.
+ * \param[in] nbCols
+ * Number of columns of region.
+ *
+ * \return
+ * Returns sum of elements of region.
+ */
+template<typename T>
+typename Array2DIntegral<T>::SumType Array2DIntegral<T>::regionSum(size_t row, size_t col, size_t nbRows, size_t nbCols) const
+{
+    const size_t rowEnd = row + nbRows;
+    const size_t colEnd = col + nbCols;
+
+    SumType result = m_table(rowEnd, colEnd) - m_table(row, colEnd) - m_table(rowEnd, col) + m_table(row, col);
+
+    for(const Pending &change : m_pending){
+        if(change.row >= row && change.row < rowEnd && change.col >= col && change.col < colEnd){
+            result += change.delta;
+        }
+    }
+
+    return result;
+}
+
+/*****************************/
+/* Constants definitions     */
+/*****************************/
+
+template<typename T>
+constexpr int Array2DIntegral<T>::PENDING_MAX;
+
+} // namespace tbq
+
+#endif // TBQ_CONTAINER_ARRAY2DINTEGRAL_H
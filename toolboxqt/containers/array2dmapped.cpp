@@ -0,0 +1,245 @@
+#include "array2dmapped.h"
+
+/*****************************/
+/* Class documentations      */
+/*****************************/
+
+/*!
+ * \class tbq::Array2DMappedFile
+ * \brief Manage memory-mapping of a 2-dimensional array file
+ * \details
+ * Include with:
+ * \code{.cpp}
+ * #include "toolboxqt/containers/array2dmapped.h"
+ * \endcode
+ *
+ * This class is the untyped backend of tbq::Array2DMapped,
+ * which should be preferred. Format of the file is described
+ * in tbq::Array2DFileHeader.
+ */
+
+/*****************************/
+/*      Custom types
+ *     documentations        */
+/*****************************/
+
+/*!
+ * \enum tbq::Array2DMappedFile::OpenMode
+ * \brief List of available mapping modes
+ *
+ * \var tbq::Array2DMappedFile::MAP_READ_ONLY
+ * File is opened in read-only mode and mapped
+ * copy-on-write: elements modifications are only
+ * kept in memory and never written to the file.
+ *
+ * \var tbq::Array2DMappedFile::MAP_READ_WRITE
+ * Elements can be read and modified, modifications
+ * are written to the file.
+ */
+
+/*****************************/
+/* Macro definitions         */
+/*****************************/
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/* Constants definitions     */
+/*****************************/
+
+/*****************************/
+/* Functions implementation  */
+/*         Class             */
+/*****************************/
+
+Array2DMappedFile::Array2DMappedFile()
+    : m_file(), m_header(), m_data(nullptr), m_writable(false)
+{
+    /* Nothing to do */
+}
+
+Array2DMappedFile::~Array2DMappedFile()
+{
+    close();
+}
+
+/*!
+ * \brief Create a file and map it in read-write mode
+ * \details
+ * Data section is zero-initialized. Existing file will be
+ * overwritten.
+ *
+ * \param[in] path
+ * Path of the file to create.
+ * \param[in] header
+ * Header describing the 2D array to store.
+ *
+ * \return
+ * Returns \c true if succeed.
+ */
+bool Array2DMappedFile::create(const QString &path, const Array2DFileHeader &header)
+{
+    close();
+
+    /* Write header and reserve data section */
+    m_file.setFileName(path);
+    if(!m_file.open(QIODevice::ReadWrite | QIODevice::Truncate)){
+        return false;
+    }
+
+    if(!header.write(m_file) || !m_file.resize(header.getDataOffset() + header.getDataSize())){
+        m_file.close();
+        return false;
+    }
+
+    m_header = header;
+    m_writable = true;
+
+    return mapData();
+}
+
+/*!
+ * \brief Open and map an existing file
+ *
+ * \param[in] path
+ * Path of the file to open.
+ * \param[in] mode
+ * Mapping mode to use.
+ * \param[in] type
+ * Expected type of elements.
+ * \param[in] elemSize
+ * Expected size of an element.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if file can't be mapped, if its header is invalid
+ * or not compatible with expected type or if file is truncated.
+ */
+bool Array2DMappedFile::open(const QString &path, OpenMode mode, Array2DFileHeader::ElemType type, quint32 elemSize)
+{
+    close();
+
+    /* Open file */
+    const bool writable = mode == MAP_READ_WRITE;
+
+    m_file.setFileName(path);
+    if(!m_file.open(writable ? QIODevice::ReadWrite : QIODevice::ReadOnly)){
+        return false;
+    }
+
+    /* Verify header */
+    Array2DFileHeader header;
+    if(!header.read(m_file)
+        || !header.isCompatible(type, elemSize)
+        || m_file.size() < header.getDataOffset() + header.getDataSize()){
+        m_file.close();
+        return false;
+    }
+
+    m_header = header;
+    m_writable = writable;
+
+    return mapData();
+}
+
+/*!
+ * \brief Unmap and close the file
+ */
+void Array2DMappedFile::close()
+{
+    if(m_data){
+        m_file.unmap(m_data);
+        m_data = nullptr;
+    }
+
+    if(m_file.isOpen()){
+        m_file.close();
+    }
+
+    m_header = Array2DFileHeader();
+    m_writable = false;
+}
+
+/*!
+ * \brief Use to know if a file is mapped
+ *
+ * \return
+ * Returns \c true if mapped
+ */
+bool Array2DMappedFile::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+/*!
+ * \brief Use to know if mapped data can be modified
+ *
+ * \return
+ * Returns \c true if file has been mapped in
+ * read-write mode, modifications are then written
+ * to the file
+ */
+bool Array2DMappedFile::isWritable() const
+{
+    return m_writable;
+}
+
+/*!
+ * \brief Get header of mapped file
+ *
+ * \return
+ * Returns reference to header. \n
+ * Header is invalid if no file is mapped.
+ */
+const Array2DFileHeader& Array2DMappedFile::getHeader() const
+{
+    return m_header;
+}
+
+/*!
+ * \brief Get pointer to mapped data section
+ *
+ * \return
+ * Returns pointer to first element. \n
+ * Returns \c nullptr if no file is mapped or if
+ * mapped array is empty.
+ */
+uchar* Array2DMappedFile::data() const
+{
+    return m_data;
+}
+
+bool Array2DMappedFile::mapData()
+{
+    /* Empty arrays can't be mapped */
+    const qint64 size = m_header.getDataSize();
+    if(size == 0){
+        return true;
+    }
+
+    /* Read-only mappings are private so that writing to them can't crash */
+    const QFileDevice::MemoryMapFlags flags = m_writable ? QFileDevice::NoOptions : QFileDevice::MapPrivateOption;
+
+    m_data = m_file.map(m_header.getDataOffset(), size, flags);
+    if(!m_data){
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+/*****************************/
+/* End namespace             */
+/*****************************/
+
+} // namespace tbq
+
+/*****************************/
+/* End file                  */
+/*****************************/
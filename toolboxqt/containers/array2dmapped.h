@@ -0,0 +1,492 @@
+#ifndef TBQ_CONTAINER_ARRAY2DMAPPED_H
+#define TBQ_CONTAINER_ARRAY2DMAPPED_H
+
+#include "toolboxqt/toolboxqt_global.h"
+#include "toolboxqt/containers/array2dfile.h"
+#include "toolboxqt/containers/array2dview.h"
+
+#include <QFile>
+
+#include <type_traits>
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/*     Class definitions     */
+/*     Array2DMappedFile     */
+/*****************************/
+
+class TOOLBOXQT_EXPORT Array2DMappedFile
+{
+    TOOLBOXQT_DISABLE_COPY(Array2DMappedFile)
+
+public:
+    enum OpenMode
+    {
+        MAP_READ_ONLY,
+        MAP_READ_WRITE
+    };
+
+public:
+    explicit Array2DMappedFile();
+    ~Array2DMappedFile();
+
+public:
+    bool create(const QString &path, const Array2DFileHeader &header);
+    bool open(const QString &path, OpenMode mode, Array2DFileHeader::ElemType type, quint32 elemSize);
+    void close();
+
+public:
+    bool isOpen() const;
+    bool isWritable() const;
+
+    const Array2DFileHeader& getHeader() const;
+    uchar* data() const;
+
+private:
+    bool mapData();
+
+private:
+    QFile m_file;
+    Array2DFileHeader m_header;
+    uchar *m_data;
+    bool m_writable;
+};
+
+/*****************************/
+/* Define template interface */
+/*****************************/
+
+/*!
+ * \class Array2DMapped
+ * \brief Use to manage a 2-dimensional array stored
+ * in a memory-mapped file
+ * \details
+ * Include with:
+ * \code{.cpp}
+ * #include "toolboxqt/containers/array2dmapped.h"
+ * \endcode
+ *
+ * Elements are never loaded into memory by this class, they are
+ * accessed through a memory-mapping of the file, so opening a file
+ * is immediate and datasets larger than available RAM can be used.
+ * \code{.cpp}
+ * tbq::Array2DMapped<float> table;
+ * if(table.create("calibration.a2d", 20000, 20000)){
+ *     table(10, 42) = 3.5f;
+ * }
+ * table.close();
+ *
+ * // Later, reopen it instantly
+ * if(table.open("calibration.a2d")){
+ *     const float value = table(10, 42);
+ * }
+ * \endcode
+ *
+ * \note
+ * Only trivially copyable types can be used.
+ */
+template <typename T>
+class Array2DMapped
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Array2DMapped can only be used with trivially copyable types");
+    TOOLBOXQT_DISABLE_COPY(Array2DMapped)
+
+public:
+    explicit Array2DMapped();
+
+public:
+    bool create(const QString &path, size_t nbRows, size_t nbCols);
+    bool open(const QString &path, Array2DMappedFile::OpenMode mode = Array2DMappedFile::MAP_READ_ONLY);
+    void close();
+
+    bool isOpen() const;
+    bool isWritable() const;
+
+public:
+    size_t getRows() const;
+    size_t getCols() const;
+    size_t getSize() const;
+
+public:
+    void insert(size_t row, size_t col, const T &value);
+
+public:
+    T* data();
+    const T* data() const;
+
+    Array2DLineView<T> rowView(size_t row);
+    Array2DLineView<const T> rowView(size_t row) const;
+
+    Array2DLineView<T> colView(size_t col);
+    Array2DLineView<const T> colView(size_t col) const;
+
+    Array2DView<T> view();
+    Array2DView<const T> view() const;
+
+    Array2DView<T> subView(size_t row, size_t col, size_t nbRows, size_t nbCols);
+    Array2DView<const T> subView(size_t row, size_t col, size_t nbRows, size_t nbCols) const;
+
+public:
+    T& operator()(size_t row, size_t col);
+    const T& operator()(size_t row, size_t col) const;
+
+private:
+    Array2DMappedFile m_file;
+};
+
+/*****************************/
+/* Define template
+ *      implementation       */
+/*****************************/
+
+/*!
+ * \brief Construct a closed 2D array
+ *
+ * \sa create(), open()
+ */
+template<typename T>
+Array2DMapped<T>::Array2DMapped()
+    : m_file()
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Create a file able to store a 2D array and
+ * map it in read-write mode
+ * \details
+ * Elements are zero-initialized. Existing file will be
+ * overwritten.
+ *
+ * \param[in] path
+ * Path of the file to create.
+ * \param[in] nbRows
+ * Number of rows.
+ * \param[in] nbCols
+ * Number of colums
+ *
+ * \return
+ * Returns \c true if succeed.
+ *
+ * \sa open(), close()
+ */
+template<typename T>
+bool Array2DMapped<T>::create(const QString &path, size_t nbRows, size_t nbCols)
+{
+    return m_file.create(path, Array2DFileHeader::fromType<T>(nbRows, nbCols));
+}
+
+/*!
+ * \brief Open and map an existing 2D array file
+ * \details
+ * Opening is immediate whatever the size of the file is:
+ * elements are loaded on demand by the operating system
+ * when accessed.
+ *
+ * \param[in] path
+ * Path of the file to open.
+ * \param[in] mode
+ * Mapping mode. \n
+ * When using tbq::Array2DMappedFile::MAP_READ_ONLY, elements
+ * modifications are not written to the file.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if file can't be mapped or if its header
+ * doesn't match type \c T.
+ *
+ * \sa create(), close()
+ */
+template<typename T>
+bool Array2DMapped<T>::open(const QString &path, Array2DMappedFile::OpenMode mode)
+{
+    return m_file.open(path, mode, Array2DFileElemType<T>::value, sizeof(T));
+}
+
+/*!
+ * \brief Unmap and close associated file
+ * \details
+ * All views are invalidated.
+ */
+template<typename T>
+void Array2DMapped<T>::close()
+{
+    m_file.close();
+}
+
+/*!
+ * \brief Use to know if a file is mapped
+ *
+ * \return
+ * Returns \c true if mapped
+ */
+template<typename T>
+bool Array2DMapped<T>::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+/*!
+ * \brief Use to know if elements can be modified
+ *
+ * \return
+ * Returns \c true if file has been mapped in
+ * read-write mode, modifications are then written
+ * to the file
+ */
+template<typename T>
+bool Array2DMapped<T>::isWritable() const
+{
+    return m_file.isWritable();
+}
+
+/*!
+ * \brief Get number of rows
+ *
+ * \return
+ * Returns number of rows available
+ *
+ * \sa getCols(), getSize()
+ */
+template<typename T>
+size_t Array2DMapped<T>::getRows() const
+{
+    return static_cast<size_t>(m_file.getHeader().getRows());
+}
+
+/*!
+ * \brief Get number of columns
+ *
+ * \return
+ * Returns number of columns available
+ *
+ * \sa getRows(), getSize()
+ */
+template<typename T>
+size_t Array2DMapped<T>::getCols() const
+{
+    return static_cast<size_t>(m_file.getHeader().getCols());
+}
+
+/*!
+ * \brief Get total size of 2D array (a.k.a number
+ * of elements)
+ *
+ * \return
+ * Returns number of elements
+ *
+ * \sa getRows(), getCols()
+ */
+template<typename T>
+size_t Array2DMapped<T>::getSize() const
+{
+    return getRows() * getCols();
+}
+
+/*!
+ * \brief Use to insert a value at specified
+ * indexes.
+ *
+ * \param[in] row
+ * Row index to use. \n
+ * Must be valid (i.e <tt>0 <= row < getRows()</tt>).
+ * \param[in] col
+ * Column index to use. \n
+ * Must be valid (i.e <tt>0 <= col < getCols()</tt>).
+ * \param[in] value
+ * Value to insert
+ *
+ * \note
+ * When file is mapped in read-only mode, value is not
+ * written to the file.
+ */
+template<typename T>
+void Array2DMapped<T>::insert(size_t row, size_t col, const T &value)
+{
+    (*this)(row, col) = value;
+}
+
+/*!
+ * \brief Get pointer to mapped row-major elements
+ *
+ * \return
+ * Returns pointer to first element, \c nullptr
+ * may be returned if array is closed or empty.
+ */
+template<typename T>
+T* Array2DMapped<T>::data()
+{
+    return reinterpret_cast<T*>(m_file.data());
+}
+
+/*!
+ * \overload
+ */
+template<typename T>
+const T* Array2DMapped<T>::data() const
+{
+    return reinterpret_cast<const T*>(m_file.data());
+}
+
+/*!
+ * \brief Get view of a row, no copy is performed
+ *
+ * \param[in] row
+ * Row index to use. \n
+ * Must be valid (i.e <tt>0 <= row < getRows()</tt>).
+ *
+ * \return
+ * Returns contiguous line view of the row.
+ */
+template<typename T>
+Array2DLineView<T> Array2DMapped<T>::rowView(size_t row)
+{
+    return view().rowView(row);
+}
+
+/*!
+ * \overload
+ */
+template<typename T>
+Array2DLineView<const T> Array2DMapped<T>::rowView(size_t row) const
+{
+    return view().rowView(row);
+}
+
+/*!
+ * \brief Get view of a column, no copy is performed
+ *
+ * \param[in] col
+ * Column index to use. \n
+ * Must be valid (i.e <tt>0 <= col < getCols()</tt>).
+ *
+ * \return
+ * Returns strided line view of the column.
+ */
+template<typename T>
+Array2DLineView<T> Array2DMapped<T>::colView(size_t col)
+{
+    return view().colView(col);
+}
+
+/*!
+ * \overload
+ */
+template<typename T>
+Array2DLineView<const T> Array2DMapped<T>::colView(size_t col) const
+{
+    return view().colView(col);
+}
+
+/*!
+ * \brief Get view of the whole array, no copy is performed
+ *
+ * \return
+ * Returns view of the array.
+ */
+template<typename T>
+Array2DView<T> Array2DMapped<T>::view()
+{
+    return Array2DView<T>(data(), getRows(), getCols(), getCols());
+}
+
+/*!
+ * \overload
+ */
+template<typename T>
+Array2DView<const T> Array2DMapped<T>::view() const
+{
+    return Array2DView<const T>(data(), getRows(), getCols(), getCols());
+}
+
+/*!
+ * \brief Get view of a rectangular region, no copy is performed
+ *
+ * \param[in] row
+ * Index of first row of the region.
+ * \param[in] col
+ * Index of first column of the region.
+ * \param[in] nbRows
+ * Number of rows of the region. \n
+ * Must be valid (i.e <tt>row + nbRows <= getRows()</tt>).
+ * \param[in] nbCols
+ * Number of columns of the region. \n
+ * Must be valid (i.e <tt>col + nbCols <= getCols()</tt>).
+ *
+ * \return
+ * Returns view of the region.
+ */
+template<typename T>
+Array2DView<T> Array2DMapped<T>::subView(size_t row, size_t col, size_t nbRows, size_t nbCols)
+{
+    return view().subView(row, col, nbRows, nbCols);
+}
+
+/*!
+ * \overload
+ */
+template<typename T>
+Array2DView<const T> Array2DMapped<T>::subView(size_t row, size_t col, size_t nbRows, size_t nbCols) const
+{
+    return view().subView(row, col, nbRows, nbCols);
+}
+
+/*!
+ * \brief Get modifiable reference to an element
+ *
+ * \param[in] row
+ * Row index to use. \n
+ * Must be valid (i.e <tt>0 <= row < getRows()</tt>).
+ * \param[in] col
+ * Column index to use. \n
+ * Must be valid (i.e <tt>0 <= col < getCols()</tt>).
+ *
+ * \return
+ * Returns modifiable reference to an element
+ *
+ * \note
+ * When file is mapped in read-only mode, modifications
+ * are not written to the file.
+ */
+template<typename T>
+T& Array2DMapped<T>::operator()(size_t row, size_t col)
+{
+    return data()[row * getCols() + col];
+}
+
+/*!
+ * \brief Get constant reference to an element
+ *
+ * \param[in] row
+ * Row index to use. \n
+ * Must be valid (i.e <tt>0 <= row < getRows()</tt>).
+ * \param[in] col
+ * Column index to use. \n
+ * Must be valid (i.e <tt>0 <= col < getCols()</tt>).
+ *
+ * \return
+ * Returns constant reference to an element
+ */
+template<typename T>
+const T& Array2DMapped<T>::operator()(size_t row, size_t col) const
+{
+    return data()[row * getCols() + col];
+}
+
+/*****************************/
+/* End namespace             */
+/*****************************/
+
+} // namespace tbq
+
+/*****************************/
+/* End file                  */
+/*****************************/
+
+#endif // TBQ_CONTAINER_ARRAY2DMAPPED_H
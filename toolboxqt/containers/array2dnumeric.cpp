@@ -0,0 +1,721 @@
+#include "array2dnumeric.h"
+
+/*****************************/
+/* Class documentations      */
+/*****************************/
+
+/*!
+ * \class tbq::Array2DNumeric
+ * \brief Vectorized numeric kernels over 2-dimensional arrays
+ * \details
+ * Include with:
+ * \code{.cpp}
+ * #include "toolboxqt/containers/array2dnumeric.h"
+ * \endcode
+ *
+ * Kernels work on contiguous storage (see tbq::Array2D::data()),
+ * so no per-element index computation is performed and loops are
+ * vectorized by the compiler. Supported element types are \c quint8,
+ * \c quint16, \c qint32, \c float and \c double.
+ *
+ * On x86 with GCC or Clang, kernels are compiled for baseline instruction
+ * set (SSE2 on x86-64) and for AVX2, selected at runtime according to
+ * CPU capabilities (see getSimdLevel()). Other platforms use portable
+ * kernels.
+ * \code{.cpp}
+ * tbq::Array2D<float> grid(4096, 4096);
+ * tbq::Array2DNumeric::fill(grid, 1.0f);
+ * tbq::Array2DNumeric::mul(grid, 0.5f);
+ *
+ * const double avg = tbq::Array2DNumeric::mean(grid);
+ * \endcode
+ *
+ * \note
+ * Integer arithmetic wraps like built-in arithmetic of \c T. \n
+ * Results on floating-point arrays containing \c NaN values
+ * are unspecified for minMax(), argMax() and clamp().
+ */
+
+/*****************************/
+/*      Custom types
+ *     documentations        */
+/*****************************/
+
+/*!
+ * \enum tbq::Array2DNumeric::SimdLevel
+ * \brief List of instruction sets used by kernels
+ *
+ * \var tbq::Array2DNumeric::SIMD_NONE
+ * Portable kernels.
+ *
+ * \var tbq::Array2DNumeric::SIMD_SSE2
+ * Kernels using SSE2 instructions.
+ *
+ * \var tbq::Array2DNumeric::SIMD_AVX2
+ * Kernels using AVX2 instructions.
+ */
+
+/*!
+ * \typedef tbq::Array2DNumeric::SumType
+ * \brief Type used to accumulate sum of elements: \c qint64
+ * for integer types, \c double for floating-point types.
+ */
+
+/*!
+ * \typedef tbq::Array2DNumeric::IsSupported
+ * \brief Used to know if kernels are available for an
+ * element type: \c quint8, \c quint16, \c qint32, \c float
+ * or \c double. \n
+ * Using other types is rejected at compile-time.
+ */
+
+/*****************************/
+/* Macro definitions         */
+/*****************************/
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#   define TBQ_NUMERIC_DISPATCH_X86 1
+#   define TBQ_NUMERIC_INLINE       inline __attribute__((always_inline))
+#   define TBQ_NUMERIC_TARGET_AVX2  __attribute__((target("avx2")))
+#else
+#   define TBQ_NUMERIC_DISPATCH_X86 0
+#   define TBQ_NUMERIC_INLINE       inline
+#endif
+
+#if TBQ_NUMERIC_DISPATCH_X86
+#   define TBQ_NUMERIC_DISPATCH(kernel, ...) (isAvx2Available() ? kernel##Avx2(__VA_ARGS__) : kernel(__VA_ARGS__))
+#else
+#   define TBQ_NUMERIC_DISPATCH(kernel, ...) kernel(__VA_ARGS__)
+#endif
+
+#define TBQ_NUMERIC_INSTANTIATE(T) \
+    template void Array2DNumeric::fill<T>(T*, size_t, T); \
+    template void Array2DNumeric::add<T>(T*, size_t, T); \
+    template void Array2DNumeric::add<T>(T*, const T*, size_t); \
+    template void Array2DNumeric::mul<T>(T*, size_t, T); \
+    template void Array2DNumeric::mul<T>(T*, const T*, size_t); \
+    template void Array2DNumeric::clamp<T>(T*, size_t, T, T); \
+    template bool Array2DNumeric::minMax<T>(const T*, size_t, T&, T&); \
+    template size_t Array2DNumeric::argMax<T>(const T*, size_t); \
+    template Array2DNumeric::SumType<T> Array2DNumeric::sum<T>(const T*, size_t); \
+    template double Array2DNumeric::mean<T>(const T*, size_t); \
+    template double Array2DNumeric::variance<T>(const T*, size_t); \
+    template void Array2DNumeric::histogram<T>(const T*, size_t, T, T, quint64*, size_t);
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/* Constants definitions     */
+/*****************************/
+
+/* Number of independent accumulators used by reductions, allow to vectorize them without reordering floating-point operations */
+static constexpr size_t REDUCE_LANES = 16;
+
+/* Histograms of large arrays are computed in multiple sub-histograms to break dependency between consecutive increments */
+static constexpr size_t HISTOGRAM_SUBS = 4;
+static constexpr size_t HISTOGRAM_SUBS_MIN_SIZE = 4096;
+
+/*****************************/
+/* Kernels implementation    */
+/*****************************/
+
+template<typename T>
+TBQ_NUMERIC_INLINE void kernelFill(T *data, size_t size, T value)
+{
+    for(size_t i = 0; i < size; ++i){
+        data[i] = value;
+    }
+}
+
+template<typename T>
+TBQ_NUMERIC_INLINE void kernelAddScalar(T *data, size_t size, T value)
+{
+    for(size_t i = 0; i < size; ++i){
+        data[i] = static_cast<T>(data[i] + value);
+    }
+}
+
+template<typename T>
+TBQ_NUMERIC_INLINE void kernelAdd(T *data, const T *other, size_t size)
+{
+    for(size_t i = 0; i < size; ++i){
+        data[i] = static_cast<T>(data[i] + other[i]);
+    }
+}
+
+template<typename T>
+TBQ_NUMERIC_INLINE void kernelMulScalar(T *data, size_t size, T value)
+{
+    for(size_t i = 0; i < size; ++i){
+        data[i] = static_cast<T>(data[i] * value);
+    }
+}
+
+template<typename T>
+TBQ_NUMERIC_INLINE void kernelMul(T *data, const T *other, size_t size)
+{
+    for(size_t i = 0; i < size; ++i){
+        data[i] = static_cast<T>(data[i] * other[i]);
+    }
+}
+
+template<typename T>
+TBQ_NUMERIC_INLINE void kernelClamp(T *data, size_t size, T lower, T upper)
+{
+    for(size_t i = 0; i < size; ++i){
+        const T value = data[i] < lower ? lower : data[i];
+        data[i] = value > upper ? upper : value;
+    }
+}
+
+template<typename T>
+TBQ_NUMERIC_INLINE void kernelMinMax(const T *data, size_t size, T &min, T &max)
+{
+    T mins[REDUCE_LANES];
+    T maxs[REDUCE_LANES];
+    for(size_t lane = 0; lane < REDUCE_LANES; ++lane){
+        mins[lane] = data[0];
+        maxs[lane] = data[0];
+    }
+
+    const size_t sizeLanes = size - size % REDUCE_LANES;
+    for(size_t i = 0; i < sizeLanes; i += REDUCE_LANES){
+        for(size_t lane = 0; lane < REDUCE_LANES; ++lane){
+            const T value = data[i + lane];
+            mins[lane] = value < mins[lane] ? value : mins[lane];
+            maxs[lane] = value > maxs[lane] ? value : maxs[lane];
+        }
+    }
+
+    for(size_t i = sizeLanes; i < size; ++i){
+        mins[0] = data[i] < mins[0] ? data[i] : mins[0];
+        maxs[0] = data[i] > maxs[0] ? data[i] : maxs[0];
+    }
+
+    min = mins[0];
+    max = maxs[0];
+    for(size_t lane = 1; lane < REDUCE_LANES; ++lane){
+        min = mins[lane] < min ? mins[lane] : min;
+        max = maxs[lane] > max ? maxs[lane] : max;
+    }
+}
+
+template<typename T>
+TBQ_NUMERIC_INLINE T kernelMax(const T *data, size_t size)
+{
+    T maxs[REDUCE_LANES];
+    for(size_t lane = 0; lane < REDUCE_LANES; ++lane){
+        maxs[lane] = data[0];
+    }
+
+    const size_t sizeLanes = size - size % REDUCE_LANES;
+    for(size_t i = 0; i < sizeLanes; i += REDUCE_LANES){
+        for(size_t lane = 0; lane < REDUCE_LANES; ++lane){
+            const T value = data[i + lane];
+            maxs[lane] = value > maxs[lane] ? value : maxs[lane];
+        }
+    }
+
+    for(size_t i = sizeLanes; i < size; ++i){
+        maxs[0] = data[i] > maxs[0] ? data[i] : maxs[0];
+    }
+
+    T max = maxs[0];
+    for(size_t lane = 1; lane < REDUCE_LANES; ++lane){
+        max = maxs[lane] > max ? maxs[lane] : max;
+    }
+
+    return max;
+}
+
+template<typename T, typename Acc>
+TBQ_NUMERIC_INLINE Acc kernelSum(const T *data, size_t size)
+{
+    Acc sums[REDUCE_LANES] = {};
+
+    const size_t sizeLanes = size - size % REDUCE_LANES;
+    for(size_t i = 0; i < sizeLanes; i += REDUCE_LANES){
+        for(size_t lane = 0; lane < REDUCE_LANES; ++lane){
+            sums[lane] += static_cast<Acc>(data[i + lane]);
+        }
+    }
+
+    for(size_t i = sizeLanes; i < size; ++i){
+        sums[0] += static_cast<Acc>(data[i]);
+    }
+
+    Acc sum = 0;
+    for(size_t lane = 0; lane < REDUCE_LANES; ++lane){
+        sum += sums[lane];
+    }
+
+    return sum;
+}
+
+template<typename T>
+TBQ_NUMERIC_INLINE double kernelSumSquaredDiff(const T *data, size_t size, double mean)
+{
+    double sums[REDUCE_LANES] = {};
+
+    const size_t sizeLanes = size - size % REDUCE_LANES;
+    for(size_t i = 0; i < sizeLanes; i += REDUCE_LANES){
+        for(size_t lane = 0; lane < REDUCE_LANES; ++lane){
+            const double diff = static_cast<double>(data[i + lane]) - mean;
+            sums[lane] += diff * diff;
+        }
+    }
+
+    for(size_t i = sizeLanes; i < size; ++i){
+        const double diff = static_cast<double>(data[i]) - mean;
+        sums[0] += diff * diff;
+    }
+
+    double sum = 0;
+    for(size_t lane = 0; lane < REDUCE_LANES; ++lane){
+        sum += sums[lane];
+    }
+
+    return sum;
+}
+
+template<typename T>
+TBQ_NUMERIC_INLINE void kernelHistogram(const T *data, size_t size, T lower, T upper, quint64 *bins, size_t nbBins)
+{
+    const double scale = static_cast<double>(nbBins) / (static_cast<double>(upper) - static_cast<double>(lower));
+    const size_t idLast = nbBins - 1;
+
+    /* Use sub-histograms for large arrays */
+    const size_t nbSubs = size >= HISTOGRAM_SUBS_MIN_SIZE ? HISTOGRAM_SUBS : 1;
+    QVector<quint64> subs(static_cast<int>(nbSubs * nbBins), 0);
+    quint64 *subsData = subs.data();
+
+    for(size_t i = 0; i < size; ++i){
+        const T value = data[i];
+        if(!(value >= lower && value <= upper)){
+            continue;
+        }
+
+        const size_t idBin = qMin(static_cast<size_t>((static_cast<double>(value) - static_cast<double>(lower)) * scale), idLast);
+        ++subsData[(i % nbSubs) * nbBins + idBin];
+    }
+
+    for(size_t idSub = 0; idSub < nbSubs; ++idSub){
+        for(size_t idBin = 0; idBin < nbBins; ++idBin){
+            bins[idBin] += subsData[idSub * nbBins + idBin];
+        }
+    }
+}
+
+/*****************************/
+/*  Kernels dispatch (x86)   */
+/*****************************/
+
+#if TBQ_NUMERIC_DISPATCH_X86
+
+static bool isAvx2Available()
+{
+    static const bool available = [](){
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+
+    return available;
+}
+
+template<typename T>
+TBQ_NUMERIC_TARGET_AVX2 void kernelFillAvx2(T *data, size_t size, T value)
+{
+    kernelFill(data, size, value);
+}
+
+template<typename T>
+TBQ_NUMERIC_TARGET_AVX2 void kernelAddScalarAvx2(T *data, size_t size, T value)
+{
+    kernelAddScalar(data, size, value);
+}
+
+template<typename T>
+TBQ_NUMERIC_TARGET_AVX2 void kernelAddAvx2(T *data, const T *other, size_t size)
+{
+    kernelAdd(data, other, size);
+}
+
+template<typename T>
+TBQ_NUMERIC_TARGET_AVX2 void kernelMulScalarAvx2(T *data, size_t size, T value)
+{
+    kernelMulScalar(data, size, value);
+}
+
+template<typename T>
+TBQ_NUMERIC_TARGET_AVX2 void kernelMulAvx2(T *data, const T *other, size_t size)
+{
+    kernelMul(data, other, size);
+}
+
+template<typename T>
+TBQ_NUMERIC_TARGET_AVX2 void kernelClampAvx2(T *data, size_t size, T lower, T upper)
+{
+    kernelClamp(data, size, lower, upper);
+}
+
+template<typename T>
+TBQ_NUMERIC_TARGET_AVX2 void kernelMinMaxAvx2(const T *data, size_t size, T &min, T &max)
+{
+    kernelMinMax(data, size, min, max);
+}
+
+template<typename T>
+TBQ_NUMERIC_TARGET_AVX2 T kernelMaxAvx2(const T *data, size_t size)
+{
+    return kernelMax(data, size);
+}
+
+template<typename T, typename Acc>
+TBQ_NUMERIC_TARGET_AVX2 Acc kernelSumAvx2(const T *data, size_t size)
+{
+    return kernelSum<T, Acc>(data, size);
+}
+
+template<typename T>
+TBQ_NUMERIC_TARGET_AVX2 double kernelSumSquaredDiffAvx2(const T *data, size_t size, double mean)
+{
+    return kernelSumSquaredDiff(data, size, mean);
+}
+
+#endif
+
+/*****************************/
+/* Functions implementation  */
+/*         Class             */
+/*****************************/
+
+/*!
+ * \brief Get instruction set used by kernels
+ * on this host
+ *
+ * \return
+ * Returns instruction set level
+ */
+Array2DNumeric::SimdLevel Array2DNumeric::getSimdLevel()
+{
+#if TBQ_NUMERIC_DISPATCH_X86
+    if(isAvx2Available()){
+        return SIMD_AVX2;
+    }
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    return SIMD_SSE2;
+#else
+    return SIMD_NONE;
+#endif
+}
+
+/*!
+ * \brief Set all elements to a value
+ *
+ * \param[out] data
+ * Elements to fill.
+ * \param[in] size
+ * Number of elements.
+ * \param[in] value
+ * Value to use.
+ */
+template<typename T>
+void Array2DNumeric::fill(T *data, size_t size, T value)
+{
+    static_assert(IsSupported<T>::value, "Array2DNumeric supports quint8, quint16, qint32, float and double elements");
+
+    TBQ_NUMERIC_DISPATCH(kernelFill, data, size, value);
+}
+
+/*!
+ * \brief Add a value to all elements
+ *
+ * \param[in, out] data
+ * Elements to modify.
+ * \param[in] size
+ * Number of elements.
+ * \param[in] value
+ * Value to add.
+ */
+template<typename T>
+void Array2DNumeric::add(T *data, size_t size, T value)
+{
+    static_assert(IsSupported<T>::value, "Array2DNumeric supports quint8, quint16, qint32, float and double elements");
+
+    TBQ_NUMERIC_DISPATCH(kernelAddScalar, data, size, value);
+}
+
+/*!
+ * \brief Add elements to other elements
+ *
+ * \param[in, out] data
+ * Elements to modify.
+ * \param[in] other
+ * Elements to add, can be \c data.
+ * \param[in] size
+ * Number of elements.
+ */
+template<typename T>
+void Array2DNumeric::add(T *data, const T *other, size_t size)
+{
+    static_assert(IsSupported<T>::value, "Array2DNumeric supports quint8, quint16, qint32, float and double elements");
+
+    TBQ_NUMERIC_DISPATCH(kernelAdd, data, other, size);
+}
+
+/*!
+ * \brief Multiply all elements by a value
+ *
+ * \param[in, out] data
+ * Elements to modify.
+ * \param[in] size
+ * Number of elements.
+ * \param[in] value
+ * Factor to use.
+ */
+template<typename T>
+void Array2DNumeric::mul(T *data, size_t size, T value)
+{
+    static_assert(IsSupported<T>::value, "Array2DNumeric supports quint8, quint16, qint32, float and double elements");
+
+    TBQ_NUMERIC_DISPATCH(kernelMulScalar, data, size, value);
+}
+
+/*!
+ * \brief Multiply elements by other elements
+ *
+ * \param[in, out] data
+ * Elements to modify.
+ * \param[in] other
+ * Factors to use, can be \c data.
+ * \param[in] size
+ * Number of elements.
+ */
+template<typename T>
+void Array2DNumeric::mul(T *data, const T *other, size_t size)
+{
+    static_assert(IsSupported<T>::value, "Array2DNumeric supports quint8, quint16, qint32, float and double elements");
+
+    TBQ_NUMERIC_DISPATCH(kernelMul, data, other, size);
+}
+
+/*!
+ * \brief Clamp all elements to a range
+ *
+ * \param[in, out] data
+ * Elements to modify.
+ * \param[in] size
+ * Number of elements.
+ * \param[in] lower
+ * Lower bound of range.
+ * \param[in] upper
+ * Upper bound of range, must be greater or
+ * equal to \c lower.
+ */
+template<typename T>
+void Array2DNumeric::clamp(T *data, size_t size, T lower, T upper)
+{
+    static_assert(IsSupported<T>::value, "Array2DNumeric supports quint8, quint16, qint32, float and double elements");
+
+    TBQ_NUMERIC_DISPATCH(kernelClamp, data, size, lower, upper);
+}
+
+/*!
+ * \brief Get minimum and maximum values
+ *
+ * \param[in] data
+ * Elements to use.
+ * \param[in] size
+ * Number of elements.
+ * \param[out] min
+ * Minimum value.
+ * \param[out] max
+ * Maximum value.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if \c size is \c 0, \c min and
+ * \c max are not modified.
+ */
+template<typename T>
+bool Array2DNumeric::minMax(const T *data, size_t size, T &min, T &max)
+{
+    static_assert(IsSupported<T>::value, "Array2DNumeric supports quint8, quint16, qint32, float and double elements");
+
+    if(size == 0){
+        return false;
+    }
+
+    TBQ_NUMERIC_DISPATCH(kernelMinMax, data, size, min, max);
+    return true;
+}
+
+/*!
+ * \brief Get index of maximum value
+ * \details
+ * Maximum value is computed using vectorized kernel,
+ * then its first occurence is searched.
+ *
+ * \param[in] data
+ * Elements to use.
+ * \param[in] size
+ * Number of elements.
+ *
+ * \return
+ * Returns index of first element containing
+ * maximum value. \n
+ * Returns \c size if \c size is \c 0.
+ */
+template<typename T>
+size_t Array2DNumeric::argMax(const T *data, size_t size)
+{
+    static_assert(IsSupported<T>::value, "Array2DNumeric supports quint8, quint16, qint32, float and double elements");
+
+    if(size == 0){
+        return size;
+    }
+
+    const T max = TBQ_NUMERIC_DISPATCH(kernelMax, data, size);
+    for(size_t i = 0; i < size; ++i){
+        if(data[i] == max){
+            return i;
+        }
+    }
+
+    return size;
+}
+
+/*!
+ * \brief Compute sum of elements
+ *
+ * \param[in] data
+ * Elements to use.
+ * \param[in] size
+ * Number of elements.
+ *
+ * \return
+ * Returns sum of elements.
+ */
+template<typename T>
+Array2DNumeric::SumType<T> Array2DNumeric::sum(const T *data, size_t size)
+{
+    static_assert(IsSupported<T>::value, "Array2DNumeric supports quint8, quint16, qint32, float and double elements");
+
+#if TBQ_NUMERIC_DISPATCH_X86
+    if(isAvx2Available()){
+        return kernelSumAvx2<T, SumType<T>>(data, size);
+    }
+#endif
+
+    return kernelSum<T, SumType<T>>(data, size);
+}
+
+/*!
+ * \brief Compute mean of elements
+ *
+ * \param[in] data
+ * Elements to use.
+ * \param[in] size
+ * Number of elements.
+ *
+ * \return
+ * Returns mean value. \n
+ * Returns \c 0 if \c size is \c 0.
+ */
+template<typename T>
+double Array2DNumeric::mean(const T *data, size_t size)
+{
+    static_assert(IsSupported<T>::value, "Array2DNumeric supports quint8, quint16, qint32, float and double elements");
+
+    if(size == 0){
+        return 0;
+    }
+
+    return static_cast<double>(sum(data, size)) / static_cast<double>(size);
+}
+
+/*!
+ * \brief Compute population variance of elements
+ * \details
+ * Two-pass algorithm is used (mean, then mean of squared
+ * differences), which is numerically stable.
+ *
+ * \param[in] data
+ * Elements to use.
+ * \param[in] size
+ * Number of elements.
+ *
+ * \return
+ * Returns variance. \n
+ * Returns \c 0 if \c size is \c 0.
+ */
+template<typename T>
+double Array2DNumeric::variance(const T *data, size_t size)
+{
+    static_assert(IsSupported<T>::value, "Array2DNumeric supports quint8, quint16, qint32, float and double elements");
+
+    if(size == 0){
+        return 0;
+    }
+
+    const double avg = mean(data, size);
+    return TBQ_NUMERIC_DISPATCH(kernelSumSquaredDiff, data, size, avg) / static_cast<double>(size);
+}
+
+/*!
+ * \brief Compute histogram of elements
+ *
+ * \param[in] data
+ * Elements to use.
+ * \param[in] size
+ * Number of elements.
+ * \param[in] lower
+ * Lower bound of range.
+ * \param[in] upper
+ * Upper bound of range (included in last bin), must be
+ * greater than \c lower.
+ * \param[in, out] bins
+ * Number of elements of each bin, values are
+ * incremented (not reset). \n
+ * Elements outside of range are ignored.
+ * \param[in] nbBins
+ * Number of bins, range is split in bins of equal width.
+ */
+template<typename T>
+void Array2DNumeric::histogram(const T *data, size_t size, T lower, T upper, quint64 *bins, size_t nbBins)
+{
+    static_assert(IsSupported<T>::value, "Array2DNumeric supports quint8, quint16, qint32, float and double elements");
+
+    if(nbBins == 0 || !(lower < upper)){
+        return;
+    }
+
+    kernelHistogram(data, size, lower, upper, bins, nbBins);
+}
+
+/*****************************/
+/* Explicit instantiations   */
+/*****************************/
+
+TBQ_NUMERIC_INSTANTIATE(quint8)
+TBQ_NUMERIC_INSTANTIATE(quint16)
+TBQ_NUMERIC_INSTANTIATE(qint32)
+TBQ_NUMERIC_INSTANTIATE(float)
+TBQ_NUMERIC_INSTANTIATE(double)
+
+/*****************************/
+/* End namespace             */
+/*****************************/
+
+} // namespace tbq
+
+/*****************************/
+/* End file                  */
+/*****************************/
@@ -0,0 +1,382 @@
+#ifndef TBQ_CONTAINER_ARRAY2DNUMERIC_H
+#define TBQ_CONTAINER_ARRAY2DNUMERIC_H
+
+#include "toolboxqt/toolboxqt_global.h"
+#include "toolboxqt/containers/array2d.h"
+
+#include <QVector>
+
+#include <type_traits>
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/*     Class definitions     */
+/*      Array2DNumeric       */
+/*****************************/
+
+class TOOLBOXQT_EXPORT Array2DNumeric
+{
+
+public:
+    enum SimdLevel
+    {
+        SIMD_NONE = 0,
+        SIMD_SSE2,
+        SIMD_AVX2
+    };
+
+public:
+    template<typename T>
+    using SumType = typename std::conditional<std::is_floating_point<T>::value, double, qint64>::type;
+
+    template<typename T>
+    using Value = typename std::common_type<T>::type;
+
+    template<typename T>
+    using IsSupported = std::integral_constant<bool,
+        std::is_same<T, quint8>::value || std::is_same<T, quint16>::value || std::is_same<T, qint32>::value ||
+        std::is_same<T, float>::value || std::is_same<T, double>::value>;
+
+public:
+    static SimdLevel getSimdLevel();
+
+public:
+    template<typename T>
+    static void fill(T *data, size_t size, T value);
+
+    template<typename T>
+    static void add(T *data, size_t size, T value);
+    template<typename T>
+    static void add(T *data, const T *other, size_t size);
+
+    template<typename T>
+    static void mul(T *data, size_t size, T value);
+    template<typename T>
+    static void mul(T *data, const T *other, size_t size);
+
+    template<typename T>
+    static void clamp(T *data, size_t size, T lower, T upper);
+
+    template<typename T>
+    static bool minMax(const T *data, size_t size, T &min, T &max);
+    template<typename T>
+    static size_t argMax(const T *data, size_t size);
+
+    template<typename T>
+    static SumType<T> sum(const T *data, size_t size);
+    template<typename T>
+    static double mean(const T *data, size_t size);
+    template<typename T>
+    static double variance(const T *data, size_t size);
+
+    template<typename T>
+    static void histogram(const T *data, size_t size, T lower, T upper, quint64 *bins, size_t nbBins);
+
+public:
+    template<typename T, typename Layout, typename Allocator>
+    static void fill(Array2D<T, Layout, Allocator> &array, Value<T> value);
+
+    template<typename T, typename Layout, typename Allocator>
+    static void add(Array2D<T, Layout, Allocator> &array, Value<T> value);
+    template<typename T, typename Layout, typename Allocator, typename OtherAllocator>
+    static bool add(Array2D<T, Layout, Allocator> &array, const Array2D<T, Layout, OtherAllocator> &other);
+
+    template<typename T, typename Layout, typename Allocator>
+    static void mul(Array2D<T, Layout, Allocator> &array, Value<T> value);
+    template<typename T, typename Layout, typename Allocator, typename OtherAllocator>
+    static bool mul(Array2D<T, Layout, Allocator> &array, const Array2D<T, Layout, OtherAllocator> &other);
+
+    template<typename T, typename Layout, typename Allocator>
+    static void clamp(Array2D<T, Layout, Allocator> &array, Value<T> lower, Value<T> upper);
+
+    template<typename T, typename Layout, typename Allocator>
+    static bool minMax(const Array2D<T, Layout, Allocator> &array, T &min, T &max);
+    template<typename T, typename Layout, typename Allocator>
+    static bool argMax(const Array2D<T, Layout, Allocator> &array, size_t &row, size_t &col);
+
+    template<typename T, typename Layout, typename Allocator>
+    static SumType<T> sum(const Array2D<T, Layout, Allocator> &array);
+    template<typename T, typename Layout, typename Allocator>
+    static double mean(const Array2D<T, Layout, Allocator> &array);
+    template<typename T, typename Layout, typename Allocator>
+    static double variance(const Array2D<T, Layout, Allocator> &array);
+
+    template<typename T, typename Layout, typename Allocator>
+    static QVector<quint64> histogram(const Array2D<T, Layout, Allocator> &array, int nbBins, Value<T> lower, Value<T> upper);
+};
+
+/*****************************/
+/*   Template definitions    */
+/*****************************/
+
+/*!
+ * \brief Set all elements of a 2D array to a value
+ *
+ * \param[out] array
+ * Array to fill.
+ * \param[in] value
+ * Value to use.
+ */
+template<typename T, typename Layout, typename Allocator>
+void Array2DNumeric::fill(Array2D<T, Layout, Allocator> &array, Value<T> value)
+{
+    static_assert(IsSupported<T>::value, "Array2DNumeric supports quint8, quint16, qint32, float and double elements");
+
+    fill(array.data(), array.getSize(), value);
+}
+
+/*!
+ * \brief Add a value to all elements of a 2D array
+ *
+ * \param[in, out] array
+ * Array to modify.
+ * \param[in] value
+ * Value to add.
+ */
+template<typename T, typename Layout, typename Allocator>
+void Array2DNumeric::add(Array2D<T, Layout, Allocator> &array, Value<T> value)
+{
+    static_assert(IsSupported<T>::value, "Array2DNumeric supports quint8, quint16, qint32, float and double elements");
+
+    add(array.data(), array.getSize(), value);
+}
+
+/*!
+ * \brief Add elements of a 2D array to elements
+ * of another one
+ *
+ * \param[in, out] array
+ * Array to modify.
+ * \param[in] other
+ * Array to add, can be \c array.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if arrays sizes differ.
+ */
+template<typename T, typename Layout, typename Allocator, typename OtherAllocator>
+bool Array2DNumeric::add(Array2D<T, Layout, Allocator> &array, const Array2D<T, Layout, OtherAllocator> &other)
+{
+    static_assert(IsSupported<T>::value, "Array2DNumeric supports quint8, quint16, qint32, float and double elements");
+
+    if(array.getRows() != other.getRows() || array.getCols() != other.getCols()){
+        return false;
+    }
+
+    add(array.data(), other.data(), array.getSize());
+    return true;
+}
+
+/*!
+ * \brief Multiply all elements of a 2D array by a value
+ *
+ * \param[in, out] array
+ * Array to modify.
+ * \param[in] value
+ * Factor to use.
+ */
+template<typename T, typename Layout, typename Allocator>
+void Array2DNumeric::mul(Array2D<T, Layout, Allocator> &array, Value<T> value)
+{
+    static_assert(IsSupported<T>::value, "Array2DNumeric supports quint8, quint16, qint32, float and double elements");
+
+    mul(array.data(), array.getSize(), value);
+}
+
+/*!
+ * \brief Multiply elements of a 2D array by elements
+ * of another one
+ *
+ * \param[in, out] array
+ * Array to modify.
+ * \param[in] other
+ * Array of factors, can be \c array.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if arrays sizes differ.
+ */
+template<typename T, typename Layout, typename Allocator, typename OtherAllocator>
+bool Array2DNumeric::mul(Array2D<T, Layout, Allocator> &array, const Array2D<T, Layout, OtherAllocator> &other)
+{
+    static_assert(IsSupported<T>::value, "Array2DNumeric supports quint8, quint16, qint32, float and double elements");
+
+    if(array.getRows() != other.getRows() || array.getCols() != other.getCols()){
+        return false;
+    }
+
+    mul(array.data(), other.data(), array.getSize());
+    return true;
+}
+
+/*!
+ * \brief Clamp all elements of a 2D array to a range
+ *
+ * \param[in, out] array
+ * Array to modify.
+ * \param[in] lower
+ * Lower bound of range.
+ * \param[in] upper
+ * Upper bound of range, must be greater or
+ * equal to \c lower.
+ */
+template<typename T, typename Layout, typename Allocator>
+void Array2DNumeric::clamp(Array2D<T, Layout, Allocator> &array, Value<T> lower, Value<T> upper)
+{
+    static_assert(IsSupported<T>::value, "Array2DNumeric supports quint8, quint16, qint32, float and double elements");
+
+    clamp(array.data(), array.getSize(), lower, upper);
+}
+
+/*!
+ * \brief Get minimum and maximum values of a 2D array
+ *
+ * \param[in] array
+ * Array to use.
+ * \param[out] min
+ * Minimum value.
+ * \param[out] max
+ * Maximum value.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if array is empty, \c min and
+ * \c max are not modified.
+ */
+template<typename T, typename Layout, typename Allocator>
+bool Array2DNumeric::minMax(const Array2D<T, Layout, Allocator> &array, T &min, T &max)
+{
+    static_assert(IsSupported<T>::value, "Array2DNumeric supports quint8, quint16, qint32, float and double elements");
+
+    return minMax(array.data(), array.getSize(), min, max);
+}
+
+/*!
+ * \brief Get position of maximum value of a 2D array
+ * \details
+ * When maximum value is found multiple times, first
+ * one in storage order is used.
+ *
+ * \param[in] array
+ * Array to use.
+ * \param[out] row
+ * Row index of maximum value.
+ * \param[out] col
+ * Column index of maximum value.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if array is empty, \c row and
+ * \c col are not modified.
+ */
+template<typename T, typename Layout, typename Allocator>
+bool Array2DNumeric::argMax(const Array2D<T, Layout, Allocator> &array, size_t &row, size_t &col)
+{
+    static_assert(IsSupported<T>::value, "Array2DNumeric supports quint8, quint16, qint32, float and double elements");
+
+    const size_t index = argMax(array.data(), array.getSize());
+    if(index >= array.getSize()){
+        return false;
+    }
+
+    Layout::position(index, array.getRows(), array.getCols(), row, col);
+    return true;
+}
+
+/*!
+ * \brief Compute sum of elements of a 2D array
+ *
+ * \param[in] array
+ * Array to use.
+ *
+ * \return
+ * Returns sum of elements, accumulated as \c qint64
+ * for integer types and \c double for floating-point types.
+ */
+template<typename T, typename Layout, typename Allocator>
+Array2DNumeric::SumType<T> Array2DNumeric::sum(const Array2D<T, Layout, Allocator> &array)
+{
+    static_assert(IsSupported<T>::value, "Array2DNumeric supports quint8, quint16, qint32, float and double elements");
+
+    return sum(array.data(), array.getSize());
+}
+
+/*!
+ * \brief Compute mean of elements of a 2D array
+ *
+ * \param[in] array
+ * Array to use.
+ *
+ * \return
+ * Returns mean value. \n
+ * Returns \c 0 if array is empty.
+ */
+template<typename T, typename Layout, typename Allocator>
+double Array2DNumeric::mean(const Array2D<T, Layout, Allocator> &array)
+{
+    static_assert(IsSupported<T>::value, "Array2DNumeric supports quint8, quint16, qint32, float and double elements");
+
+    return mean(array.data(), array.getSize());
+}
+
+/*!
+ * \brief Compute population variance of elements
+ * of a 2D array
+ *
+ * \param[in] array
+ * Array to use.
+ *
+ * \return
+ * Returns variance. \n
+ * Returns \c 0 if array is empty.
+ */
+template<typename T, typename Layout, typename Allocator>
+double Array2DNumeric::variance(const Array2D<T, Layout, Allocator> &array)
+{
+    static_assert(IsSupported<T>::value, "Array2DNumeric supports quint8, quint16, qint32, float and double elements");
+
+    return variance(array.data(), array.getSize());
+}
+
+/*!
+ * \brief Compute histogram of a 2D array
+ *
+ * \param[in] array
+ * Array to use.
+ * \param[in] nbBins
+ * Number of bins, range is split in bins of equal width.
+ * \param[in] lower
+ * Lower bound of range.
+ * \param[in] upper
+ * Upper bound of range (included in last bin), must be
+ * greater than \c lower.
+ *
+ * \return
+ * Returns number of elements of each bin, elements
+ * outside of range are ignored. \n
+ * Returns empty list if \c nbBins is not strictly positive.
+ */
+template<typename T, typename Layout, typename Allocator>
+QVector<quint64> Array2DNumeric::histogram(const Array2D<T, Layout, Allocator> &array, int nbBins, Value<T> lower, Value<T> upper)
+{
+    static_assert(IsSupported<T>::value, "Array2DNumeric supports quint8, quint16, qint32, float and double elements");
+
+    if(nbBins <= 0){
+        return QVector<quint64>();
+    }
+
+    QVector<quint64> bins(nbBins, 0);
+    histogram(array.data(), array.getSize(), lower, upper, bins.data(), static_cast<size_t>(nbBins));
+
+    return bins;
+}
+
+} // namespace tbq
+
+#endif // TBQ_CONTAINER_ARRAY2DNUMERIC_H
@@ -0,0 +1,513 @@
+#ifndef TBQ_CONTAINER_ARRAY2DPUBLISHER_H
+#define TBQ_CONTAINER_ARRAY2DPUBLISHER_H
+
+#include "toolboxqt/toolboxqt_global.h"
+#include "toolboxqt/containers/array2d.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/* Define template interface */
+/*****************************/
+
+/*!
+ * \class Array2DPublisher
+ * \brief Use to share 2D arrays from a producer thread to
+ * consumer threads, without locks
+ * \details
+ * Publisher owns a fixed number of buffers (slots). Producer
+ * fills a free slot and publishes it; consumers get a read-only
+ * snapshot of last published slot, which stays valid and unmodified
+ * as long as the snapshot is alive:
+ * \code{.cpp}
+ * tbq::Array2DPublisher<float> publisher;
+ *
+ * // Producer thread
+ * tbq::Array2D<float> *buffer = publisher.beginWrite();
+ * if(buffer){
+ *     buffer->resize(1024, 1024);
+ *     acquire(buffer->data());
+ *     publisher.publish();
+ * }
+ *
+ * // Consumer thread (GUI, logger...)
+ * const tbq::Array2DPublisher<float>::Snapshot snapshot = publisher.getSnapshot();
+ * if(snapshot.isValid()){
+ *     render(snapshot.getArray());
+ * }
+ * \endcode
+ *
+ * Neither producer nor consumers take a mutex: each slot has an
+ * atomic counter of snapshots using it, and producer only reuses slots
+ * which are neither published nor used by a snapshot. Slots are recycled
+ * and arrays only reallocate when their size grows, so steady-state
+ * publishing doesn't allocate.
+ *
+ * With \c n slots, producer can always write a new array as long as
+ * consumers hold at most <tt>n - 2</tt> distinct old snapshots at the
+ * same time, otherwise beginWrite() returns \c nullptr (producer is
+ * never blocked).
+ *
+ * \warning
+ * Only one producer thread is supported. Snapshots must not
+ * outlive the publisher.
+ */
+template <typename T, typename Layout = Array2DLayoutRowMajor, typename Allocator = Array2DAllocatorHeap>
+class Array2DPublisher
+{
+
+public:
+    using ArrayType = Array2D<T, Layout, Allocator>;
+
+private:
+    struct Slot
+    {
+        ArrayType array;
+        quint64 version = 0;
+        std::atomic<int> refs{0};
+    };
+
+public:
+    class Snapshot
+    {
+
+    public:
+        Snapshot();
+        Snapshot(const Snapshot &other);
+        Snapshot(Snapshot &&other) noexcept;
+        ~Snapshot();
+
+    public:
+        bool isValid() const;
+        quint64 getVersion() const;
+        const ArrayType& getArray() const;
+
+        void release();
+
+    public:
+        Snapshot& operator=(const Snapshot &other);
+        Snapshot& operator=(Snapshot &&other) noexcept;
+
+        const ArrayType& operator*() const;
+        const ArrayType* operator->() const;
+
+    private:
+        explicit Snapshot(Slot *slot);
+
+    private:
+        Slot *m_slot;
+
+        friend class Array2DPublisher;
+    };
+
+public:
+    static constexpr int SLOTS_MIN = 3;
+    static constexpr int SLOTS_DEFAULT = 4;
+
+public:
+    explicit Array2DPublisher(int nbSlots = SLOTS_DEFAULT);
+
+public:
+    int getNbSlots() const;
+    quint64 getVersion() const;
+
+public:
+    ArrayType* beginWrite();
+    bool publish();
+    bool publish(const ArrayType &array);
+
+    Snapshot getSnapshot() const;
+
+private:
+    static constexpr int SLOT_NONE = -1;
+
+private:
+    int m_nbSlots;
+    std::unique_ptr<Slot[]> m_slots;
+
+    std::atomic<int> m_current;
+    int m_writing;
+    quint64 m_version;
+
+private:
+    TOOLBOXQT_DISABLE_COPY_MOVE(Array2DPublisher)
+};
+
+template<typename T, typename Layout, typename Allocator>
+constexpr int Array2DPublisher<T, Layout, Allocator>::SLOTS_MIN;
+
+template<typename T, typename Layout, typename Allocator>
+constexpr int Array2DPublisher<T, Layout, Allocator>::SLOTS_DEFAULT;
+
+template<typename T, typename Layout, typename Allocator>
+constexpr int Array2DPublisher<T, Layout, Allocator>::SLOT_NONE;
+
+/*****************************/
+/* Define template
+ *      implementation       */
+/*****************************/
+
+/*!
+ * \brief Construct an invalid snapshot
+ */
+template<typename T, typename Layout, typename Allocator>
+Array2DPublisher<T, Layout, Allocator>::Snapshot::Snapshot()
+    : m_slot(nullptr)
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Construct a snapshot of an already acquired slot
+ *
+ * \param[in] slot
+ * Slot to use, its counter must already
+ * have been incremented.
+ */
+template<typename T, typename Layout, typename Allocator>
+Array2DPublisher<T, Layout, Allocator>::Snapshot::Snapshot(Slot *slot)
+    : m_slot(slot)
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Construct a snapshot sharing same array
+ * than another one
+ *
+ * \param[in] other
+ * Snapshot to copy.
+ */
+template<typename T, typename Layout, typename Allocator>
+Array2DPublisher<T, Layout, Allocator>::Snapshot::Snapshot(const Snapshot &other)
+    : m_slot(other.m_slot)
+{
+    if(m_slot){
+        m_slot->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/*!
+ * \brief Construct a snapshot by moving another one
+ *
+ * \param[in] other
+ * Snapshot to move, it will be invalid.
+ */
+template<typename T, typename Layout, typename Allocator>
+Array2DPublisher<T, Layout, Allocator>::Snapshot::Snapshot(Snapshot &&other) noexcept
+    : m_slot(other.m_slot)
+{
+    other.m_slot = nullptr;
+}
+
+/*!
+ * \brief Destroy snapshot, slot can be reused
+ * by producer if no more used
+ */
+template<typename T, typename Layout, typename Allocator>
+Array2DPublisher<T, Layout, Allocator>::Snapshot::~Snapshot()
+{
+    release();
+}
+
+/*!
+ * \brief Use to know if snapshot refers to an array
+ *
+ * \return
+ * Returns \c false if snapshot is default constructed, has been
+ * released, or if nothing was published yet.
+ */
+template<typename T, typename Layout, typename Allocator>
+bool Array2DPublisher<T, Layout, Allocator>::Snapshot::isValid() const
+{
+    return m_slot != nullptr;
+}
+
+/*!
+ * \brief Get version of snapshot array
+ *
+ * \return
+ * Returns version of array (see Array2DPublisher::getVersion()),
+ * \c 0 if snapshot is invalid.
+ */
+template<typename T, typename Layout, typename Allocator>
+quint64 Array2DPublisher<T, Layout, Allocator>::Snapshot::getVersion() const
+{
+    return m_slot ? m_slot->version : 0;
+}
+
+/*!
+ * \brief Get snapshot array
+ *
+ * \return
+ * Returns read-only reference to array. \n
+ * Snapshot must be valid.
+ *
+ * \sa isValid()
+ */
+template<typename T, typename Layout, typename Allocator>
+const typename Array2DPublisher<T, Layout, Allocator>::ArrayType& Array2DPublisher<T, Layout, Allocator>::Snapshot::getArray() const
+{
+    return m_slot->array;
+}
+
+/*!
+ * \brief Release snapshot before its destruction
+ * \details
+ * Snapshot will be invalid.
+ */
+template<typename T, typename Layout, typename Allocator>
+void Array2DPublisher<T, Layout, Allocator>::Snapshot::release()
+{
+    if(m_slot){
+        m_slot->refs.fetch_sub(1, std::memory_order_release);
+        m_slot = nullptr;
+    }
+}
+
+/*!
+ * \brief Copy another snapshot
+ *
+ * \param[in] other
+ * Snapshot to copy.
+ *
+ * \return
+ * Returns reference to this snapshot
+ */
+template<typename T, typename Layout, typename Allocator>
+typename Array2DPublisher<T, Layout, Allocator>::Snapshot& Array2DPublisher<T, Layout, Allocator>::Snapshot::operator=(const Snapshot &other)
+{
+    if(m_slot != other.m_slot){
+        if(other.m_slot){
+            other.m_slot->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        release();
+        m_slot = other.m_slot;
+    }
+
+    return *this;
+}
+
+/*!
+ * \brief Move another snapshot
+ *
+ * \param[in] other
+ * Snapshot to move, it will be invalid.
+ *
+ * \return
+ * Returns reference to this snapshot
+ */
+template<typename T, typename Layout, typename Allocator>
+typename Array2DPublisher<T, Layout, Allocator>::Snapshot& Array2DPublisher<T, Layout, Allocator>::Snapshot::operator=(Snapshot &&other) noexcept
+{
+    if(this != &other){
+        release();
+        m_slot = other.m_slot;
+        other.m_slot = nullptr;
+    }
+
+    return *this;
+}
+
+/*!
+ * \brief Access snapshot array
+ *
+ * \return
+ * Returns read-only reference to array. \n
+ * Snapshot must be valid.
+ */
+template<typename T, typename Layout, typename Allocator>
+const typename Array2DPublisher<T, Layout, Allocator>::ArrayType& Array2DPublisher<T, Layout, Allocator>::Snapshot::operator*() const
+{
+    return m_slot->array;
+}
+
+/*!
+ * \brief Access snapshot array
+ *
+ * \return
+ * Returns read-only pointer to array. \n
+ * Snapshot must be valid.
+ */
+template<typename T, typename Layout, typename Allocator>
+const typename Array2DPublisher<T, Layout, Allocator>::ArrayType* Array2DPublisher<T, Layout, Allocator>::Snapshot::operator->() const
+{
+    return &m_slot->array;
+}
+
+/*!
+ * \brief Construct a publisher
+ * \details
+ * Slots arrays are empty until producer resizes them.
+ *
+ * \param[in] nbSlots
+ * Number of slots. \n
+ * Values lower than \c SLOTS_MIN are raised to \c SLOTS_MIN.
+ */
+template<typename T, typename Layout, typename Allocator>
+Array2DPublisher<T, Layout, Allocator>::Array2DPublisher(int nbSlots)
+    : m_nbSlots(std::max(nbSlots, SLOTS_MIN)), m_slots(new Slot[m_nbSlots]),
+      m_current(SLOT_NONE), m_writing(SLOT_NONE), m_version(0)
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Get number of slots
+ *
+ * \return
+ * Returns number of slots
+ */
+template<typename T, typename Layout, typename Allocator>
+int Array2DPublisher<T, Layout, Allocator>::getNbSlots() const
+{
+    return m_nbSlots;
+}
+
+/*!
+ * \brief Get version of last published array
+ * \details
+ * Version is incremented at each publication,
+ * starting from \c 1.
+ *
+ * \return
+ * Returns last published version, \c 0 if nothing
+ * was published yet.
+ *
+ * \note
+ * Must be called from producer thread, consumers
+ * should use Snapshot::getVersion().
+ */
+template<typename T, typename Layout, typename Allocator>
+quint64 Array2DPublisher<T, Layout, Allocator>::getVersion() const
+{
+    return m_version;
+}
+
+/*!
+ * \brief Get a free buffer to fill
+ * \details
+ * Must be called from producer thread. Calling this
+ * method again before publish() returns same buffer.
+ *
+ * \return
+ * Returns buffer to fill. It contains an old array (content is
+ * not reset) and can be resized. \n
+ * Returns \c nullptr if all slots are used by snapshots.
+ *
+ * \sa publish()
+ */
+template<typename T, typename Layout, typename Allocator>
+typename Array2DPublisher<T, Layout, Allocator>::ArrayType* Array2DPublisher<T, Layout, Allocator>::beginWrite()
+{
+    if(m_writing != SLOT_NONE){
+        return &m_slots[m_writing].array;
+    }
+
+    /* Find a slot not published and not used by any snapshot */
+    const int current = m_current.load();
+    for(int i = 0; i < m_nbSlots; ++i){
+        if(i != current && m_slots[i].refs.load() == 0){
+            m_writing = i;
+            return &m_slots[i].array;
+        }
+    }
+
+    return nullptr;
+}
+
+/*!
+ * \brief Publish buffer returned by beginWrite()
+ * \details
+ * Next snapshots will refer to this array. Must be
+ * called from producer thread.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if no buffer is being written.
+ */
+template<typename T, typename Layout, typename Allocator>
+bool Array2DPublisher<T, Layout, Allocator>::publish()
+{
+    if(m_writing == SLOT_NONE){
+        return false;
+    }
+
+    m_slots[m_writing].version = ++m_version;
+    m_current.store(m_writing);
+    m_writing = SLOT_NONE;
+
+    return true;
+}
+
+/*!
+ * \overload
+ * \details
+ * Array is copied into a free buffer, which is
+ * then published.
+ *
+ * \param[in] array
+ * Array to publish.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if all slots are used by snapshots
+ * or if memory can't be allocated.
+ */
+template<typename T, typename Layout, typename Allocator>
+bool Array2DPublisher<T, Layout, Allocator>::publish(const ArrayType &array)
+{
+    ArrayType *buffer = beginWrite();
+    if(!buffer || !buffer->resize(array.getRows(), array.getCols())){
+        return false;
+    }
+
+    std::copy(array.data(), array.data() + array.getSize(), buffer->data());
+    return publish();
+}
+
+/*!
+ * \brief Get snapshot of last published array
+ * \details
+ * Can be called from any thread.
+ *
+ * \return
+ * Returns snapshot of last published array, invalid
+ * if nothing was published yet.
+ */
+template<typename T, typename Layout, typename Allocator>
+typename Array2DPublisher<T, Layout, Allocator>::Snapshot Array2DPublisher<T, Layout, Allocator>::getSnapshot() const
+{
+    for(;;){
+        const int current = m_current.load();
+        if(current == SLOT_NONE){
+            return Snapshot();
+        }
+
+        /*
+         * Slot is only safe once counted while still published:
+         * otherwise producer may have started to reuse it
+         */
+        Slot *slot = &m_slots[current];
+        slot->refs.fetch_add(1);
+        if(m_current.load() == current){
+            return Snapshot(slot);
+        }
+
+        slot->refs.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+} // namespace tbq
+
+#endif // TBQ_CONTAINER_ARRAY2DPUBLISHER_H
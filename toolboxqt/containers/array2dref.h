@@ -0,0 +1,526 @@
+#ifndef TBQ_CONTAINER_ARRAY2DREF_H
+#define TBQ_CONTAINER_ARRAY2DREF_H
+
+#include "toolboxqt/toolboxqt_global.h"
+#include "toolboxqt/containers/array2d.h"
+#include "toolboxqt/containers/array2dview.h"
+
+#include <QByteArray>
+#include <QImage>
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/* Define template interface */
+/*****************************/
+
+/*!
+ * \class Array2DRef
+ * \brief Use to manage a 2-dimensional array over
+ * memory which is not owned
+ */
+template <typename T>
+class Array2DRef
+{
+
+public:
+    using value_type = typename std::remove_cv<T>::type;
+    using ByteArrayRef = typename std::conditional<std::is_const<T>::value, const QByteArray&, QByteArray&>::type;
+    using ImageRef = typename std::conditional<std::is_const<T>::value, const QImage&, QImage&>::type;
+
+public:
+    explicit Array2DRef();
+    explicit Array2DRef(T *data, size_t nbRows, size_t nbCols);
+    explicit Array2DRef(T *data, size_t nbRows, size_t nbCols, size_t bytesPerRow);
+
+    operator Array2DRef<const T>() const;
+
+public:
+    static Array2DRef fromByteArray(ByteArrayRef bytes, size_t nbRows, size_t nbCols);
+    static Array2DRef fromImage(ImageRef img);
+
+public:
+    size_t getRows() const;
+    size_t getCols() const;
+    size_t getSize() const;
+    size_t getRowStride() const;
+
+    bool isValid() const;
+
+public:
+    void insert(size_t row, size_t col, const value_type &value) const;
+
+    Array2D<value_type> toArray2D() const;
+
+public:
+    T* data() const;
+
+    Array2DLineView<T> rowView(size_t row) const;
+    Array2DLineView<T> colView(size_t col) const;
+    Array2DView<T> view() const;
+    Array2DView<T> subView(size_t row, size_t col, size_t nbRows, size_t nbCols) const;
+
+public:
+    T& operator()(size_t row, size_t col) const;
+
+public: // Friends operator defined using "Making new friends" idiom (https://en.wikibooks.org/wiki/More_C%2B%2B_Idioms/Making_New_Friends)
+    friend bool operator==(const Array2DRef<T> &left, const Array2DRef<T> &right)
+    {
+        return isEqual(left.view(), right.view());
+    }
+
+    friend bool operator!=(const Array2DRef<T> &left, const Array2DRef<T> &right)
+    {
+        return !(left == right);
+    }
+
+    friend bool operator==(const Array2DRef<T> &left, const Array2D<value_type> &right)
+    {
+        return isEqual(left.view(), right.view());
+    }
+
+    friend bool operator!=(const Array2DRef<T> &left, const Array2D<value_type> &right)
+    {
+        return !(left == right);
+    }
+
+    friend bool operator==(const Array2D<value_type> &left, const Array2DRef<T> &right)
+    {
+        return right == left;
+    }
+
+    friend bool operator!=(const Array2D<value_type> &left, const Array2DRef<T> &right)
+    {
+        return !(right == left);
+    }
+
+private:
+    static bool isEqual(const Array2DView<const value_type> &left, const Array2DView<const value_type> &right);
+    static bool isAligned(const void *ptr);
+
+private:
+    Array2DView<T> m_view;
+};
+
+/*****************************/
+/* Define template
+ *      implementation       */
+/*****************************/
+
+/*!
+ * \brief Construct an invalid reference
+ */
+template<typename T>
+Array2DRef<T>::Array2DRef()
+    : m_view()
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Construct a reference over contiguous
+ * row-major memory
+ *
+ * \param[in] data
+ * Pointer to element at position <tt>(0, 0)</tt>. \n
+ * Memory is not owned and must outlive the reference.
+ * \param[in] nbRows
+ * Number of rows.
+ * \param[in] nbCols
+ * Number of colums
+ */
+template<typename T>
+Array2DRef<T>::Array2DRef(T *data, size_t nbRows, size_t nbCols)
+    : m_view(data, nbRows, nbCols, nbCols)
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Construct a reference over row-major memory
+ * with padded rows
+ * \details
+ * This is useful for buffers where rows are aligned, like
+ * \c QImage scanlines or some DMA buffers.
+ *
+ * \param[in] data
+ * Pointer to element at position <tt>(0, 0)</tt>. \n
+ * Memory is not owned and must outlive the reference.
+ * \param[in] nbRows
+ * Number of rows.
+ * \param[in] nbCols
+ * Number of colums
+ * \param[in] bytesPerRow
+ * Distance in bytes between two consecutive rows. \n
+ * Must be a multiple of <tt>sizeof(T)</tt> and at least
+ * <tt>nbCols * sizeof(T)</tt>, otherwise reference will be
+ * invalid.
+ */
+template<typename T>
+Array2DRef<T>::Array2DRef(T *data, size_t nbRows, size_t nbCols, size_t bytesPerRow)
+    : m_view()
+{
+    if(bytesPerRow % sizeof(T) != 0 || bytesPerRow / sizeof(T) < nbCols){
+        return;
+    }
+
+    m_view = Array2DView<T>(data, nbRows, nbCols, bytesPerRow / sizeof(T));
+}
+
+/*!
+ * \brief Allow implicit conversion to a read-only reference
+ */
+template<typename T>
+Array2DRef<T>::operator Array2DRef<const T>() const
+{
+    return Array2DRef<const T>(m_view.data(), m_view.getRows(), m_view.getCols(), m_view.getRowStride() * sizeof(T));
+}
+
+/*!
+ * \brief Build a reference over content of a byte array
+ * \details
+ * Useful to access a frame received from a socket without
+ * copying it.
+ *
+ * \param[in] bytes
+ * Byte array to use. \n
+ * Its content is not copied, so byte array must outlive the reference
+ * and must not be reallocated. Note that non-const byte array will
+ * be detached if shared.
+ * \param[in] nbRows
+ * Number of rows.
+ * \param[in] nbCols
+ * Number of colums
+ *
+ * \return
+ * Returns reference to the byte array content. \n
+ * Reference will be invalid if byte array is too small, if its
+ * data is not properly aligned for type \c T or if size of
+ * \c nbRows * \c nbCols elements overflows.
+ *
+ * \sa isValid()
+ */
+template<typename T>
+Array2DRef<T> Array2DRef<T>::fromByteArray(ByteArrayRef bytes, size_t nbRows, size_t nbCols)
+{
+    /* Reject dimensions whose size in bytes would overflow */
+    if(nbCols != 0 && nbRows > SIZE_MAX / nbCols / sizeof(T)){
+        return Array2DRef();
+    }
+
+    if(static_cast<size_t>(bytes.size()) < nbRows * nbCols * sizeof(T)){
+        return Array2DRef();
+    }
+
+    T *ptr = reinterpret_cast<T*>(bytes.data());
+    if(!isAligned(ptr)){
+        return Array2DRef();
+    }
+
+    return Array2DRef(ptr, nbRows, nbCols);
+}
+
+/*!
+ * \brief Build a reference over pixels of an image
+ * \details
+ * Each scanline of the image is a row, number of columns
+ * is computed from image width and depth (so a \c QImage::Format_Grayscale16
+ * image used with \c quint16 will have one column per pixel).
+ *
+ * \param[in] img
+ * Image to use. \n
+ * Its content is not copied, so image must outlive the reference.
+ * Note that non-const image will be detached if shared.
+ *
+ * \return
+ * Returns reference to the image pixels. \n
+ * Reference will be invalid if image is null or if pixel layout
+ * is not compatible with type \c T.
+ *
+ * \sa isValid()
+ */
+template<typename T>
+Array2DRef<T> Array2DRef<T>::fromImage(ImageRef img)
+{
+    if(img.isNull()){
+        return Array2DRef();
+    }
+
+    const size_t bytesPerPixels = static_cast<size_t>(img.width()) * static_cast<size_t>(img.depth()) / 8;
+    if(bytesPerPixels % sizeof(T) != 0){
+        return Array2DRef();
+    }
+
+    T *ptr = reinterpret_cast<T*>(img.bits());
+    if(!isAligned(ptr)){
+        return Array2DRef();
+    }
+
+    return Array2DRef(ptr, static_cast<size_t>(img.height()), bytesPerPixels / sizeof(T), static_cast<size_t>(img.bytesPerLine()));
+}
+
+/*!
+ * \brief Get number of rows
+ *
+ * \return
+ * Returns number of rows available
+ *
+ * \sa getCols(), getSize()
+ */
+template<typename T>
+size_t Array2DRef<T>::getRows() const
+{
+    return m_view.getRows();
+}
+
+/*!
+ * \brief Get number of columns
+ *
+ * \return
+ * Returns number of columns available
+ *
+ * \sa getRows(), getSize()
+ */
+template<typename T>
+size_t Array2DRef<T>::getCols() const
+{
+    return m_view.getCols();
+}
+
+/*!
+ * \brief Get total size of 2D array (a.k.a number
+ * of elements)
+ *
+ * \return
+ * Returns number of elements
+ *
+ * \sa getRows(), getCols()
+ */
+template<typename T>
+size_t Array2DRef<T>::getSize() const
+{
+    return m_view.getSize();
+}
+
+/*!
+ * \brief Get distance between two consecutive rows
+ *
+ * \return
+ * Returns distance in number of elements, can be greater
+ * than getCols() when rows are padded.
+ */
+template<typename T>
+size_t Array2DRef<T>::getRowStride() const
+{
+    return m_view.getRowStride();
+}
+
+/*!
+ * \brief Use to know if reference point to
+ * usable memory
+ *
+ * \return
+ * Returns \c true if valid
+ */
+template<typename T>
+bool Array2DRef<T>::isValid() const
+{
+    return m_view.data() != nullptr;
+}
+
+/*!
+ * \brief Use to insert a value at specified
+ * indexes.
+ *
+ * \param[in] row
+ * Row index to use. \n
+ * Must be valid (i.e <tt>0 <= row < getRows()</tt>).
+ * \param[in] col
+ * Column index to use. \n
+ * Must be valid (i.e <tt>0 <= col < getCols()</tt>).
+ * \param[in] value
+ * Value to insert
+ */
+template<typename T>
+void Array2DRef<T>::insert(size_t row, size_t col, const value_type &value) const
+{
+    (*this)(row, col) = value;
+}
+
+/*!
+ * \brief Copy referenced content into an owning
+ * 2D array
+ *
+ * \return
+ * Returns 2D array containing a copy of referenced elements
+ */
+template<typename T>
+Array2D<typename Array2DRef<T>::value_type> Array2DRef<T>::toArray2D() const
+{
+    Array2D<value_type> array(getRows(), getCols());
+    for(size_t row = 0; row < array.getRows(); ++row){
+        const Array2DLineView<T> line = rowView(row);
+        std::copy(line.data(), line.data() + line.getSize(), array.rowView(row).data());
+    }
+
+    return array;
+}
+
+/*!
+ * \brief Get pointer to referenced memory
+ *
+ * \return
+ * Returns pointer to element at position <tt>(0, 0)</tt>
+ */
+template<typename T>
+T* Array2DRef<T>::data() const
+{
+    return m_view.data();
+}
+
+/*!
+ * \brief Get view of a row
+ *
+ * \param[in] row
+ * Row index to use. \n
+ * Must be valid (i.e <tt>0 <= row < getRows()</tt>).
+ *
+ * \return
+ * Returns contiguous line view of the row
+ */
+template<typename T>
+Array2DLineView<T> Array2DRef<T>::rowView(size_t row) const
+{
+    return m_view.rowView(row);
+}
+
+/*!
+ * \brief Get view of a column
+ *
+ * \param[in] col
+ * Column index to use. \n
+ * Must be valid (i.e <tt>0 <= col < getCols()</tt>).
+ *
+ * \return
+ * Returns strided line view of the column
+ */
+template<typename T>
+Array2DLineView<T> Array2DRef<T>::colView(size_t col) const
+{
+    return m_view.colView(col);
+}
+
+/*!
+ * \brief Get view of the whole referenced memory
+ *
+ * \return
+ * Returns view of the array
+ */
+template<typename T>
+Array2DView<T> Array2DRef<T>::view() const
+{
+    return m_view;
+}
+
+/*!
+ * \brief Get view of a rectangular region
+ *
+ * \param[in] row
+ * Index of first row of the region.
+ * \param[in] col
+ * Index of first column of the region.
+ * \param[in] nbRows
+ * Number of rows of the region. \n
+ * Must be valid (i.e <tt>row + nbRows <= getRows()</tt>).
+ * \param[in] nbCols
+ * Number of columns of the region. \n
+ * Must be valid (i.e <tt>col + nbCols <= getCols()</tt>).
+ *
+ * \return
+ * Returns view of the region
+ */
+template<typename T>
+Array2DView<T> Array2DRef<T>::subView(size_t row, size_t col, size_t nbRows, size_t nbCols) const
+{
+    return m_view.subView(row, col, nbRows, nbCols);
+}
+
+/*!
+ * \brief Get reference to an element
+ *
+ * \param[in] row
+ * Row index to use. \n
+ * Must be valid (i.e <tt>0 <= row < getRows()</tt>).
+ * \param[in] col
+ * Column index to use. \n
+ * Must be valid (i.e <tt>0 <= col < getCols()</tt>).
+ *
+ * \return
+ * Returns reference to an element
+ */
+template<typename T>
+T& Array2DRef<T>::operator()(size_t row, size_t col) const
+{
+    return m_view(row, col);
+}
+
+/*!
+ * \brief Compare elements of two views
+ * \details
+ * Views are compared row by row, so strided
+ * views are supported.
+ *
+ * \param[in] left
+ * First view.
+ * \param[in] right
+ * Second view.
+ *
+ * \return
+ * Returns \c true if views have same size
+ * and same elements.
+ */
+template<typename T>
+bool Array2DRef<T>::isEqual(const Array2DView<const value_type> &left, const Array2DView<const value_type> &right)
+{
+    if(left.getRows() != right.getRows() || left.getCols() != right.getCols()){
+        return false;
+    }
+
+    for(size_t row = 0; row < left.getRows(); ++row){
+        const Array2DLineView<const value_type> lineLeft = left.rowView(row);
+        if(!std::equal(lineLeft.begin(), lineLeft.end(), right.rowView(row).begin())){
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Use to know if a pointer is suitably
+ * aligned to access elements of type \c T
+ *
+ * \param[in] ptr
+ * Pointer to check.
+ *
+ * \return
+ * Returns \c true if \c ptr is aligned on \c alignof(T).
+ */
+template<typename T>
+bool Array2DRef<T>::isAligned(const void *ptr)
+{
+    return reinterpret_cast<std::uintptr_t>(ptr) % alignof(T) == 0;
+}
+
+} // namespace tbq
+
+#endif // TBQ_CONTAINER_ARRAY2DREF_H
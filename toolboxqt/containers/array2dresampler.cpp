@@ -0,0 +1,507 @@
+#include "array2dresampler.h"
+
+#include "toolboxqt/containers/array2dnumeric.h"
+
+#include <cmath>
+#include <limits>
+
+/*****************************/
+/* Class documentations      */
+/*****************************/
+
+/*!
+ * \class tbq::Array2DResampler
+ * \brief Resample numeric 2-dimensional arrays
+ * to another size
+ * \details
+ * Include with:
+ * \code{.cpp}
+ * #include "toolboxqt/containers/array2dresampler.h"
+ * \endcode
+ *
+ * Unlike tbq::Array2D::resize() which only changes storage,
+ * this class interpolates elements (see tbq::Array2DResampler::Method).
+ * Supported element types are \c quint8, \c quint16, \c qint32,
+ * \c float and \c double.
+ *
+ * Source coordinates and weights of each destination row and
+ * column are precomputed in tables, which are kept and reused
+ * while source size, destination size and method don't change.
+ * An instance should thus be kept for repeated resampling of same
+ * geometry (previews refreshed every frame for example):
+ * \code{.cpp}
+ * tbq::Array2DResampler resampler(tbq::Array2DResampler::METHOD_AREA);
+ * tbq::Array2D<float> preview;
+ *
+ * // On each new frame
+ * resampler.resample(frame, preview, 256, 256);
+ * \endcode
+ *
+ * Resampling is separable: rows and columns are processed in
+ * two passes, using per-thread line buffers. Rows are processed
+ * across threads (see tbq::parallelForRows()) and inner loops are
+ * vectorized (with runtime selection of AVX2 instructions, see
+ * tbq::Array2DNumeric::getSimdLevel()).
+ *
+ * \note
+ * An instance must not be used concurrently from multiple threads.
+ */
+
+/*****************************/
+/*      Custom types
+ *     documentations        */
+/*****************************/
+
+/*!
+ * \enum tbq::Array2DResampler::Method
+ * \brief List of resampling methods
+ *
+ * \var tbq::Array2DResampler::METHOD_NEAREST
+ * Use nearest element, fastest method. Elements
+ * are not mixed.
+ *
+ * \var tbq::Array2DResampler::METHOD_BILINEAR
+ * Linear interpolation between the four nearest elements,
+ * suited for upsampling and small downsampling factors.
+ *
+ * \var tbq::Array2DResampler::METHOD_AREA
+ * Average of elements covered by each destination element,
+ * weighted by covered area. Suited for downsampling (no aliasing).
+ */
+
+/*****************************/
+/* Macro definitions         */
+/*****************************/
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#   define TBQ_RESAMPLER_DISPATCH_X86 1
+#   define TBQ_RESAMPLER_INLINE       inline __attribute__((always_inline))
+#   define TBQ_RESAMPLER_TARGET_AVX2  __attribute__((target("avx2")))
+#else
+#   define TBQ_RESAMPLER_DISPATCH_X86 0
+#   define TBQ_RESAMPLER_INLINE       inline
+#endif
+
+#if TBQ_RESAMPLER_DISPATCH_X86
+#   define TBQ_RESAMPLER_DISPATCH(kernel, ...) (isAvx2Available() ? kernel##Avx2(__VA_ARGS__) : kernel(__VA_ARGS__))
+#else
+#   define TBQ_RESAMPLER_DISPATCH(kernel, ...) kernel(__VA_ARGS__)
+#endif
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/* Kernels implementation    */
+/*****************************/
+
+template<typename T, typename Real>
+TBQ_RESAMPLER_INLINE void kernelFilter(const T *in, size_t step, const size_t *begins, const int *counts, const int *offsets, const Real *weights, size_t size, Real *out)
+{
+    for(size_t i = 0; i < size; ++i){
+        const T *ptr = in + begins[i] * step;
+        const Real *w = weights + offsets[i];
+
+        Real sum = Real(0);
+        for(int k = 0; k < counts[i]; ++k){
+            sum += static_cast<Real>(ptr[static_cast<size_t>(k) * step]) * w[k];
+        }
+        out[i] = sum;
+    }
+}
+
+template<typename T, typename Real>
+TBQ_RESAMPLER_INLINE void kernelFilter2(const T *in, size_t step, const size_t *begins, const Real *weights, size_t size, Real *out)
+{
+    /* Bilinear tables always use two elements per destination */
+    for(size_t i = 0; i < size; ++i){
+        const T *ptr = in + begins[i] * step;
+        out[i] = static_cast<Real>(ptr[0]) * weights[2 * i] + static_cast<Real>(ptr[step]) * weights[2 * i + 1];
+    }
+}
+
+template<typename T, typename Real>
+TBQ_RESAMPLER_INLINE void kernelAccumulate(const T *in, size_t step, Real weight, size_t size, Real *out)
+{
+    if(step == 1){
+        for(size_t i = 0; i < size; ++i){
+            out[i] += static_cast<Real>(in[i]) * weight;
+        }
+    }else{
+        for(size_t i = 0; i < size; ++i){
+            out[i] += static_cast<Real>(in[i * step]) * weight;
+        }
+    }
+}
+
+template<typename U, typename Real>
+TBQ_RESAMPLER_INLINE void kernelStore(const Real *in, size_t size, U *out, size_t step, std::true_type isIntegral)
+{
+    Q_UNUSED(isIntegral)
+
+    /* Comparisons are written so NaN values are mapped to lowest value */
+    const Real lowest = static_cast<Real>(std::numeric_limits<U>::lowest());
+    const Real highest = static_cast<Real>(std::numeric_limits<U>::max());
+
+    for(size_t i = 0; i < size; ++i){
+        const Real rounded = std::floor(in[i] + Real(0.5));
+        if(!(rounded > lowest)){
+            out[i * step] = std::numeric_limits<U>::lowest();
+        }else if(rounded >= highest){
+            out[i * step] = std::numeric_limits<U>::max();
+        }else{
+            out[i * step] = static_cast<U>(rounded);
+        }
+    }
+}
+
+template<typename U, typename Real>
+TBQ_RESAMPLER_INLINE void kernelStore(const Real *in, size_t size, U *out, size_t step, std::false_type isIntegral)
+{
+    Q_UNUSED(isIntegral)
+
+    if(step == 1){
+        for(size_t i = 0; i < size; ++i){
+            out[i] = static_cast<U>(in[i]);
+        }
+    }else{
+        for(size_t i = 0; i < size; ++i){
+            out[i * step] = static_cast<U>(in[i]);
+        }
+    }
+}
+
+/*****************************/
+/*  Kernels dispatch (x86)   */
+/*****************************/
+
+#if TBQ_RESAMPLER_DISPATCH_X86
+
+static bool isAvx2Available()
+{
+    static const bool available = Array2DNumeric::getSimdLevel() == Array2DNumeric::SIMD_AVX2;
+    return available;
+}
+
+template<typename T, typename Real>
+TBQ_RESAMPLER_TARGET_AVX2 void kernelFilterAvx2(const T *in, size_t step, const size_t *begins, const int *counts, const int *offsets, const Real *weights, size_t size, Real *out)
+{
+    kernelFilter(in, step, begins, counts, offsets, weights, size, out);
+}
+
+template<typename T, typename Real>
+TBQ_RESAMPLER_TARGET_AVX2 void kernelFilter2Avx2(const T *in, size_t step, const size_t *begins, const Real *weights, size_t size, Real *out)
+{
+    kernelFilter2(in, step, begins, weights, size, out);
+}
+
+template<typename T, typename Real>
+TBQ_RESAMPLER_TARGET_AVX2 void kernelAccumulateAvx2(const T *in, size_t step, Real weight, size_t size, Real *out)
+{
+    kernelAccumulate(in, step, weight, size, out);
+}
+
+template<typename U, typename Real, typename Tag>
+TBQ_RESAMPLER_TARGET_AVX2 void kernelStoreAvx2(const Real *in, size_t size, U *out, size_t step, Tag isIntegral)
+{
+    kernelStore(in, size, out, step, isIntegral);
+}
+
+#endif
+
+/*****************************/
+/* Functions implementation  */
+/*         Class             */
+/*****************************/
+
+/*!
+ * \brief Construct a resampler
+ *
+ * \param[in] method
+ * Resampling method to use.
+ */
+Array2DResampler::Array2DResampler(Method method)
+    : m_method(method)
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Get resampling method
+ *
+ * \return
+ * Returns method in use
+ */
+Array2DResampler::Method Array2DResampler::getMethod() const
+{
+    return m_method;
+}
+
+/*!
+ * \brief Set resampling method
+ * \details
+ * Coordinate tables will be computed again
+ * on next resampling.
+ *
+ * \param[in] method
+ * Resampling method to use.
+ */
+void Array2DResampler::setMethod(Method method)
+{
+    m_method = method;
+}
+
+/*!
+ * \brief Filter a source line along a table
+ *
+ * \param[in] in
+ * First element of source line.
+ * \param[in] step
+ * Distance between two consecutive elements.
+ * \param[in] table
+ * Table of destination elements.
+ * \param[out] out
+ * Filtered line, of size <tt>table.dstSize</tt>.
+ */
+template<typename T, typename Real>
+void Array2DResampler::filterLine(const T *in, size_t step, const AxisTable &table, Real *out)
+{
+    const Real *weights = getWeights(table, std::is_same<Real, float>());
+
+    if(table.method == METHOD_BILINEAR && table.srcSize > 1){
+        TBQ_RESAMPLER_DISPATCH(kernelFilter2, in, step, table.begins.constData(), weights, table.dstSize, out);
+        return;
+    }
+
+    TBQ_RESAMPLER_DISPATCH(kernelFilter, in, step, table.begins.constData(), table.counts.constData(), table.offsets.constData(), weights, table.dstSize, out);
+}
+
+/*!
+ * \brief Accumulate a weighted line
+ *
+ * \param[in] in
+ * First element of line to accumulate.
+ * \param[in] step
+ * Distance between two consecutive elements.
+ * \param[in] weight
+ * Weight of line.
+ * \param[in] size
+ * Number of elements.
+ * \param[in, out] out
+ * Accumulated line.
+ */
+template<typename T, typename Real>
+void Array2DResampler::accumulateLine(const T *in, size_t step, Real weight, size_t size, Real *out)
+{
+    TBQ_RESAMPLER_DISPATCH(kernelAccumulate, in, step, weight, size, out);
+}
+
+/*!
+ * \brief Convert and store a line to destination
+ *
+ * \param[in] in
+ * Line to store.
+ * \param[in] size
+ * Number of elements.
+ * \param[out] out
+ * First element of destination line.
+ * \param[in] step
+ * Distance between two consecutive elements of destination.
+ */
+template<typename U, typename Real>
+void Array2DResampler::storeLine(const Real *in, size_t size, U *out, size_t step)
+{
+    TBQ_RESAMPLER_DISPATCH(kernelStore, in, size, out, step, std::is_integral<U>());
+}
+
+/*!
+ * \brief Get single-precision weights of a table
+ *
+ * \param[in] table
+ * Table to use.
+ * \param[in] isFloat
+ * Tag used to select implementation.
+ *
+ * \return
+ * Returns pointer to weights
+ */
+const float* Array2DResampler::getWeights(const AxisTable &table, std::true_type isFloat)
+{
+    Q_UNUSED(isFloat)
+    return table.weightsFloat.constData();
+}
+
+/*!
+ * \brief Get double-precision weights of a table
+ *
+ * \param[in] table
+ * Table to use.
+ * \param[in] isFloat
+ * Tag used to select implementation.
+ *
+ * \return
+ * Returns pointer to weights
+ */
+const double* Array2DResampler::getWeights(const AxisTable &table, std::false_type isFloat)
+{
+    Q_UNUSED(isFloat)
+    return table.weightsDouble.constData();
+}
+
+/*!
+ * \brief Prepare coordinate table of an axis
+ * \details
+ * Table is only computed when source size, destination
+ * size or method changed since last call. \n
+ * For each destination index, table stores first source index,
+ * number of used source elements and their weights.
+ *
+ * \param[in, out] table
+ * Table to prepare.
+ * \param[in] srcSize
+ * Number of elements of source axis, must not be \c 0.
+ * \param[in] dstSize
+ * Number of elements of destination axis.
+ * \param[in] method
+ * Resampling method.
+ *
+ * \return
+ * Returns \c true if table is ready. \n
+ * Returns \c false if a size exceeds \c INT_MAX.
+ */
+bool Array2DResampler::prepareTable(AxisTable &table, size_t srcSize, size_t dstSize, Method method)
+{
+    if(table.srcSize == srcSize && table.dstSize == dstSize && table.method == method){
+        return true;
+    }
+
+    const size_t maxSize = static_cast<size_t>(std::numeric_limits<int>::max());
+    if(srcSize == 0 || srcSize > maxSize || dstSize > maxSize){
+        return false;
+    }
+
+    const int size = static_cast<int>(dstSize);
+    const double scale = static_cast<double>(srcSize) / static_cast<double>(dstSize);
+    const size_t last = srcSize - 1;
+
+    table.begins.resize(size);
+    table.counts.resize(size);
+    table.offsets.resize(size);
+    table.weightsDouble.clear();
+    table.weightsDouble.reserve(method == METHOD_AREA ? static_cast<int>(qMin(srcSize + dstSize, maxSize)) : 2 * size);
+
+    for(int i = 0; i < size; ++i){
+        table.offsets[i] = table.weightsDouble.size();
+
+        switch(method){
+            case METHOD_NEAREST:{
+                const size_t index = static_cast<size_t>(std::floor((i + 0.5) * scale));
+                table.begins[i] = qMin(index, last);
+                table.counts[i] = 1;
+                table.weightsDouble.append(1.0);
+            }break;
+
+            case METHOD_BILINEAR:{
+                if(srcSize == 1){
+                    table.begins[i] = 0;
+                    table.counts[i] = 1;
+                    table.weightsDouble.append(1.0);
+                    break;
+                }
+
+                /* Always use two elements, so filtering doesn't depend on position */
+                const double pos = qBound(0.0, (i + 0.5) * scale - 0.5, static_cast<double>(last));
+                const size_t index = qMin(static_cast<size_t>(pos), last - 1);
+                const double weight = pos - static_cast<double>(index);
+
+                table.begins[i] = index;
+                table.counts[i] = 2;
+                table.weightsDouble.append(1.0 - weight);
+                table.weightsDouble.append(weight);
+            }break;
+
+            case METHOD_AREA:{
+                const double start = i * scale;
+                const double end = qMin((i + 1) * scale, static_cast<double>(srcSize));
+                const size_t first = qMin(static_cast<size_t>(start), last);
+
+                double sum = 0.0;
+                int count = 0;
+                for(size_t index = first; index < srcSize && static_cast<double>(index) < end; ++index){
+                    const double overlap = qMin(end, index + 1.0) - qMax(start, static_cast<double>(index));
+                    if(overlap <= 0.0){
+                        break;
+                    }
+
+                    table.weightsDouble.append(overlap);
+                    sum += overlap;
+                    ++count;
+                }
+
+                /* Normalize, so constant arrays are preserved despite rounding errors */
+                for(int k = table.offsets[i]; k < table.weightsDouble.size(); ++k){
+                    table.weightsDouble[k] /= sum;
+                }
+
+                table.begins[i] = first;
+                table.counts[i] = count;
+            }break;
+
+            default:{
+                return false;
+            }
+        }
+    }
+
+    table.weightsFloat.resize(table.weightsDouble.size());
+    for(int k = 0; k < table.weightsDouble.size(); ++k){
+        table.weightsFloat[k] = static_cast<float>(table.weightsDouble[k]);
+    }
+
+    table.srcSize = srcSize;
+    table.dstSize = dstSize;
+    table.method = method;
+
+    return true;
+}
+
+/*****************************/
+/* Explicit instantiations   */
+/*****************************/
+
+template void Array2DResampler::filterLine<quint8, float>(const quint8*, size_t, const AxisTable&, float*);
+template void Array2DResampler::filterLine<quint16, float>(const quint16*, size_t, const AxisTable&, float*);
+template void Array2DResampler::filterLine<qint32, double>(const qint32*, size_t, const AxisTable&, double*);
+template void Array2DResampler::filterLine<float, float>(const float*, size_t, const AxisTable&, float*);
+template void Array2DResampler::filterLine<double, double>(const double*, size_t, const AxisTable&, double*);
+
+template void Array2DResampler::accumulateLine<quint8, float>(const quint8*, size_t, float, size_t, float*);
+template void Array2DResampler::accumulateLine<quint16, float>(const quint16*, size_t, float, size_t, float*);
+template void Array2DResampler::accumulateLine<qint32, double>(const qint32*, size_t, double, size_t, double*);
+template void Array2DResampler::accumulateLine<float, float>(const float*, size_t, float, size_t, float*);
+template void Array2DResampler::accumulateLine<double, double>(const double*, size_t, double, size_t, double*);
+
+template void Array2DResampler::storeLine<quint8, float>(const float*, size_t, quint8*, size_t);
+template void Array2DResampler::storeLine<quint16, float>(const float*, size_t, quint16*, size_t);
+template void Array2DResampler::storeLine<qint32, float>(const float*, size_t, qint32*, size_t);
+template void Array2DResampler::storeLine<float, float>(const float*, size_t, float*, size_t);
+template void Array2DResampler::storeLine<double, float>(const float*, size_t, double*, size_t);
+template void Array2DResampler::storeLine<quint8, double>(const double*, size_t, quint8*, size_t);
+template void Array2DResampler::storeLine<quint16, double>(const double*, size_t, quint16*, size_t);
+template void Array2DResampler::storeLine<qint32, double>(const double*, size_t, qint32*, size_t);
+template void Array2DResampler::storeLine<float, double>(const double*, size_t, float*, size_t);
+template void Array2DResampler::storeLine<double, double>(const double*, size_t, double*, size_t);
+
+/*****************************/
+/* End namespace             */
+/*****************************/
+
+} // namespace tbq
+
+/*****************************/
+/* End file                  */
+/*****************************/
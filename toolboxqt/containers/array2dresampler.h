@@ -0,0 +1,301 @@
+#ifndef TBQ_CONTAINER_ARRAY2DRESAMPLER_H
+#define TBQ_CONTAINER_ARRAY2DRESAMPLER_H
+
+#include "toolboxqt/toolboxqt_global.h"
+#include "toolboxqt/containers/array2d.h"
+#include "toolboxqt/containers/array2dalgorithms.h"
+
+#include <QThreadPool>
+#include <QVector>
+
+#include <type_traits>
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/*     Class definitions     */
+/*     Array2DResampler      */
+/*****************************/
+
+class TOOLBOXQT_EXPORT Array2DResampler
+{
+
+public:
+    enum Method
+    {
+        METHOD_NEAREST = 0,
+        METHOD_BILINEAR,
+        METHOD_AREA
+    };
+
+public:
+    explicit Array2DResampler(Method method = METHOD_BILINEAR);
+
+public:
+    Method getMethod() const;
+    void setMethod(Method method);
+
+public:
+    template<typename T, typename U, typename Layout, typename Allocator, typename OutAllocator>
+    bool resample(const Array2D<T, Layout, Allocator> &src, Array2D<U, Layout, OutAllocator> &dst, size_t nbRows, size_t nbCols, QThreadPool *pool = nullptr);
+
+private:
+    template<typename T>
+    using IsSupported = std::integral_constant<bool,
+        std::is_same<T, quint8>::value || std::is_same<T, quint16>::value || std::is_same<T, qint32>::value ||
+        std::is_same<T, float>::value || std::is_same<T, double>::value>;
+
+    template<typename T>
+    using RealType = typename std::conditional<std::is_same<T, float>::value || (std::is_integral<T>::value && sizeof(T) <= 2), float, double>::type;
+
+    struct AxisTable
+    {
+        size_t srcSize = 0;
+        size_t dstSize = 0;
+        Method method = METHOD_NEAREST;
+
+        QVector<size_t> begins;
+        QVector<int> counts;
+        QVector<int> offsets;
+
+        QVector<float> weightsFloat;
+        QVector<double> weightsDouble;
+    };
+
+private:
+    template<typename T, typename Real>
+    static void filterLine(const T *in, size_t step, const AxisTable &table, Real *out);
+
+    template<typename T, typename Real>
+    static void accumulateLine(const T *in, size_t step, Real weight, size_t size, Real *out);
+
+    template<typename U, typename Real>
+    static void storeLine(const Real *in, size_t size, U *out, size_t step);
+
+    template<typename T, typename U, typename Layout, typename Allocator, typename OutAllocator>
+    void resampleNearest(const Array2D<T, Layout, Allocator> &src, Array2D<U, Layout, OutAllocator> &dst, QThreadPool *pool) const;
+
+    template<typename T, typename U, typename Layout, typename Allocator, typename OutAllocator>
+    void resampleWeighted(const Array2D<T, Layout, Allocator> &src, Array2D<U, Layout, OutAllocator> &dst, QThreadPool *pool) const;
+
+    static const float* getWeights(const AxisTable &table, std::true_type isFloat);
+    static const double* getWeights(const AxisTable &table, std::false_type isFloat);
+
+    static bool prepareTable(AxisTable &table, size_t srcSize, size_t dstSize, Method method);
+
+private:
+    Method m_method;
+
+    AxisTable m_tableRows;
+    AxisTable m_tableCols;
+};
+
+/*****************************/
+/*   Template definitions    */
+/*****************************/
+
+/*!
+ * \brief Resample a 2D array to another size
+ * \details
+ * Element at position <tt>(row, col)</tt> of \c dst is computed
+ * from elements of \c src around <tt>((row + 0.5) * srcRows / nbRows - 0.5,
+ * (col + 0.5) * srcCols / nbCols - 0.5)</tt>, depending on method (see
+ * tbq::Array2DResampler::Method).
+ *
+ * \param[in] src
+ * Array to resample, must not be empty.
+ * \param[out] dst
+ * Resampled array, must be a different object than \c src. \n
+ * Results are rounded and saturated when \c U is an integer type.
+ * \param[in] nbRows
+ * Number of rows of resampled array.
+ * \param[in] nbCols
+ * Number of columns of resampled array.
+ * \param[in] pool
+ * Thread pool to use, if \c nullptr, \c QThreadPool::globalInstance()
+ * will be used.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if \c src is empty, if \c src and \c dst are the
+ * same object, if a size exceeds \c INT_MAX or if memory can't
+ * be allocated.
+ */
+template<typename T, typename U, typename Layout, typename Allocator, typename OutAllocator>
+bool Array2DResampler::resample(const Array2D<T, Layout, Allocator> &src, Array2D<U, Layout, OutAllocator> &dst, size_t nbRows, size_t nbCols, QThreadPool *pool)
+{
+    static_assert(IsSupported<T>::value && IsSupported<U>::value, "Array2DResampler supports quint8, quint16, qint32, float and double elements");
+
+    if(src.getSize() == 0 || static_cast<const void*>(&src) == static_cast<const void*>(&dst)){
+        return false;
+    }
+
+    if(!prepareTable(m_tableRows, src.getRows(), nbRows, m_method) || !prepareTable(m_tableCols, src.getCols(), nbCols, m_method)){
+        return false;
+    }
+
+    if(!dst.resize(nbRows, nbCols)){
+        return false;
+    }
+
+    if(m_method == METHOD_NEAREST){
+        resampleNearest(src, dst, pool);
+    }else{
+        resampleWeighted(src, dst, pool);
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Resample with nearest element
+ * \details
+ * Elements are copied using coordinate tables,
+ * rows are processed across threads.
+ *
+ * \param[in] src
+ * Array to resample.
+ * \param[out] dst
+ * Resampled array, already resized.
+ * \param[in] pool
+ * Thread pool to use.
+ */
+template<typename T, typename U, typename Layout, typename Allocator, typename OutAllocator>
+void Array2DResampler::resampleNearest(const Array2D<T, Layout, Allocator> &src, Array2D<U, Layout, OutAllocator> &dst, QThreadPool *pool) const
+{
+    using Real = RealType<T>;
+
+    const size_t srcRows = src.getRows();
+    const size_t srcCols = src.getCols();
+    const size_t dstRows = dst.getRows();
+    const size_t dstCols = dst.getCols();
+
+    const T *in = src.data();
+    U *out = dst.data();
+    const size_t inStep = Layout::colStride(srcRows, srcCols);
+    const size_t outStep = Layout::colStride(dstRows, dstCols);
+    const size_t *begins = m_tableCols.begins.constData();
+
+    parallelForRows(dstRows, dstCols, [&](size_t rowBegin, size_t rowEnd){
+        QVector<Real> converted(std::is_same<T, U>::value ? 0 : static_cast<int>(dstCols));
+
+        for(size_t row = rowBegin; row < rowEnd; ++row){
+            const T *lineIn = in + Layout::index(m_tableRows.begins[static_cast<int>(row)], 0, srcRows, srcCols);
+            U *lineOut = out + Layout::index(row, 0, dstRows, dstCols);
+
+            /* Elements of same type are copied, others are converted with rounding and saturation */
+            if(std::is_same<T, U>::value){
+                for(size_t col = 0; col < dstCols; ++col){
+                    lineOut[col * outStep] = static_cast<U>(lineIn[begins[col] * inStep]);
+                }
+            }else{
+                for(size_t col = 0; col < dstCols; ++col){
+                    converted[static_cast<int>(col)] = static_cast<Real>(lineIn[begins[col] * inStep]);
+                }
+                storeLine(converted.constData(), dstCols, lineOut, outStep);
+            }
+        }
+    }, pool);
+}
+
+/*!
+ * \brief Resample with weighted sums of elements
+ * (bilinear and area methods)
+ * \details
+ * When number of rows decreases, used rows of \c src are first
+ * accumulated with weights of destination row, then accumulated row
+ * is filtered along columns: each source element is read once, and
+ * filtering is only performed once per destination row. \n
+ * Otherwise, used rows of \c src are first filtered along columns,
+ * then accumulated. The two last filtered rows are kept, so rows shared
+ * by consecutive destination rows are only filtered once. \n
+ * Rows are processed across threads.
+ *
+ * \param[in] src
+ * Array to resample.
+ * \param[out] dst
+ * Resampled array, already resized.
+ * \param[in] pool
+ * Thread pool to use.
+ */
+template<typename T, typename U, typename Layout, typename Allocator, typename OutAllocator>
+void Array2DResampler::resampleWeighted(const Array2D<T, Layout, Allocator> &src, Array2D<U, Layout, OutAllocator> &dst, QThreadPool *pool) const
+{
+    using Real = RealType<T>;
+
+    const size_t srcRows = src.getRows();
+    const size_t srcCols = src.getCols();
+    const size_t dstRows = dst.getRows();
+    const size_t dstCols = dst.getCols();
+
+    const T *in = src.data();
+    U *out = dst.data();
+    const size_t inStep = Layout::colStride(srcRows, srcCols);
+    const size_t outStep = Layout::colStride(dstRows, dstCols);
+    const Real *weightsRows = getWeights(m_tableRows, std::is_same<Real, float>());
+
+    if(dstRows < srcRows){
+        parallelForRows(dstRows, dstCols, [&](size_t rowBegin, size_t rowEnd){
+            QVector<Real> accumulated(static_cast<int>(srcCols));
+            QVector<Real> filtered(static_cast<int>(dstCols));
+
+            for(size_t row = rowBegin; row < rowEnd; ++row){
+                const int idRow = static_cast<int>(row);
+                const size_t begin = m_tableRows.begins[idRow];
+                const Real *weights = weightsRows + m_tableRows.offsets[idRow];
+
+                std::fill(accumulated.begin(), accumulated.end(), Real(0));
+                for(int k = 0; k < m_tableRows.counts[idRow]; ++k){
+                    accumulateLine(in + Layout::index(begin + static_cast<size_t>(k), 0, srcRows, srcCols), inStep, weights[k], srcCols, accumulated.data());
+                }
+
+                filterLine(accumulated.constData(), 1, m_tableCols, filtered.data());
+                storeLine(filtered.constData(), dstCols, out + Layout::index(row, 0, dstRows, dstCols), outStep);
+            }
+        }, pool);
+
+        return;
+    }
+
+    parallelForRows(dstRows, dstCols, [&](size_t rowBegin, size_t rowEnd){
+        const int size = static_cast<int>(dstCols);
+        QVector<Real> accumulated(size);
+        QVector<Real> filtered[2] = {QVector<Real>(size), QVector<Real>(size)};
+        size_t filteredRows[2] = {srcRows, srcRows};
+        int idOldest = 0;
+
+        for(size_t row = rowBegin; row < rowEnd; ++row){
+            const int idRow = static_cast<int>(row);
+            const size_t begin = m_tableRows.begins[idRow];
+            const int count = m_tableRows.counts[idRow];
+            const Real *weights = weightsRows + m_tableRows.offsets[idRow];
+
+            std::fill(accumulated.begin(), accumulated.end(), Real(0));
+
+            for(int k = 0; k < count; ++k){
+                const size_t srcRow = begin + static_cast<size_t>(k);
+
+                int idFiltered = filteredRows[0] == srcRow ? 0 : (filteredRows[1] == srcRow ? 1 : -1);
+                if(idFiltered < 0){
+                    idFiltered = idOldest;
+                    filterLine(in + Layout::index(srcRow, 0, srcRows, srcCols), inStep, m_tableCols, filtered[idFiltered].data());
+                    filteredRows[idFiltered] = srcRow;
+                }
+                idOldest = 1 - idFiltered;
+
+                accumulateLine(filtered[idFiltered].constData(), 1, weights[k], dstCols, accumulated.data());
+            }
+
+            storeLine(accumulated.constData(), dstCols, out + Layout::index(row, 0, dstRows, dstCols), outStep);
+        }
+    }, pool);
+}
+
+} // namespace tbq
+
+#endif // TBQ_CONTAINER_ARRAY2DRESAMPLER_H
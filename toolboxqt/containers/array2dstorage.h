@@ -0,0 +1,442 @@
+#ifndef TBQ_CONTAINER_ARRAY2DSTORAGE_H
+#define TBQ_CONTAINER_ARRAY2DSTORAGE_H
+
+#include "toolboxqt/toolboxqt_global.h"
+#include "toolboxqt/containers/array2dallocator.h"
+
+#include <QtGlobal>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <utility>
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/* Define template interface */
+/*****************************/
+
+/*!
+ * \class Array2DStorage
+ * \brief Contiguous storage of elements used by tbq::Array2D
+ * \details
+ * Unlike \c QVector on Qt 5 (which is indexed by \c int), number of
+ * elements is a \c size_t, so storage can hold more than
+ * <tt>2^31</tt> elements on 64-bits platforms with Qt 5 and Qt 6. \n
+ * Allocation failures and size overflows are reported by resize()
+ * instead of aborting or silently wrapping.
+ *
+ * Copies are deep copies (no implicit sharing), so accessing elements
+ * never triggers a detach.
+ *
+ * Memory is provided by \c Allocator policy, which can be
+ * tbq::Array2DAllocatorHeap (default), tbq::Array2DAllocatorAligned
+ * or tbq::Array2DAllocatorPool.
+ */
+template <typename T, typename Allocator = Array2DAllocatorHeap>
+class Array2DStorage
+{
+
+public:
+    explicit Array2DStorage();
+    Array2DStorage(const Array2DStorage &other);
+    Array2DStorage(Array2DStorage &&other) noexcept;
+    ~Array2DStorage();
+
+public:
+    size_t getSize() const;
+    size_t getCapacity() const;
+
+    static size_t getMaxSize();
+
+public:
+    void clear();
+    bool resize(size_t size);
+
+    void swap(Array2DStorage &other) noexcept;
+
+public:
+    T* data();
+    const T* data() const;
+
+public:
+    Array2DStorage& operator=(const Array2DStorage &other);
+    Array2DStorage& operator=(Array2DStorage &&other) noexcept;
+
+    T& operator[](size_t index);
+    const T& operator[](size_t index) const;
+
+public: // Friends operator defined using "Making new friends" idiom (https://en.wikibooks.org/wiki/More_C%2B%2B_Idioms/Making_New_Friends)
+    friend bool operator==(const Array2DStorage &left, const Array2DStorage &right)
+    {
+        return left.m_size == right.m_size
+            && std::equal(left.m_data, left.m_data + left.m_size, right.m_data);
+    }
+
+    friend bool operator!=(const Array2DStorage &left, const Array2DStorage &right)
+    {
+        return !(left == right);
+    }
+
+private:
+    static T* allocate(size_t capacity);
+    static void destroy(T *first, T *last);
+
+    void release();
+
+private:
+    T *m_data;
+    size_t m_size;
+    size_t m_capacity;
+};
+
+/*****************************/
+/* Define template
+ *      implementation       */
+/*****************************/
+
+/*!
+ * \brief Construct an empty storage
+ */
+template<typename T, typename Allocator>
+Array2DStorage<T, Allocator>::Array2DStorage()
+    : m_data(nullptr), m_size(0), m_capacity(0)
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Construct a copy of a storage
+ * \details
+ * Only elements are copied, capacity of the copy
+ * is its number of elements.
+ *
+ * \param[in] other
+ * Storage to copy.
+ */
+template<typename T, typename Allocator>
+Array2DStorage<T, Allocator>::Array2DStorage(const Array2DStorage &other)
+    : m_data(nullptr), m_size(0), m_capacity(0)
+{
+    if(other.m_size == 0){
+        return;
+    }
+
+    m_data = allocate(other.m_size);
+    Q_CHECK_PTR(m_data);
+
+    std::uninitialized_copy(other.m_data, other.m_data + other.m_size, m_data);
+    m_size = other.m_size;
+    m_capacity = other.m_size;
+}
+
+/*!
+ * \brief Construct a storage by taking elements of another one
+ *
+ * \param[in, out] other
+ * Storage to move, will be empty after the call.
+ */
+template<typename T, typename Allocator>
+Array2DStorage<T, Allocator>::Array2DStorage(Array2DStorage &&other) noexcept
+    : m_data(other.m_data), m_size(other.m_size), m_capacity(other.m_capacity)
+{
+    other.m_data = nullptr;
+    other.m_size = 0;
+    other.m_capacity = 0;
+}
+
+template<typename T, typename Allocator>
+Array2DStorage<T, Allocator>::~Array2DStorage()
+{
+    release();
+}
+
+/*!
+ * \brief Get number of elements
+ *
+ * \return
+ * Returns number of elements
+ */
+template<typename T, typename Allocator>
+size_t Array2DStorage<T, Allocator>::getSize() const
+{
+    return m_size;
+}
+
+/*!
+ * \brief Get number of elements which can be stored
+ * without allocation
+ *
+ * \return
+ * Returns capacity of storage
+ */
+template<typename T, typename Allocator>
+size_t Array2DStorage<T, Allocator>::getCapacity() const
+{
+    return m_capacity;
+}
+
+/*!
+ * \brief Get maximum number of elements which
+ * can be requested
+ *
+ * \return
+ * Returns maximum number of elements, allocation
+ * of this size may still fail.
+ */
+template<typename T, typename Allocator>
+size_t Array2DStorage<T, Allocator>::getMaxSize()
+{
+    return static_cast<size_t>(std::numeric_limits<std::ptrdiff_t>::max()) / sizeof(T);
+}
+
+/*!
+ * \brief Remove all elements
+ *
+ * \note
+ * This method doesn't release allocated memory.
+ */
+template<typename T, typename Allocator>
+void Array2DStorage<T, Allocator>::clear()
+{
+    destroy(m_data, m_data + m_size);
+    m_size = 0;
+}
+
+/*!
+ * \brief Set number of elements
+ * \details
+ * Existing elements are kept, new elements are
+ * value-initialized (\c 0 for arithmetic types).
+ *
+ * \param[in] size
+ * Number of elements to use.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if \c size is greater than getMaxSize() or
+ * if allocation failed, storage is left unchanged.
+ *
+ * \note
+ * This method will only extend capacity of the storage,
+ * no shrink operation will be performed.
+ */
+template<typename T, typename Allocator>
+bool Array2DStorage<T, Allocator>::resize(size_t size)
+{
+    /* Shrink or grow within capacity */
+    if(size <= m_capacity){
+        if(size < m_size){
+            destroy(m_data + size, m_data + m_size);
+        }else{
+            for(T *it = m_data + m_size; it != m_data + size; ++it){
+                new (it) T();
+            }
+        }
+
+        m_size = size;
+        return true;
+    }
+
+    /* Reallocate */
+    if(size > getMaxSize()){
+        return false;
+    }
+
+    T *data = allocate(size);
+    if(!data){
+        return false;
+    }
+
+    for(size_t i = 0; i < m_size; ++i){
+        new (data + i) T(std::move(m_data[i]));
+    }
+    for(size_t i = m_size; i < size; ++i){
+        new (data + i) T();
+    }
+
+    release();
+    m_data = data;
+    m_size = size;
+    m_capacity = size;
+
+    return true;
+}
+
+/*!
+ * \brief Swap content with another storage
+ *
+ * \param[in, out] other
+ * Storage to swap with.
+ */
+template<typename T, typename Allocator>
+void Array2DStorage<T, Allocator>::swap(Array2DStorage &other) noexcept
+{
+    std::swap(m_data, other.m_data);
+    std::swap(m_size, other.m_size);
+    std::swap(m_capacity, other.m_capacity);
+}
+
+/*!
+ * \brief Get pointer to first element
+ *
+ * \return
+ * Returns pointer to first element, \c nullptr
+ * may be returned if storage is empty.
+ */
+template<typename T, typename Allocator>
+T* Array2DStorage<T, Allocator>::data()
+{
+    return m_data;
+}
+
+/*!
+ * \overload
+ */
+template<typename T, typename Allocator>
+const T* Array2DStorage<T, Allocator>::data() const
+{
+    return m_data;
+}
+
+/*!
+ * \brief Copy elements of another storage
+ * \details
+ * Allocated memory is reused when capacity is
+ * large enough.
+ *
+ * \param[in] other
+ * Storage to copy.
+ *
+ * \return
+ * Returns reference to this storage
+ */
+template<typename T, typename Allocator>
+Array2DStorage<T, Allocator>& Array2DStorage<T, Allocator>::operator=(const Array2DStorage &other)
+{
+    if(this == &other){
+        return *this;
+    }
+
+    if(other.m_size <= m_capacity){
+        clear();
+        std::uninitialized_copy(other.m_data, other.m_data + other.m_size, m_data);
+        m_size = other.m_size;
+    }else{
+        Array2DStorage copy(other);
+        swap(copy);
+    }
+
+    return *this;
+}
+
+/*!
+ * \brief Take elements of another storage
+ *
+ * \param[in, out] other
+ * Storage to move, will be empty after the call.
+ *
+ * \return
+ * Returns reference to this storage
+ */
+template<typename T, typename Allocator>
+Array2DStorage<T, Allocator>& Array2DStorage<T, Allocator>::operator=(Array2DStorage &&other) noexcept
+{
+    Array2DStorage moved(std::move(other));
+    swap(moved);
+
+    return *this;
+}
+
+/*!
+ * \brief Get modifiable reference to an element
+ *
+ * \param[in] index
+ * Index of element. \n
+ * Must be valid (i.e <tt>0 <= index < getSize()</tt>).
+ *
+ * \return
+ * Returns modifiable reference to an element
+ */
+template<typename T, typename Allocator>
+T& Array2DStorage<T, Allocator>::operator[](size_t index)
+{
+    return m_data[index];
+}
+
+/*!
+ * \brief Get constant reference to an element
+ *
+ * \param[in] index
+ * Index of element. \n
+ * Must be valid (i.e <tt>0 <= index < getSize()</tt>).
+ *
+ * \return
+ * Returns constant reference to an element
+ */
+template<typename T, typename Allocator>
+const T& Array2DStorage<T, Allocator>::operator[](size_t index) const
+{
+    return m_data[index];
+}
+
+/*!
+ * \brief Allocate uninitialized memory
+ *
+ * \param[in] capacity
+ * Number of elements to allocate. \n
+ * Must be valid (i.e <tt>0 < capacity <= getMaxSize()</tt>).
+ *
+ * \return
+ * Returns allocated memory. \n
+ * Returns \c nullptr if allocation failed.
+ */
+template<typename T, typename Allocator>
+T* Array2DStorage<T, Allocator>::allocate(size_t capacity)
+{
+    return static_cast<T*>(Allocator::allocate(capacity * sizeof(T)));
+}
+
+/*!
+ * \brief Destroy a range of elements
+ *
+ * \param[in] first
+ * First element to destroy.
+ * \param[in] last
+ * Element after last element to destroy.
+ */
+template<typename T, typename Allocator>
+void Array2DStorage<T, Allocator>::destroy(T *first, T *last)
+{
+    for(; first != last; ++first){
+        first->~T();
+    }
+}
+
+/*!
+ * \brief Destroy all elements and release memory
+ */
+template<typename T, typename Allocator>
+void Array2DStorage<T, Allocator>::release()
+{
+    destroy(m_data, m_data + m_size);
+    if(m_data){
+        Allocator::deallocate(m_data, m_capacity * sizeof(T));
+    }
+
+    m_data = nullptr;
+    m_size = 0;
+    m_capacity = 0;
+}
+
+} // namespace tbq
+
+#endif // TBQ_CONTAINER_ARRAY2DSTORAGE_H
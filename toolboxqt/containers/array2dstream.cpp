@@ -0,0 +1,527 @@
+#include "array2dstream.h"
+
+#include <QtEndian>
+
+#include <cstring>
+
+/*****************************/
+/* Class documentations      */
+/*****************************/
+
+/*!
+ * \class tbq::Array2DIo
+ * \brief Used to save and load 2-dimensional arrays
+ * \details
+ * Include with:
+ * \code{.cpp}
+ * #include "toolboxqt/containers/array2dstream.h"
+ * \endcode
+ *
+ * Two I/O paths are available:
+ * - \c QDataStream operators, portable between hosts. Elements of
+ * arithmetic types are streamed by blocks: as a single block when native
+ * representation matches the stream configuration, otherwise converted
+ * (byte order and floating-point precision) by chunks.
+ * - Raw save()/load() methods, which write native representation
+ * of elements in a single block after a tbq::Array2DFileHeader. Files
+ * can then be opened with tbq::Array2DMapped. For arrays too large to
+ * be written at once, tbq::Array2DStreamWriter and tbq::Array2DStreamReader
+ * use the same format band of rows by band of rows.
+ *
+ * \code{.cpp}
+ * tbq::Array2D<double> snapshot(2048, 2048);
+ * tbq::Array2DIo::save("snapshot.a2d", snapshot);
+ *
+ * // Write a huge grid band by band
+ * QFile file("huge.a2d");
+ * file.open(QIODevice::WriteOnly);
+ *
+ * tbq::Array2DStreamWriter<float> writer;
+ * writer.open(&file, nbRows, nbCols);
+ * while(writer.getRowsRemaining() > 0){
+ *     const tbq::Array2D<float> band = computeNextBand();
+ *     writer.writeRows(band.view());
+ * }
+ * writer.close();
+ * \endcode
+ */
+
+/*****************************/
+/* Macro definitions         */
+/*****************************/
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/* Constants definitions     */
+/*****************************/
+static const qint64 IO_BLOCK_MAX = 1 << 30;
+
+/* Size of buffer used to convert elements to/from stream representation */
+static const qint64 IO_CHUNK_SIZE = 16 * 1024;
+
+/*****************************/
+/* Helpers implementation    */
+/*****************************/
+
+template<typename T>
+static T swapBytes(T value)
+{
+    typename QIntegerForSizeof<T>::Unsigned bits;
+    std::memcpy(&bits, &value, sizeof(T));
+    bits = qbswap(bits);
+    std::memcpy(&value, &bits, sizeof(T));
+
+    return value;
+}
+
+/* Elements are converted to Stored type, then to byte order of stream */
+template<typename T, typename Stored>
+static bool writeConverted(QDataStream &stream, const T *data, qint64 count, bool swap)
+{
+    if(std::is_same<T, Stored>::value && !swap){
+        return Array2DIo::writeBlock(stream, reinterpret_cast<const char*>(data), count * static_cast<qint64>(sizeof(T)));
+    }
+
+    Stored chunk[IO_CHUNK_SIZE / sizeof(Stored)];
+    const qint64 chunkCount = static_cast<qint64>(IO_CHUNK_SIZE / sizeof(Stored));
+
+    while(count > 0){
+        const qint64 nbElems = qMin(count, chunkCount);
+        for(qint64 i = 0; i < nbElems; ++i){
+            chunk[i] = static_cast<Stored>(data[i]);
+        }
+        if(swap){
+            for(qint64 i = 0; i < nbElems; ++i){
+                chunk[i] = swapBytes(chunk[i]);
+            }
+        }
+
+        if(!Array2DIo::writeBlock(stream, reinterpret_cast<const char*>(chunk), nbElems * static_cast<qint64>(sizeof(Stored)))){
+            return false;
+        }
+
+        data += nbElems;
+        count -= nbElems;
+    }
+
+    return true;
+}
+
+template<typename T, typename Stored>
+static bool readConverted(QDataStream &stream, T *data, qint64 count, bool swap)
+{
+    /* Elements with same representation are read in place */
+    if(std::is_same<T, Stored>::value){
+        if(!Array2DIo::readBlock(stream, reinterpret_cast<char*>(data), count * static_cast<qint64>(sizeof(T)))){
+            return false;
+        }
+        if(swap){
+            for(qint64 i = 0; i < count; ++i){
+                data[i] = swapBytes(data[i]);
+            }
+        }
+
+        return true;
+    }
+
+    Stored chunk[IO_CHUNK_SIZE / sizeof(Stored)];
+    const qint64 chunkCount = static_cast<qint64>(IO_CHUNK_SIZE / sizeof(Stored));
+
+    while(count > 0){
+        const qint64 nbElems = qMin(count, chunkCount);
+        if(!Array2DIo::readBlock(stream, reinterpret_cast<char*>(chunk), nbElems * static_cast<qint64>(sizeof(Stored)))){
+            return false;
+        }
+
+        if(swap){
+            for(qint64 i = 0; i < nbElems; ++i){
+                chunk[i] = swapBytes(chunk[i]);
+            }
+        }
+        for(qint64 i = 0; i < nbElems; ++i){
+            data[i] = static_cast<T>(chunk[i]);
+        }
+
+        data += nbElems;
+        count -= nbElems;
+    }
+
+    return true;
+}
+
+/*****************************/
+/* Functions implementation  */
+/*         Class             */
+/*****************************/
+
+/*!
+ * \brief Write a block of data to a device
+ * \details
+ * Large blocks are split, so blocks larger than
+ * \c int capacity can be written.
+ *
+ * \param[in, out] device
+ * Device to write to.
+ * \param[in] data
+ * Data to write.
+ * \param[in] size
+ * Size of data in bytes.
+ *
+ * \return
+ * Returns \c true if all data have been written.
+ */
+bool Array2DIo::writeBlock(QIODevice &device, const char *data, qint64 size)
+{
+    while(size > 0){
+        const qint64 written = device.write(data, qMin(size, IO_BLOCK_MAX));
+        if(written <= 0){
+            return false;
+        }
+
+        data += written;
+        size -= written;
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Read a block of data from a device
+ *
+ * \param[in, out] device
+ * Device to read from.
+ * \param[out] data
+ * Buffer to fill, must be at least of \c size bytes.
+ * \param[in] size
+ * Size of data to read in bytes.
+ *
+ * \return
+ * Returns \c true if all data have been read.
+ */
+bool Array2DIo::readBlock(QIODevice &device, char *data, qint64 size)
+{
+    while(size > 0){
+        qint64 nbRead = device.read(data, qMin(size, IO_BLOCK_MAX));
+        if(nbRead == 0 && device.waitForReadyRead(-1)){
+            continue;
+        }
+        if(nbRead <= 0){
+            return false;
+        }
+
+        data += nbRead;
+        size -= nbRead;
+    }
+
+    return true;
+}
+
+/*!
+ * \overload
+ * \details
+ * Stream status is set on failure.
+ */
+bool Array2DIo::writeBlock(QDataStream &stream, const char *data, qint64 size)
+{
+    while(size > 0){
+        const int sizeBlock = static_cast<int>(qMin(size, IO_BLOCK_MAX));
+        if(stream.writeRawData(data, sizeBlock) != sizeBlock){
+            stream.setStatus(QDataStream::WriteFailed);
+            return false;
+        }
+
+        data += sizeBlock;
+        size -= sizeBlock;
+    }
+
+    return true;
+}
+
+/*!
+ * \overload
+ * \details
+ * Stream status is set on failure.
+ */
+bool Array2DIo::readBlock(QDataStream &stream, char *data, qint64 size)
+{
+    while(size > 0){
+        const int sizeBlock = static_cast<int>(qMin(size, IO_BLOCK_MAX));
+        if(stream.readRawData(data, sizeBlock) != sizeBlock){
+            stream.setStatus(QDataStream::ReadPastEnd);
+            return false;
+        }
+
+        data += sizeBlock;
+        size -= sizeBlock;
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Write elements to a data stream
+ * \details
+ * Elements are written as a single block when stream
+ * representation is the native one, otherwise they are
+ * converted by chunks.
+ *
+ * \param[in, out] stream
+ * Stream to write to. \n
+ * Stream status is set on failure.
+ * \param[in] data
+ * Elements to write.
+ * \param[in] count
+ * Number of elements.
+ *
+ * \return
+ * Returns \c true if all elements have been written.
+ */
+bool Array2DIo::writeElements(QDataStream &stream, const qint8 *data, qint64 count)
+{
+    return writeConverted<qint8, qint8>(stream, data, count, false);
+}
+
+/*!
+ * \overload
+ */
+bool Array2DIo::writeElements(QDataStream &stream, const quint8 *data, qint64 count)
+{
+    return writeConverted<quint8, quint8>(stream, data, count, false);
+}
+
+/*!
+ * \overload
+ */
+bool Array2DIo::writeElements(QDataStream &stream, const qint16 *data, qint64 count)
+{
+    return writeConverted<qint16, qint16>(stream, data, count, !isNativeByteOrder(stream));
+}
+
+/*!
+ * \overload
+ */
+bool Array2DIo::writeElements(QDataStream &stream, const quint16 *data, qint64 count)
+{
+    return writeConverted<quint16, quint16>(stream, data, count, !isNativeByteOrder(stream));
+}
+
+/*!
+ * \overload
+ */
+bool Array2DIo::writeElements(QDataStream &stream, const qint32 *data, qint64 count)
+{
+    return writeConverted<qint32, qint32>(stream, data, count, !isNativeByteOrder(stream));
+}
+
+/*!
+ * \overload
+ */
+bool Array2DIo::writeElements(QDataStream &stream, const quint32 *data, qint64 count)
+{
+    return writeConverted<quint32, quint32>(stream, data, count, !isNativeByteOrder(stream));
+}
+
+/*!
+ * \overload
+ */
+bool Array2DIo::writeElements(QDataStream &stream, const qint64 *data, qint64 count)
+{
+    return writeConverted<qint64, qint64>(stream, data, count, !isNativeByteOrder(stream));
+}
+
+/*!
+ * \overload
+ */
+bool Array2DIo::writeElements(QDataStream &stream, const quint64 *data, qint64 count)
+{
+    return writeConverted<quint64, quint64>(stream, data, count, !isNativeByteOrder(stream));
+}
+
+/*!
+ * \overload
+ */
+bool Array2DIo::writeElements(QDataStream &stream, const float *data, qint64 count)
+{
+    if(isPrecision(stream, QDataStream::DoublePrecision)){
+        return writeConverted<float, double>(stream, data, count, !isNativeByteOrder(stream));
+    }
+
+    return writeConverted<float, float>(stream, data, count, !isNativeByteOrder(stream));
+}
+
+/*!
+ * \overload
+ */
+bool Array2DIo::writeElements(QDataStream &stream, const double *data, qint64 count)
+{
+    if(isPrecision(stream, QDataStream::SinglePrecision)){
+        return writeConverted<double, float>(stream, data, count, !isNativeByteOrder(stream));
+    }
+
+    return writeConverted<double, double>(stream, data, count, !isNativeByteOrder(stream));
+}
+
+/*!
+ * \brief Read elements from a data stream
+ * \details
+ * Elements are read as a single block, then converted
+ * in place when stream byte order is not the native one. \n
+ * When floating-point precision of stream differs from
+ * precision of elements, elements are converted by chunks.
+ *
+ * \param[in, out] stream
+ * Stream to read from. \n
+ * Stream status is set on failure.
+ * \param[out] data
+ * Buffer to fill, must be at least of \c count elements.
+ * \param[in] count
+ * Number of elements.
+ *
+ * \return
+ * Returns \c true if all elements have been read.
+ */
+bool Array2DIo::readElements(QDataStream &stream, qint8 *data, qint64 count)
+{
+    return readConverted<qint8, qint8>(stream, data, count, false);
+}
+
+/*!
+ * \overload
+ */
+bool Array2DIo::readElements(QDataStream &stream, quint8 *data, qint64 count)
+{
+    return readConverted<quint8, quint8>(stream, data, count, false);
+}
+
+/*!
+ * \overload
+ */
+bool Array2DIo::readElements(QDataStream &stream, qint16 *data, qint64 count)
+{
+    return readConverted<qint16, qint16>(stream, data, count, !isNativeByteOrder(stream));
+}
+
+/*!
+ * \overload
+ */
+bool Array2DIo::readElements(QDataStream &stream, quint16 *data, qint64 count)
+{
+    return readConverted<quint16, quint16>(stream, data, count, !isNativeByteOrder(stream));
+}
+
+/*!
+ * \overload
+ */
+bool Array2DIo::readElements(QDataStream &stream, qint32 *data, qint64 count)
+{
+    return readConverted<qint32, qint32>(stream, data, count, !isNativeByteOrder(stream));
+}
+
+/*!
+ * \overload
+ */
+bool Array2DIo::readElements(QDataStream &stream, quint32 *data, qint64 count)
+{
+    return readConverted<quint32, quint32>(stream, data, count, !isNativeByteOrder(stream));
+}
+
+/*!
+ * \overload
+ */
+bool Array2DIo::readElements(QDataStream &stream, qint64 *data, qint64 count)
+{
+    return readConverted<qint64, qint64>(stream, data, count, !isNativeByteOrder(stream));
+}
+
+/*!
+ * \overload
+ */
+bool Array2DIo::readElements(QDataStream &stream, quint64 *data, qint64 count)
+{
+    return readConverted<quint64, quint64>(stream, data, count, !isNativeByteOrder(stream));
+}
+
+/*!
+ * \overload
+ */
+bool Array2DIo::readElements(QDataStream &stream, float *data, qint64 count)
+{
+    if(isPrecision(stream, QDataStream::DoublePrecision)){
+        return readConverted<float, double>(stream, data, count, !isNativeByteOrder(stream));
+    }
+
+    return readConverted<float, float>(stream, data, count, !isNativeByteOrder(stream));
+}
+
+/*!
+ * \overload
+ */
+bool Array2DIo::readElements(QDataStream &stream, double *data, qint64 count)
+{
+    if(isPrecision(stream, QDataStream::SinglePrecision)){
+        return readConverted<double, float>(stream, data, count, !isNativeByteOrder(stream));
+    }
+
+    return readConverted<double, double>(stream, data, count, !isNativeByteOrder(stream));
+}
+
+/*!
+ * \brief Use to know if stream still contains
+ * enough data for a number of elements
+ * \details
+ * Allow to reject corrupted dimensions before allocating. \n
+ * Remaining size of sequential devices can't be known, in
+ * that case elements are always considered available.
+ *
+ * \param[in] stream
+ * Stream to use.
+ * \param[in] nbElems
+ * Number of elements.
+ * \param[in] elemSize
+ * Size of an element in stream (in bytes).
+ *
+ * \return
+ * Returns \c false if stream is too small to
+ * contain elements.
+ *
+ * \sa getStreamedSize()
+ */
+bool Array2DIo::isAvailable(const QDataStream &stream, quint64 nbElems, qint64 elemSize)
+{
+    const QIODevice *device = stream.device();
+    if(!device || device->isSequential() || elemSize <= 0){
+        return true;
+    }
+
+    const qint64 available = device->bytesAvailable();
+    return available >= 0 && nbElems <= static_cast<quint64>(available) / static_cast<quint64>(elemSize);
+}
+
+bool Array2DIo::isNativeByteOrder(const QDataStream &stream)
+{
+    const QDataStream::ByteOrder nativeOrder = QSysInfo::ByteOrder == QSysInfo::BigEndian ? QDataStream::BigEndian : QDataStream::LittleEndian;
+    return stream.byteOrder() == nativeOrder;
+}
+
+/* Floating-point precision is only used since Qt 4.6 format */
+bool Array2DIo::isPrecision(const QDataStream &stream, QDataStream::FloatingPointPrecision precision)
+{
+    return stream.version() >= QDataStream::Qt_4_6
+        && stream.floatingPointPrecision() == precision;
+}
+
+/*****************************/
+/* End namespace             */
+/*****************************/
+
+} // namespace tbq
+
+/*****************************/
+/* End file                  */
+/*****************************/
@@ -0,0 +1,675 @@
+#ifndef TBQ_CONTAINER_ARRAY2DSTREAM_H
+#define TBQ_CONTAINER_ARRAY2DSTREAM_H
+
+#include "toolboxqt/toolboxqt_global.h"
+#include "toolboxqt/containers/array2d.h"
+#include "toolboxqt/containers/array2dfile.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QIODevice>
+#include <QSysInfo>
+#include <QVector>
+
+#include <type_traits>
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/*     Class definitions     */
+/*         Array2DIo         */
+/*****************************/
+
+class TOOLBOXQT_EXPORT Array2DIo
+{
+
+public:
+    template<typename T, typename Layout, typename Allocator>
+    static bool save(QIODevice &device, const Array2D<T, Layout, Allocator> &array);
+    template<typename T, typename Layout, typename Allocator>
+    static bool save(const QString &path, const Array2D<T, Layout, Allocator> &array);
+
+    template<typename T, typename Layout, typename Allocator>
+    static bool load(QIODevice &device, Array2D<T, Layout, Allocator> &array);
+    template<typename T, typename Layout, typename Allocator>
+    static bool load(const QString &path, Array2D<T, Layout, Allocator> &array);
+
+public:
+    static bool writeBlock(QIODevice &device, const char *data, qint64 size);
+    static bool readBlock(QIODevice &device, char *data, qint64 size);
+
+    static bool writeBlock(QDataStream &stream, const char *data, qint64 size);
+    static bool readBlock(QDataStream &stream, char *data, qint64 size);
+
+    static bool writeElements(QDataStream &stream, const qint8 *data, qint64 count);
+    static bool writeElements(QDataStream &stream, const quint8 *data, qint64 count);
+    static bool writeElements(QDataStream &stream, const qint16 *data, qint64 count);
+    static bool writeElements(QDataStream &stream, const quint16 *data, qint64 count);
+    static bool writeElements(QDataStream &stream, const qint32 *data, qint64 count);
+    static bool writeElements(QDataStream &stream, const quint32 *data, qint64 count);
+    static bool writeElements(QDataStream &stream, const qint64 *data, qint64 count);
+    static bool writeElements(QDataStream &stream, const quint64 *data, qint64 count);
+    static bool writeElements(QDataStream &stream, const float *data, qint64 count);
+    static bool writeElements(QDataStream &stream, const double *data, qint64 count);
+    template<typename T>
+    static bool writeElements(QDataStream &stream, const T *data, qint64 count);
+
+    static bool readElements(QDataStream &stream, qint8 *data, qint64 count);
+    static bool readElements(QDataStream &stream, quint8 *data, qint64 count);
+    static bool readElements(QDataStream &stream, qint16 *data, qint64 count);
+    static bool readElements(QDataStream &stream, quint16 *data, qint64 count);
+    static bool readElements(QDataStream &stream, qint32 *data, qint64 count);
+    static bool readElements(QDataStream &stream, quint32 *data, qint64 count);
+    static bool readElements(QDataStream &stream, qint64 *data, qint64 count);
+    static bool readElements(QDataStream &stream, quint64 *data, qint64 count);
+    static bool readElements(QDataStream &stream, float *data, qint64 count);
+    static bool readElements(QDataStream &stream, double *data, qint64 count);
+    template<typename T>
+    static bool readElements(QDataStream &stream, T *data, qint64 count);
+
+    template<typename T>
+    static qint64 getStreamedSize(const QDataStream &stream);
+    static bool isAvailable(const QDataStream &stream, quint64 nbElems, qint64 elemSize);
+
+private:
+    static bool isNativeByteOrder(const QDataStream &stream);
+    static bool isPrecision(const QDataStream &stream, QDataStream::FloatingPointPrecision precision);
+};
+
+/*****************************/
+/* Define template interface */
+/*****************************/
+
+/*!
+ * \class Array2DStreamWriter
+ * \brief Use to write a 2-dimensional array
+ * band of rows by band of rows
+ */
+template <typename T>
+class Array2DStreamWriter
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Array2DStreamWriter can only be used with trivially copyable types");
+
+public:
+    explicit Array2DStreamWriter();
+
+public:
+    bool open(QIODevice *device, size_t nbRows, size_t nbCols);
+    bool writeRows(const Array2DView<const T> &band);
+    bool close();
+
+public:
+    size_t getRowsRemaining() const;
+
+private:
+    QIODevice *m_device;
+    size_t m_cols;
+    size_t m_rowsRemaining;
+    QVector<T> m_buffer;
+};
+
+/*!
+ * \class Array2DStreamReader
+ * \brief Use to read a 2-dimensional array
+ * band of rows by band of rows
+ */
+template <typename T>
+class Array2DStreamReader
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Array2DStreamReader can only be used with trivially copyable types");
+
+public:
+    explicit Array2DStreamReader();
+
+public:
+    bool open(QIODevice *device);
+    bool readRows(Array2D<T> &band, size_t maxRows);
+
+public:
+    size_t getRows() const;
+    size_t getCols() const;
+    size_t getRowsRemaining() const;
+
+private:
+    QIODevice *m_device;
+    Array2DFileHeader m_header;
+    size_t m_rowsRemaining;
+};
+
+/*****************************/
+/*   Operators definitions   */
+/*****************************/
+
+/*!
+ * \brief Write a 2D array to a data stream
+ * \details
+ * Dimensions are written as \c quint64 followed by
+ * elements in row-major order. \n
+ * For arithmetic types, elements of row-major arrays are written
+ * by blocks, converted to stream representation (byte order and
+ * floating-point precision) by chunks when needed.
+ *
+ * \param[in, out] stream
+ * Stream to write to.
+ * \param[in] array
+ * Array to write.
+ *
+ * \return
+ * Returns reference to stream.
+ */
+template<typename T, typename Layout, typename Allocator>
+QDataStream& operator<<(QDataStream &stream, const Array2D<T, Layout, Allocator> &array)
+{
+    stream << static_cast<quint64>(array.getRows()) << static_cast<quint64>(array.getCols());
+
+    if(Layout::IS_ROW_MAJOR){
+        Array2DIo::writeElements(stream, array.data(), static_cast<qint64>(array.getSize()));
+        return stream;
+    }
+
+    for(size_t row = 0; row < array.getRows(); ++row){
+        for(size_t col = 0; col < array.getCols(); ++col){
+            stream << array(row, col);
+        }
+    }
+
+    return stream;
+}
+
+/*!
+ * \brief Read a 2D array from a data stream
+ *
+ * \details
+ * Dimensions are checked against remaining size of stream
+ * device (when not sequential) before allocating, so corrupted
+ * dimensions are rejected without allocating the array.
+ *
+ * \param[in, out] stream
+ * Stream to read from. \n
+ * Stream status is set if data are invalid or incomplete,
+ * in that case array is cleared.
+ * \param[out] array
+ * Array to read.
+ *
+ * \return
+ * Returns reference to stream.
+ */
+template<typename T, typename Layout, typename Allocator>
+QDataStream& operator>>(QDataStream &stream, Array2D<T, Layout, Allocator> &array)
+{
+    quint64 nbRows = 0;
+    quint64 nbCols = 0;
+    stream >> nbRows >> nbCols;
+
+    if(stream.status() != QDataStream::Ok){
+        array.clear();
+        return stream;
+    }
+
+    if(!Array2DFileHeader::fromType<T>(nbRows, nbCols).isValid()
+       || !Array2DIo::isAvailable(stream, nbRows * nbCols, Array2DIo::getStreamedSize<T>(stream))){
+        stream.setStatus(QDataStream::ReadCorruptData);
+        array.clear();
+        return stream;
+    }
+
+    if(!array.resize(nbRows, nbCols)){
+        stream.setStatus(QDataStream::ReadCorruptData);
+        array.clear();
+        return stream;
+    }
+
+    if(Layout::IS_ROW_MAJOR){
+        Array2DIo::readElements(stream, array.data(), static_cast<qint64>(array.getSize()));
+    }else{
+        for(size_t row = 0; row < array.getRows(); ++row){
+            for(size_t col = 0; col < array.getCols(); ++col){
+                stream >> array(row, col);
+            }
+        }
+    }
+
+    if(stream.status() != QDataStream::Ok){
+        array.clear();
+    }
+
+    return stream;
+}
+
+/*****************************/
+/* Define template
+ *      implementation       */
+/*****************************/
+
+/*!
+ * \overload
+ * \details
+ * Used for all other types, which are written
+ * element by element.
+ */
+template<typename T>
+bool Array2DIo::writeElements(QDataStream &stream, const T *data, qint64 count)
+{
+    for(qint64 i = 0; i < count; ++i){
+        stream << data[i];
+    }
+
+    return stream.status() == QDataStream::Ok;
+}
+
+/*!
+ * \overload
+ * \details
+ * Used for all other types, which are read
+ * element by element.
+ */
+template<typename T>
+bool Array2DIo::readElements(QDataStream &stream, T *data, qint64 count)
+{
+    for(qint64 i = 0; i < count && stream.status() == QDataStream::Ok; ++i){
+        stream >> data[i];
+    }
+
+    return stream.status() == QDataStream::Ok;
+}
+
+/*!
+ * \brief Get size used by an element in a data stream
+ * \details
+ * Size of arithmetic types depends on floating-point precision
+ * of the stream. \n
+ * For other types, size is unknown and \c 1 is returned, which
+ * is the minimum size of any streamed element.
+ *
+ * \param[in] stream
+ * Stream to use.
+ *
+ * \return
+ * Returns size of an element in bytes.
+ */
+template<typename T>
+qint64 Array2DIo::getStreamedSize(const QDataStream &stream)
+{
+    if(!std::is_arithmetic<T>::value){
+        return 1;
+    }
+
+    if(std::is_floating_point<T>::value){
+        if(isPrecision(stream, QDataStream::SinglePrecision)){
+            return static_cast<qint64>(sizeof(float));
+        }
+        if(isPrecision(stream, QDataStream::DoublePrecision)){
+            return static_cast<qint64>(sizeof(double));
+        }
+    }
+
+    return static_cast<qint64>(sizeof(T));
+}
+
+/*!
+ * \brief Save a 2D array to a device
+ * \details
+ * Array is written using format of tbq::Array2DFileHeader, so saved
+ * file can also be opened with tbq::Array2DMapped. \n
+ * Elements are written in row-major order as a single block
+ * when array layout is row-major.
+ *
+ * \param[in, out] device
+ * Device to write to.
+ * \param[in] array
+ * Array to save.
+ *
+ * \return
+ * Returns \c true if succeed.
+ *
+ * \sa load()
+ */
+template<typename T, typename Layout, typename Allocator>
+bool Array2DIo::save(QIODevice &device, const Array2D<T, Layout, Allocator> &array)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Array2DIo can only be used with trivially copyable types");
+
+    if(Layout::IS_ROW_MAJOR){
+        const Array2DFileHeader header = Array2DFileHeader::fromType<T>(array.getRows(), array.getCols());
+        return header.write(device) && writeBlock(device, reinterpret_cast<const char*>(array.data()), header.getDataSize());
+    }
+
+    return save(device, Array2D<T>(array));
+}
+
+/*!
+ * \overload
+ *
+ * \param[in] path
+ * Path of file to write, existing file will be
+ * overwritten.
+ * \param[in] array
+ * Array to save.
+ */
+template<typename T, typename Layout, typename Allocator>
+bool Array2DIo::save(const QString &path, const Array2D<T, Layout, Allocator> &array)
+{
+    QFile file(path);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate)){
+        return false;
+    }
+
+    return save(file, array);
+}
+
+/*!
+ * \brief Load a 2D array from a device
+ *
+ * \param[in, out] device
+ * Device to read from.
+ * \param[out] array
+ * Loaded array. \n
+ * Array is cleared if loading fails.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if header is invalid, is not compatible with
+ * type \c T, if array can't be allocated or if data are incomplete.
+ *
+ * \sa save()
+ */
+template<typename T, typename Layout, typename Allocator>
+bool Array2DIo::load(QIODevice &device, Array2D<T, Layout, Allocator> &array)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Array2DIo can only be used with trivially copyable types");
+
+    Array2DFileHeader header;
+    if(!header.read(device) || !header.isCompatible(Array2DFileElemType<T>::value, sizeof(T))){
+        array.clear();
+        return false;
+    }
+
+    /* Storage of row-major arrays can be filled directly */
+    bool succeed = false;
+    if(Layout::IS_ROW_MAJOR){
+        succeed = array.resize(header.getRows(), header.getCols())
+               && readBlock(device, reinterpret_cast<char*>(array.data()), header.getDataSize());
+    }else{
+        Array2D<T> rowMajor;
+        succeed = rowMajor.resize(header.getRows(), header.getCols())
+               && readBlock(device, reinterpret_cast<char*>(rowMajor.data()), header.getDataSize());
+        if(succeed){
+            array = Array2D<T, Layout, Allocator>(rowMajor);
+        }
+    }
+
+    if(!succeed){
+        array.clear();
+    }
+
+    return succeed;
+}
+
+/*!
+ * \overload
+ *
+ * \param[in] path
+ * Path of file to read.
+ * \param[out] array
+ * Loaded array.
+ */
+template<typename T, typename Layout, typename Allocator>
+bool Array2DIo::load(const QString &path, Array2D<T, Layout, Allocator> &array)
+{
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly)){
+        array.clear();
+        return false;
+    }
+
+    return load(file, array);
+}
+
+/*!
+ * \brief Construct a closed writer
+ */
+template<typename T>
+Array2DStreamWriter<T>::Array2DStreamWriter()
+    : m_device(nullptr), m_cols(0), m_rowsRemaining(0)
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Start writing a 2D array
+ * \details
+ * Format is the same than tbq::Array2DIo::save(), so written
+ * array can be loaded with tbq::Array2DIo::load(), opened with
+ * tbq::Array2DMapped or read with tbq::Array2DStreamReader.
+ *
+ * \param[in, out] device
+ * Device to write to, must remain valid until close() is called.
+ * \param[in] nbRows
+ * Total number of rows which will be written.
+ * \param[in] nbCols
+ * Number of colums
+ *
+ * \return
+ * Returns \c true if header has been written.
+ */
+template<typename T>
+bool Array2DStreamWriter<T>::open(QIODevice *device, size_t nbRows, size_t nbCols)
+{
+    m_device = nullptr;
+    if(!device || !Array2DFileHeader::fromType<T>(nbRows, nbCols).write(*device)){
+        return false;
+    }
+
+    m_device = device;
+    m_cols = nbCols;
+    m_rowsRemaining = nbRows;
+
+    return true;
+}
+
+/*!
+ * \brief Write next band of rows
+ *
+ * \param[in] band
+ * Rows to write, must have the number of columns provided
+ * to open(). \n
+ * Any view can be used (for example a sub-view of a bigger array).
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if band is not compatible or if writing
+ * it would exceed number of rows provided to open().
+ */
+template<typename T>
+bool Array2DStreamWriter<T>::writeRows(const Array2DView<const T> &band)
+{
+    if(!m_device || band.getCols() != m_cols || band.getRows() > m_rowsRemaining){
+        return false;
+    }
+
+    /* Contiguous bands are written as a single block */
+    const qint64 rowSize = static_cast<qint64>(m_cols * sizeof(T));
+    if(band.isContiguous()){
+        if(!Array2DIo::writeBlock(*m_device, reinterpret_cast<const char*>(band.data()), rowSize * static_cast<qint64>(band.getRows()))){
+            return false;
+        }
+
+        m_rowsRemaining -= band.getRows();
+        return true;
+    }
+
+    /* Others are written row by row */
+    m_buffer.resize(static_cast<int>(m_cols));
+    for(size_t row = 0; row < band.getRows(); ++row){
+        const Array2DLineView<const T> line = band.rowView(row);
+        const T *rowData = line.data();
+        if(!line.isContiguous()){
+            std::copy(line.begin(), line.end(), m_buffer.begin());
+            rowData = m_buffer.constData();
+        }
+
+        if(!Array2DIo::writeBlock(*m_device, reinterpret_cast<const char*>(rowData), rowSize)){
+            return false;
+        }
+        --m_rowsRemaining;
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Terminate writing
+ *
+ * \return
+ * Returns \c true if all rows have been written.
+ */
+template<typename T>
+bool Array2DStreamWriter<T>::close()
+{
+    const bool succeed = m_device && m_rowsRemaining == 0;
+
+    m_device = nullptr;
+    m_buffer.clear();
+
+    return succeed;
+}
+
+/*!
+ * \brief Get number of rows which still need
+ * to be written
+ *
+ * \return
+ * Returns number of rows
+ */
+template<typename T>
+size_t Array2DStreamWriter<T>::getRowsRemaining() const
+{
+    return m_rowsRemaining;
+}
+
+/*!
+ * \brief Construct a closed reader
+ */
+template<typename T>
+Array2DStreamReader<T>::Array2DStreamReader()
+    : m_device(nullptr), m_header(), m_rowsRemaining(0)
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Start reading a 2D array
+ *
+ * \param[in, out] device
+ * Device to read from, must remain valid while
+ * reading rows.
+ *
+ * \return
+ * Returns \c true if header is valid and compatible with type \c T.
+ */
+template<typename T>
+bool Array2DStreamReader<T>::open(QIODevice *device)
+{
+    m_device = nullptr;
+    m_rowsRemaining = 0;
+
+    if(!device || !m_header.read(*device) || !m_header.isCompatible(Array2DFileElemType<T>::value, sizeof(T))){
+        m_header = Array2DFileHeader();
+        return false;
+    }
+
+    m_device = device;
+    m_rowsRemaining = static_cast<size_t>(m_header.getRows());
+
+    return true;
+}
+
+/*!
+ * \brief Read next band of rows
+ *
+ * \param[out] band
+ * Read rows. \n
+ * Band is resized to number of read rows, so same band can be
+ * reused between calls without any allocation.
+ * \param[in] maxRows
+ * Maximum number of rows to read.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if no rows are remaining, if band can't
+ * be allocated or if data are incomplete.
+ */
+template<typename T>
+bool Array2DStreamReader<T>::readRows(Array2D<T> &band, size_t maxRows)
+{
+    const size_t nbRows = qMin(maxRows, m_rowsRemaining);
+    if(!m_device || nbRows == 0){
+        return false;
+    }
+
+    if(!band.resize(nbRows, getCols())){
+        return false;
+    }
+
+    if(!Array2DIo::readBlock(*m_device, reinterpret_cast<char*>(band.data()), static_cast<qint64>(band.getSize() * sizeof(T)))){
+        m_device = nullptr;
+        return false;
+    }
+
+    m_rowsRemaining -= nbRows;
+    return true;
+}
+
+/*!
+ * \brief Get total number of rows
+ *
+ * \return
+ * Returns number of rows of the array
+ */
+template<typename T>
+size_t Array2DStreamReader<T>::getRows() const
+{
+    return static_cast<size_t>(m_header.getRows());
+}
+
+/*!
+ * \brief Get number of columns
+ *
+ * \return
+ * Returns number of columns of the array
+ */
+template<typename T>
+size_t Array2DStreamReader<T>::getCols() const
+{
+    return static_cast<size_t>(m_header.getCols());
+}
+
+/*!
+ * \brief Get number of rows which still need
+ * to be read
+ *
+ * \return
+ * Returns number of rows
+ */
+template<typename T>
+size_t Array2DStreamReader<T>::getRowsRemaining() const
+{
+    return m_rowsRemaining;
+}
+
+/*****************************/
+/* End namespace             */
+/*****************************/
+
+} // namespace tbq
+
+/*****************************/
+/* End file                  */
+/*****************************/
+
+#endif // TBQ_CONTAINER_ARRAY2DSTREAM_H
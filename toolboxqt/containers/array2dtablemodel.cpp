@@ -0,0 +1,392 @@
+#include "array2dtablemodel.h"
+
+/*****************************/
+/* Class documentations      */
+/*****************************/
+
+/*!
+ * \class tbq::Array2DTableModelBase
+ * \brief Base class of tbq::Array2DTableModel, managing
+ * change notifications
+ * \details
+ * Include with:
+ * \code{.cpp}
+ * #include "toolboxqt/containers/array2dtablemodel.h"
+ * \endcode
+ *
+ * Class templates can't declare signals or slots, so everything
+ * which doesn't depend on element type is implemented here.
+ *
+ * Changes of cells are not notified one by one: markDirty() only
+ * records dirty rectangles (adjacent or overlapping ones being merged),
+ * and a single \c dataChanged() signal per rectangle is emitted once
+ * control returns to event loop, or after notify interval (see
+ * setNotifyInterval()). When array is entirely replaced or resized,
+ * use resetModel() which doesn't depend on array size.
+ *
+ * Row and column counts of the model are limited to \c INT_MAX,
+ * as required by item views.
+ */
+
+/*****************************/
+/* Macro definitions         */
+/*****************************/
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/* Constants definitions     */
+/*****************************/
+
+/* Above this number of rectangles, they are merged in their bounding rectangle */
+static const int DIRTY_RECTS_MAX = 16;
+
+/*****************************/
+/* Functions implementation  */
+/*         Class             */
+/*****************************/
+
+/*!
+ * \brief Construct base of a 2D array table model
+ *
+ * \param[in] parent
+ * Parent of the model.
+ */
+Array2DTableModelBase::Array2DTableModelBase(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+    m_timerNotify = new QTimer(this); // Using "this" as parent, object will be automatically destroyed
+    m_timerNotify->setSingleShot(true);
+    m_timerNotify->setInterval(0);
+
+    connect(m_timerNotify, &QTimer::timeout, this, &Array2DTableModelBase::flushDirty);
+}
+
+/*!
+ * \brief Use to know if cells can be edited from views
+ *
+ * \return
+ * Returns \c true if editable
+ *
+ * \sa setEditable()
+ */
+bool Array2DTableModelBase::isEditable() const
+{
+    return m_editable;
+}
+
+/*!
+ * \brief Get interval used to notify dirty rectangles
+ *
+ * \return
+ * Returns interval in milliseconds
+ *
+ * \sa setNotifyInterval()
+ */
+int Array2DTableModelBase::getNotifyInterval() const
+{
+    return m_timerNotify->interval();
+}
+
+/*!
+ * \brief Set if cells can be edited from views
+ * \details
+ * Default is \c false.
+ *
+ * \param[in] editable
+ * Use \c true to allow edition.
+ */
+void Array2DTableModelBase::setEditable(bool editable)
+{
+    m_editable = editable;
+}
+
+/*!
+ * \brief Set interval used to notify dirty rectangles
+ * \details
+ * Dirty rectangles are accumulated during this interval, starting
+ * from first call to markDirty(), then notified. Increasing interval
+ * reduces view updates when array is updated at high rate. \n
+ * Default is \c 0, meaning notifications are sent once control
+ * returns to event loop.
+ *
+ * \param[in] interval
+ * Interval in milliseconds.
+ */
+void Array2DTableModelBase::setNotifyInterval(int interval)
+{
+    m_timerNotify->setInterval(qMax(interval, 0));
+}
+
+/*!
+ * \brief Mark a cell as modified
+ *
+ * \param[in] row
+ * Row index of cell.
+ * \param[in] col
+ * Column index of cell.
+ *
+ * \sa flushDirty()
+ */
+void Array2DTableModelBase::markDirty(size_t row, size_t col)
+{
+    const size_t maxIndex = static_cast<size_t>(std::numeric_limits<int>::max());
+    if(row >= maxIndex || col >= maxIndex){
+        return;
+    }
+
+    markDirty(QRect(static_cast<int>(col), static_cast<int>(row), 1, 1));
+}
+
+/*!
+ * \overload
+ * \details
+ * Coordinates \c x and \c y of \c rect are respectively
+ * column and row indexes.
+ *
+ * \param[in] rect
+ * Modified cells.
+ */
+void Array2DTableModelBase::markDirty(const QRect &rect)
+{
+    QRect dirty = clipToModel(rect);
+    if(dirty.isEmpty()){
+        return;
+    }
+
+    /* Merge with overlapping or adjacent rectangles, until no more merge is possible */
+    for(int i = 0; i < m_dirtyRects.size();){
+        if(m_dirtyRects[i].adjusted(-1, -1, 1, 1).intersects(dirty)){
+            dirty = dirty.united(m_dirtyRects[i]);
+            m_dirtyRects.remove(i);
+            i = 0;
+        }else{
+            ++i;
+        }
+    }
+
+    m_dirtyRects.append(dirty);
+
+    if(m_dirtyRects.size() > DIRTY_RECTS_MAX){
+        QRect bounding;
+        for(const QRect &current : m_dirtyRects){
+            bounding = bounding.united(current);
+        }
+
+        m_dirtyRects.clear();
+        m_dirtyRects.append(bounding);
+    }
+
+    if(!m_timerNotify->isActive()){
+        m_timerNotify->start();
+    }
+}
+
+/*!
+ * \brief Mark all cells as modified
+ * \details
+ * Use this when content of array changed but not
+ * its size, otherwise use resetModel().
+ */
+void Array2DTableModelBase::markAllDirty()
+{
+    markDirty(QRect(0, 0, columnCount(), rowCount()));
+}
+
+/*!
+ * \brief Reset model
+ * \details
+ * Views will query number of rows and columns again, and only
+ * request visible cells. Pending dirty rectangles are discarded. \n
+ * Use this after array has been resized or entirely replaced,
+ * before returning to event loop.
+ */
+void Array2DTableModelBase::resetModel()
+{
+    m_timerNotify->stop();
+    m_dirtyRects.clear();
+
+    beginResetModel();
+    endResetModel();
+}
+
+/*!
+ * \brief Notify dirty rectangles immediately
+ * \details
+ * One \c dataChanged() signal is emitted
+ * per dirty rectangle.
+ *
+ * \sa markDirty()
+ */
+void Array2DTableModelBase::flushDirty()
+{
+    m_timerNotify->stop();
+
+    const QVector<QRect> rects = m_dirtyRects;
+    m_dirtyRects.clear();
+
+    for(const QRect &rect : rects){
+        const QRect dirty = clipToModel(rect);
+        if(!dirty.isEmpty()){
+            emit dataChanged(index(dirty.top(), dirty.left()), index(dirty.bottom(), dirty.right()));
+        }
+    }
+}
+
+/*!
+ * \brief Get number of rows of the model
+ *
+ * \param[in] parent
+ * Parent index, must be invalid for table models.
+ *
+ * \return
+ * Returns number of rows of array, limited to \c INT_MAX.
+ */
+int Array2DTableModelBase::rowCount(const QModelIndex &parent) const
+{
+    if(parent.isValid()){
+        return 0;
+    }
+
+    return static_cast<int>(qMin(getArrayRows(), static_cast<size_t>(std::numeric_limits<int>::max())));
+}
+
+/*!
+ * \brief Get number of columns of the model
+ *
+ * \param[in] parent
+ * Parent index, must be invalid for table models.
+ *
+ * \return
+ * Returns number of columns of array, limited to \c INT_MAX.
+ */
+int Array2DTableModelBase::columnCount(const QModelIndex &parent) const
+{
+    if(parent.isValid()){
+        return 0;
+    }
+
+    return static_cast<int>(qMin(getArrayCols(), static_cast<size_t>(std::numeric_limits<int>::max())));
+}
+
+/*!
+ * \brief Get data of a cell
+ * \details
+ * Supported roles are \c Qt::DisplayRole, \c Qt::EditRole
+ * and \c Qt::TextAlignmentRole (cells are right-aligned).
+ *
+ * \param[in] index
+ * Index of cell.
+ * \param[in] role
+ * Role of data.
+ *
+ * \return
+ * Returns data of cell, invalid variant if index or
+ * role is not supported.
+ */
+QVariant Array2DTableModelBase::data(const QModelIndex &index, int role) const
+{
+    if(!index.isValid() || index.row() >= rowCount() || index.column() >= columnCount()){
+        return QVariant();
+    }
+
+    switch(role){
+        case Qt::DisplayRole:
+        case Qt::EditRole:{
+            return getCell(static_cast<size_t>(index.row()), static_cast<size_t>(index.column()));
+        }
+
+        case Qt::TextAlignmentRole:{
+            return QVariant(static_cast<int>(Qt::AlignRight | Qt::AlignVCenter));
+        }
+
+        default:{
+            return QVariant();
+        }
+    }
+}
+
+/*!
+ * \brief Set data of a cell
+ * \details
+ * Only used when model is editable, \c dataChanged() is
+ * emitted immediately.
+ *
+ * \param[in] index
+ * Index of cell.
+ * \param[in] value
+ * Value to set.
+ * \param[in] role
+ * Role of data, only \c Qt::EditRole is supported.
+ *
+ * \return
+ * Returns \c true if succeed.
+ *
+ * \sa setEditable()
+ */
+bool Array2DTableModelBase::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if(!m_editable || role != Qt::EditRole){
+        return false;
+    }
+
+    if(!index.isValid() || index.row() >= rowCount() || index.column() >= columnCount()){
+        return false;
+    }
+
+    if(!setCell(static_cast<size_t>(index.row()), static_cast<size_t>(index.column()), value)){
+        return false;
+    }
+
+    emit dataChanged(index, index);
+    return true;
+}
+
+/*!
+ * \brief Get flags of a cell
+ *
+ * \param[in] index
+ * Index of cell.
+ *
+ * \return
+ * Returns flags of cell, \c Qt::ItemIsEditable is
+ * set if model is editable.
+ */
+Qt::ItemFlags Array2DTableModelBase::flags(const QModelIndex &index) const
+{
+    Qt::ItemFlags itemFlags = QAbstractTableModel::flags(index);
+    if(m_editable && index.isValid()){
+        itemFlags |= Qt::ItemIsEditable;
+    }
+
+    return itemFlags;
+}
+
+/*!
+ * \brief Clip a rectangle to model bounds
+ *
+ * \param[in] rect
+ * Rectangle to clip.
+ *
+ * \return
+ * Returns clipped rectangle, empty if outside of model.
+ */
+QRect Array2DTableModelBase::clipToModel(const QRect &rect) const
+{
+    return rect.intersected(QRect(0, 0, columnCount(), rowCount()));
+}
+
+/*****************************/
+/* End namespace             */
+/*****************************/
+
+} // namespace tbq
+
+/*****************************/
+/* End file                  */
+/*****************************/
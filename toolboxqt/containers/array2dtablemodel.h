@@ -0,0 +1,432 @@
+#ifndef TBQ_CONTAINER_ARRAY2DTABLEMODEL_H
+#define TBQ_CONTAINER_ARRAY2DTABLEMODEL_H
+
+#include "toolboxqt/toolboxqt_global.h"
+#include "toolboxqt/containers/array2d.h"
+
+#include <QAbstractTableModel>
+#include <QRect>
+#include <QTimer>
+#include <QVariant>
+#include <QVector>
+
+#include <limits>
+#include <type_traits>
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/*     Class definitions     */
+/*   Array2DTableModelBase   */
+/*****************************/
+
+class TOOLBOXQT_EXPORT Array2DTableModelBase : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit Array2DTableModelBase(QObject *parent = nullptr);
+
+public:
+    bool isEditable() const;
+    int getNotifyInterval() const;
+
+    void setEditable(bool editable);
+    void setNotifyInterval(int interval);
+
+public:
+    void markDirty(size_t row, size_t col);
+    void markDirty(const QRect &rect);
+    void markAllDirty();
+
+    void resetModel();
+
+public slots:
+    void flushDirty();
+
+public: // Virtual methods from QAbstractTableModel
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+protected:
+    virtual size_t getArrayRows() const = 0;
+    virtual size_t getArrayCols() const = 0;
+
+    virtual QVariant getCell(size_t row, size_t col) const = 0;
+    virtual bool setCell(size_t row, size_t col, const QVariant &value) = 0;
+
+private:
+    QRect clipToModel(const QRect &rect) const;
+
+private:
+    bool m_editable = false;
+
+    QVector<QRect> m_dirtyRects;
+    QTimer *m_timerNotify = nullptr;
+};
+
+/*****************************/
+/* Define template interface */
+/*****************************/
+
+/*!
+ * \class Array2DTableModel
+ * \brief Table model exposing a 2D array to item views,
+ * without copying it
+ * \details
+ * Model only refers to the array: cells are converted to
+ * \c QVariant when requested by the view (so only for painted
+ * cells), whatever the size of the array.
+ * \code{.cpp}
+ * tbq::Array2D<float> grid(1000000, 16);
+ * tbq::Array2DTableModel<float> model(&grid);
+ *
+ * QTableView view;
+ * view.setModel(&model);
+ *
+ * // Later, after modifying some cells
+ * grid(10, 2) = 4.2f;
+ * model.markDirty(10, 2);
+ * \endcode
+ *
+ * Integer elements are exposed as \c qlonglong or \c qulonglong,
+ * floating-point elements as \c double and other types with
+ * \c QVariant::fromValue(). Editing (see setEditable()) is only
+ * supported for arithmetic types.
+ *
+ * \sa tbq::Array2DTableModelBase
+ */
+template <typename T, typename Layout = Array2DLayoutRowMajor, typename Allocator = Array2DAllocatorHeap>
+class Array2DTableModel : public Array2DTableModelBase
+{
+
+public:
+    using ArrayType = Array2D<T, Layout, Allocator>;
+
+public:
+    explicit Array2DTableModel(QObject *parent = nullptr);
+    explicit Array2DTableModel(ArrayType *array, QObject *parent = nullptr);
+
+public:
+    ArrayType* getArray() const;
+    void setArray(ArrayType *array);
+
+protected: // Virtual methods from Array2DTableModelBase
+    size_t getArrayRows() const override;
+    size_t getArrayCols() const override;
+
+    QVariant getCell(size_t row, size_t col) const override;
+    bool setCell(size_t row, size_t col, const QVariant &value) override;
+
+private:
+    using TypeFloating = std::integral_constant<int, 0>;
+    using TypeIntegral = std::integral_constant<int, 1>;
+    using TypeOther = std::integral_constant<int, 2>;
+    using TypeKind = std::integral_constant<int, std::is_floating_point<T>::value ? 0 : (std::is_integral<T>::value ? 1 : 2)>;
+
+private:
+    static QVariant toVariant(const T &value, TypeFloating kind);
+    static QVariant toVariant(const T &value, TypeIntegral kind);
+    static QVariant toVariant(const T &value, TypeOther kind);
+
+    static bool fromVariant(const QVariant &variant, T &value, TypeFloating kind);
+    static bool fromVariant(const QVariant &variant, T &value, TypeIntegral kind);
+    static bool fromVariant(const QVariant &variant, T &value, TypeOther kind);
+
+private:
+    ArrayType *m_array;
+};
+
+/*****************************/
+/* Define template
+ *      implementation       */
+/*****************************/
+
+/*!
+ * \brief Construct a table model without array
+ *
+ * \param[in] parent
+ * Parent of the model.
+ *
+ * \sa setArray()
+ */
+template<typename T, typename Layout, typename Allocator>
+Array2DTableModel<T, Layout, Allocator>::Array2DTableModel(QObject *parent)
+    : Array2DTableModelBase(parent), m_array(nullptr)
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Construct a table model over a 2D array
+ *
+ * \param[in] array
+ * Array to expose. \n
+ * It is not owned and must outlive the model (or be
+ * replaced with setArray()).
+ * \param[in] parent
+ * Parent of the model.
+ */
+template<typename T, typename Layout, typename Allocator>
+Array2DTableModel<T, Layout, Allocator>::Array2DTableModel(ArrayType *array, QObject *parent)
+    : Array2DTableModelBase(parent), m_array(array)
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Get exposed array
+ *
+ * \return
+ * Returns pointer to array, can be \c nullptr.
+ */
+template<typename T, typename Layout, typename Allocator>
+typename Array2DTableModel<T, Layout, Allocator>::ArrayType* Array2DTableModel<T, Layout, Allocator>::getArray() const
+{
+    return m_array;
+}
+
+/*!
+ * \brief Set exposed array
+ * \details
+ * Model is reset.
+ *
+ * \param[in] array
+ * Array to expose, can be \c nullptr. \n
+ * It is not owned and must outlive the model (or be
+ * replaced by another call).
+ */
+template<typename T, typename Layout, typename Allocator>
+void Array2DTableModel<T, Layout, Allocator>::setArray(ArrayType *array)
+{
+    beginResetModel();
+    m_array = array;
+    endResetModel();
+}
+
+/*!
+ * \brief Get number of rows of exposed array
+ *
+ * \return
+ * Returns number of rows, \c 0 if no array is set.
+ */
+template<typename T, typename Layout, typename Allocator>
+size_t Array2DTableModel<T, Layout, Allocator>::getArrayRows() const
+{
+    return m_array ? m_array->getRows() : 0;
+}
+
+/*!
+ * \brief Get number of columns of exposed array
+ *
+ * \return
+ * Returns number of columns, \c 0 if no array is set.
+ */
+template<typename T, typename Layout, typename Allocator>
+size_t Array2DTableModel<T, Layout, Allocator>::getArrayCols() const
+{
+    return m_array ? m_array->getCols() : 0;
+}
+
+/*!
+ * \brief Get value of a cell of exposed array
+ *
+ * \param[in] row
+ * Row index of cell.
+ * \param[in] col
+ * Column index of cell.
+ *
+ * \return
+ * Returns value of cell
+ */
+template<typename T, typename Layout, typename Allocator>
+QVariant Array2DTableModel<T, Layout, Allocator>::getCell(size_t row, size_t col) const
+{
+    return toVariant((*m_array)(row, col), TypeKind());
+}
+
+/*!
+ * \brief Set value of a cell of exposed array
+ *
+ * \param[in] row
+ * Row index of cell.
+ * \param[in] col
+ * Column index of cell.
+ * \param[in] value
+ * Value to set.
+ *
+ * \return
+ * Returns \c true if \c value can be converted to \c T.
+ */
+template<typename T, typename Layout, typename Allocator>
+bool Array2DTableModel<T, Layout, Allocator>::setCell(size_t row, size_t col, const QVariant &value)
+{
+    return fromVariant(value, (*m_array)(row, col), TypeKind());
+}
+
+/*!
+ * \brief Convert floating-point element to variant
+ *
+ * \param[in] value
+ * Element to convert.
+ * \param[in] kind
+ * Tag used to select implementation.
+ *
+ * \return
+ * Returns variant holding a \c double
+ */
+template<typename T, typename Layout, typename Allocator>
+QVariant Array2DTableModel<T, Layout, Allocator>::toVariant(const T &value, TypeFloating kind)
+{
+    Q_UNUSED(kind)
+    return QVariant(static_cast<double>(value));
+}
+
+/*!
+ * \brief Convert integer element to variant
+ *
+ * \param[in] value
+ * Element to convert.
+ * \param[in] kind
+ * Tag used to select implementation.
+ *
+ * \return
+ * Returns variant holding a \c qlonglong or
+ * a \c qulonglong
+ */
+template<typename T, typename Layout, typename Allocator>
+QVariant Array2DTableModel<T, Layout, Allocator>::toVariant(const T &value, TypeIntegral kind)
+{
+    Q_UNUSED(kind)
+
+    if(std::is_signed<T>::value){
+        return QVariant(static_cast<qlonglong>(value));
+    }
+
+    return QVariant(static_cast<qulonglong>(value));
+}
+
+/*!
+ * \brief Convert element of other types to variant
+ *
+ * \param[in] value
+ * Element to convert.
+ * \param[in] kind
+ * Tag used to select implementation.
+ *
+ * \return
+ * Returns variant holding a copy of \c value
+ */
+template<typename T, typename Layout, typename Allocator>
+QVariant Array2DTableModel<T, Layout, Allocator>::toVariant(const T &value, TypeOther kind)
+{
+    Q_UNUSED(kind)
+    return QVariant::fromValue(value);
+}
+
+/*!
+ * \brief Convert variant to floating-point element
+ *
+ * \param[in] variant
+ * Variant to convert.
+ * \param[out] value
+ * Converted element.
+ * \param[in] kind
+ * Tag used to select implementation.
+ *
+ * \return
+ * Returns \c true if succeed.
+ */
+template<typename T, typename Layout, typename Allocator>
+bool Array2DTableModel<T, Layout, Allocator>::fromVariant(const QVariant &variant, T &value, TypeFloating kind)
+{
+    Q_UNUSED(kind)
+
+    bool ok = false;
+    const double converted = variant.toDouble(&ok);
+    if(!ok){
+        return false;
+    }
+
+    value = static_cast<T>(converted);
+    return true;
+}
+
+/*!
+ * \brief Convert variant to integer element
+ *
+ * \param[in] variant
+ * Variant to convert.
+ * \param[out] value
+ * Converted element.
+ * \param[in] kind
+ * Tag used to select implementation.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if variant is not an integer or if
+ * it doesn't fit in \c T.
+ */
+template<typename T, typename Layout, typename Allocator>
+bool Array2DTableModel<T, Layout, Allocator>::fromVariant(const QVariant &variant, T &value, TypeIntegral kind)
+{
+    Q_UNUSED(kind)
+
+    bool ok = false;
+    if(std::is_signed<T>::value){
+        const qlonglong converted = variant.toLongLong(&ok);
+        if(!ok || converted < static_cast<qlonglong>(std::numeric_limits<T>::lowest()) || converted > static_cast<qlonglong>(std::numeric_limits<T>::max())){
+            return false;
+        }
+
+        value = static_cast<T>(converted);
+        return true;
+    }
+
+    const qulonglong converted = variant.toULongLong(&ok);
+    if(!ok || converted > static_cast<qulonglong>(std::numeric_limits<T>::max())){
+        return false;
+    }
+
+    value = static_cast<T>(converted);
+    return true;
+}
+
+/*!
+ * \brief Convert variant to element of other types
+ * \details
+ * Editing is not supported for those types.
+ *
+ * \param[in] variant
+ * Variant to convert.
+ * \param[out] value
+ * Converted element.
+ * \param[in] kind
+ * Tag used to select implementation.
+ *
+ * \return
+ * Returns \c false
+ */
+template<typename T, typename Layout, typename Allocator>
+bool Array2DTableModel<T, Layout, Allocator>::fromVariant(const QVariant &variant, T &value, TypeOther kind)
+{
+    Q_UNUSED(variant)
+    Q_UNUSED(value)
+    Q_UNUSED(kind)
+
+    return false;
+}
+
+} // namespace tbq
+
+#endif // TBQ_CONTAINER_ARRAY2DTABLEMODEL_H
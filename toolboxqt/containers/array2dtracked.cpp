@@ -0,0 +1,392 @@
+#include "array2dtracked.h"
+
+/*****************************/
+/* Class documentations      */
+/*****************************/
+
+/*!
+ * \class tbq::Array2DDirtyTiles
+ * \brief Use to record which tiles of a 2D
+ * area have been modified
+ * \details
+ * Include with:
+ * \code{.cpp}
+ * #include "toolboxqt/containers/array2dtracked.h"
+ * \endcode
+ *
+ * Area is split in square tiles of getTileSize() rows and
+ * columns, each tile being stored as a single bit, so marking an
+ * element is constant-time and memory usage is negligible compared
+ * to the tracked array. \n
+ * Modified region is retrieved with takeRegion(), which merges
+ * dirty tiles into as few rectangles as possible.
+ *
+ * \sa tbq::Array2DTracked, tbq::diff()
+ */
+
+/*****************************/
+/* Macro definitions         */
+/*****************************/
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/* Constants definitions     */
+/*****************************/
+
+static const size_t BITS_PER_WORD = 64;
+
+/*****************************/
+/* Functions implementation  */
+/*         Class             */
+/*****************************/
+
+/*!
+ * \brief Construct an empty tiles tracker
+ *
+ * \param[in] tileSize
+ * Size (in rows and columns) of tiles. \n
+ * If \c 0, \c 1 will be used.
+ */
+Array2DDirtyTiles::Array2DDirtyTiles(size_t tileSize)
+    : m_tileSize(qMax<size_t>(tileSize, 1)), m_rows(0), m_cols(0),
+      m_tileRows(0), m_tileCols(0), m_nbDirty(0)
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Get number of rows of tracked area
+ *
+ * \return
+ * Returns number of rows
+ */
+size_t Array2DDirtyTiles::getRows() const
+{
+    return m_rows;
+}
+
+/*!
+ * \brief Get number of columns of tracked area
+ *
+ * \return
+ * Returns number of columns
+ */
+size_t Array2DDirtyTiles::getCols() const
+{
+    return m_cols;
+}
+
+/*!
+ * \brief Get size of tiles
+ *
+ * \return
+ * Returns size (in rows and columns) of tiles
+ */
+size_t Array2DDirtyTiles::getTileSize() const
+{
+    return m_tileSize;
+}
+
+/*!
+ * \brief Get number of tiles per column
+ *
+ * \return
+ * Returns number of rows of tiles
+ */
+size_t Array2DDirtyTiles::getTileRows() const
+{
+    return m_tileRows;
+}
+
+/*!
+ * \brief Get number of tiles per row
+ *
+ * \return
+ * Returns number of columns of tiles
+ */
+size_t Array2DDirtyTiles::getTileCols() const
+{
+    return m_tileCols;
+}
+
+/*!
+ * \brief Use to know if at least one tile is dirty
+ *
+ * \return
+ * Returns \c true if a tile is dirty
+ */
+bool Array2DDirtyTiles::isDirty() const
+{
+    return m_nbDirty > 0;
+}
+
+/*!
+ * \brief Use to know if a tile is dirty
+ *
+ * \param[in] tileRow
+ * Row index of tile.
+ * \param[in] tileCol
+ * Column index of tile.
+ *
+ * \return
+ * Returns \c true if tile is dirty, \c false if
+ * not or if outside of tracked area.
+ */
+bool Array2DDirtyTiles::isTileDirty(size_t tileRow, size_t tileCol) const
+{
+    if(tileRow >= m_tileRows || tileCol >= m_tileCols){
+        return false;
+    }
+
+    const size_t bit = tileRow * m_tileCols + tileCol;
+    return (m_bits[static_cast<int>(bit / BITS_PER_WORD)] >> (bit % BITS_PER_WORD)) & 1;
+}
+
+/*!
+ * \brief Resize tracked area
+ * \details
+ * All tiles are cleared.
+ *
+ * \param[in] nbRows
+ * Number of rows.
+ * \param[in] nbCols
+ * Number of colums
+ */
+void Array2DDirtyTiles::resize(size_t nbRows, size_t nbCols)
+{
+    m_rows = nbRows;
+    m_cols = nbCols;
+    m_tileRows = (nbRows + m_tileSize - 1) / m_tileSize;
+    m_tileCols = (nbCols + m_tileSize - 1) / m_tileSize;
+
+    const size_t nbTiles = m_tileRows * m_tileCols;
+    m_bits.fill(0, static_cast<int>((nbTiles + BITS_PER_WORD - 1) / BITS_PER_WORD));
+    m_nbDirty = 0;
+}
+
+/*!
+ * \brief Set size of tiles
+ * \details
+ * All tiles are cleared.
+ *
+ * \param[in] tileSize
+ * Size (in rows and columns) of tiles. \n
+ * If \c 0, \c 1 will be used.
+ */
+void Array2DDirtyTiles::setTileSize(size_t tileSize)
+{
+    m_tileSize = qMax<size_t>(tileSize, 1);
+    resize(m_rows, m_cols);
+}
+
+/*!
+ * \brief Mark all tiles as clean
+ */
+void Array2DDirtyTiles::clear()
+{
+    if(m_nbDirty == 0){
+        return;
+    }
+
+    m_bits.fill(0);
+    m_nbDirty = 0;
+}
+
+/*!
+ * \brief Mark tile containing an element as dirty
+ * \details
+ * Elements outside of tracked area are ignored.
+ *
+ * \param[in] row
+ * Row index of element.
+ * \param[in] col
+ * Column index of element.
+ */
+void Array2DDirtyTiles::mark(size_t row, size_t col)
+{
+    if(row >= m_rows || col >= m_cols){
+        return;
+    }
+
+    markTile(row / m_tileSize, col / m_tileSize);
+}
+
+/*!
+ * \overload
+ * \details
+ * All tiles intersecting region are marked, region
+ * is clipped to tracked area.
+ *
+ * \param[in] row
+ * Index of first row of region.
+ * \param[in] col
+ * Index of first column of region.
+ * \param[in] nbRows
+ * Number of rows of region.
+ * \param[in] nbCols
+ * Number of columns of region.
+ */
+void Array2DDirtyTiles::mark(size_t row, size_t col, size_t nbRows, size_t nbCols)
+{
+    if(row >= m_rows || col >= m_cols || nbRows == 0 || nbCols == 0){
+        return;
+    }
+
+    const size_t rowEnd = row + qMin(nbRows, m_rows - row);
+    const size_t colEnd = col + qMin(nbCols, m_cols - col);
+
+    for(size_t tileRow = row / m_tileSize; tileRow <= (rowEnd - 1) / m_tileSize; ++tileRow){
+        for(size_t tileCol = col / m_tileSize; tileCol <= (colEnd - 1) / m_tileSize; ++tileCol){
+            markTile(tileRow, tileCol);
+        }
+    }
+}
+
+/*!
+ * \brief Mark all tiles as dirty
+ */
+void Array2DDirtyTiles::markAll()
+{
+    const size_t nbTiles = m_tileRows * m_tileCols;
+    if(nbTiles == 0){
+        return;
+    }
+
+    m_bits.fill(~quint64(0));
+
+    /* Keep unused bits of last word cleared */
+    const size_t remaining = nbTiles % BITS_PER_WORD;
+    if(remaining != 0){
+        m_bits.last() = (quint64(1) << remaining) - 1;
+    }
+
+    m_nbDirty = nbTiles;
+}
+
+/*!
+ * \brief Get dirty region
+ * \details
+ * Consecutive dirty tiles of a row of tiles are merged,
+ * then rectangles spanning the same columns on consecutive
+ * rows of tiles are merged.
+ *
+ * \return
+ * Returns list of dirty rectangles (coordinates \c x and \c y
+ * being respectively column and row indexes), aligned on tiles
+ * and clipped to tracked area.
+ *
+ * \note
+ * Coordinates of rectangles are stored as \c int, so area
+ * must not exceed \c INT_MAX rows or columns.
+ *
+ * \sa takeRegion()
+ */
+QVector<QRect> Array2DDirtyTiles::getRegion() const
+{
+    QVector<QRect> region;
+    if(m_nbDirty == 0){
+        return region;
+    }
+
+    /* Rectangles ending on previous row of tiles, sorted by column */
+    QVector<int> previous;
+    QVector<int> current;
+
+    for(size_t tileRow = 0; tileRow < m_tileRows; ++tileRow){
+        const int y = static_cast<int>(tileRow * m_tileSize);
+        const int height = static_cast<int>(qMin(m_tileSize, m_rows - tileRow * m_tileSize));
+
+        int idPrevious = 0;
+        current.clear();
+
+        for(size_t tileCol = 0; tileCol < m_tileCols;){
+            if(!isTileDirty(tileRow, tileCol)){
+                ++tileCol;
+                continue;
+            }
+
+            /* Find run of dirty tiles */
+            const size_t runBegin = tileCol;
+            while(tileCol < m_tileCols && isTileDirty(tileRow, tileCol)){
+                ++tileCol;
+            }
+
+            const int x = static_cast<int>(runBegin * m_tileSize);
+            const int width = static_cast<int>(qMin(tileCol * m_tileSize, m_cols) - runBegin * m_tileSize);
+
+            /* Extend rectangle of previous row of tiles spanning same columns */
+            while(idPrevious < previous.size() && region[previous[idPrevious]].x() < x){
+                ++idPrevious;
+            }
+
+            if(idPrevious < previous.size()){
+                QRect &rect = region[previous[idPrevious]];
+                if(rect.x() == x && rect.width() == width){
+                    rect.setHeight(rect.height() + height);
+                    current.append(previous[idPrevious]);
+                    ++idPrevious;
+                    continue;
+                }
+            }
+
+            current.append(region.size());
+            region.append(QRect(x, y, width, height));
+        }
+
+        previous.swap(current);
+    }
+
+    return region;
+}
+
+/*!
+ * \brief Get dirty region and mark all tiles as clean
+ *
+ * \return
+ * Returns list of dirty rectangles.
+ *
+ * \sa getRegion()
+ */
+QVector<QRect> Array2DDirtyTiles::takeRegion()
+{
+    const QVector<QRect> region = getRegion();
+    clear();
+
+    return region;
+}
+
+/*!
+ * \brief Mark a tile as dirty
+ *
+ * \param[in] tileRow
+ * Row index of tile, must be valid.
+ * \param[in] tileCol
+ * Column index of tile, must be valid.
+ */
+void Array2DDirtyTiles::markTile(size_t tileRow, size_t tileCol)
+{
+    const size_t bit = tileRow * m_tileCols + tileCol;
+    quint64 &word = m_bits[static_cast<int>(bit / BITS_PER_WORD)];
+    const quint64 mask = quint64(1) << (bit % BITS_PER_WORD);
+
+    if((word & mask) == 0){
+        word |= mask;
+        ++m_nbDirty;
+    }
+}
+
+/*****************************/
+/* End namespace             */
+/*****************************/
+
+} // namespace tbq
+
+/*****************************/
+/* End file                  */
+/*****************************/
@@ -0,0 +1,569 @@
+#ifndef TBQ_CONTAINER_ARRAY2DTRACKED_H
+#define TBQ_CONTAINER_ARRAY2DTRACKED_H
+
+#include "toolboxqt/toolboxqt_global.h"
+#include "toolboxqt/containers/array2d.h"
+
+#include <QRect>
+#include <QVector>
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/*   Constants definitions   */
+/*****************************/
+
+/*!
+ * \brief Default size (in rows and columns) of tiles
+ * used to track modified elements
+ */
+constexpr size_t DIRTY_TILE_SIZE_DEFAULT = 64;
+
+/*****************************/
+/*     Class definitions     */
+/*     Array2DDirtyTiles     */
+/*****************************/
+
+class TOOLBOXQT_EXPORT Array2DDirtyTiles
+{
+
+public:
+    explicit Array2DDirtyTiles(size_t tileSize = DIRTY_TILE_SIZE_DEFAULT);
+
+public:
+    size_t getRows() const;
+    size_t getCols() const;
+    size_t getTileSize() const;
+    size_t getTileRows() const;
+    size_t getTileCols() const;
+
+    bool isDirty() const;
+    bool isTileDirty(size_t tileRow, size_t tileCol) const;
+
+public:
+    void resize(size_t nbRows, size_t nbCols);
+    void setTileSize(size_t tileSize);
+    void clear();
+
+    void mark(size_t row, size_t col);
+    void mark(size_t row, size_t col, size_t nbRows, size_t nbCols);
+    void markAll();
+
+public:
+    QVector<QRect> getRegion() const;
+    QVector<QRect> takeRegion();
+
+private:
+    void markTile(size_t tileRow, size_t tileCol);
+
+private:
+    size_t m_tileSize;
+    size_t m_rows;
+    size_t m_cols;
+    size_t m_tileRows;
+    size_t m_tileCols;
+
+    size_t m_nbDirty;
+    QVector<quint64> m_bits;
+};
+
+/*****************************/
+/* Define template interface */
+/*****************************/
+
+/*!
+ * \class Array2DTracked
+ * \brief Use to manage a 2-dimensional array recording
+ * which parts have been modified
+ * \details
+ * Array is split in square tiles, and each write through this
+ * class marks the tile containing the element (see tbq::Array2DDirtyTiles).
+ * Consumers (renderers, network synchronization, table models) then
+ * call takeDirtyRegion() to get the modified rectangles since their
+ * previous call, and only update those.
+ * \code{.cpp}
+ * tbq::Array2DTracked<float> grid(4096, 4096);
+ * grid(12, 30) = 1.0f;
+ * grid.insert(2000, 100, 2.0f);
+ *
+ * for(const QRect &rect : grid.takeDirtyRegion()){
+ *     // Upload rect
+ * }
+ * \endcode
+ *
+ * Writes through non-const operator() mark their tile dirty even if
+ * value is not modified. Bulk writes can be performed on array returned
+ * by getArrayUntracked(), followed by a call to markDirty().
+ *
+ * \sa tbq::diff()
+ */
+template <typename T, typename Layout = Array2DLayoutRowMajor, typename Allocator = Array2DAllocatorHeap>
+class Array2DTracked
+{
+
+public:
+    using ArrayType = Array2D<T, Layout, Allocator>;
+
+public:
+    explicit Array2DTracked(size_t tileSize = DIRTY_TILE_SIZE_DEFAULT);
+    explicit Array2DTracked(size_t nbRows, size_t nbCols, size_t tileSize = DIRTY_TILE_SIZE_DEFAULT);
+    explicit Array2DTracked(ArrayType array, size_t tileSize = DIRTY_TILE_SIZE_DEFAULT);
+
+public:
+    size_t getRows() const;
+    size_t getCols() const;
+    size_t getSize() const;
+    size_t getTileSize() const;
+
+    const ArrayType& getArray() const;
+    ArrayType& getArrayUntracked();
+
+    bool isDirty() const;
+
+public:
+    bool resize(size_t nbRows, size_t nbCols);
+
+    void insert(size_t row, size_t col, const T &value);
+    void fill(const T &value);
+
+    void markDirty(size_t row, size_t col);
+    void markDirty(size_t row, size_t col, size_t nbRows, size_t nbCols);
+    void markAllDirty();
+
+    QVector<QRect> takeDirtyRegion();
+
+public:
+    T& operator()(size_t row, size_t col);
+    const T& operator()(size_t row, size_t col) const;
+
+private:
+    ArrayType m_array;
+    Array2DDirtyTiles m_tiles;
+};
+
+/*****************************/
+/*   Functions definitions   */
+/*****************************/
+
+template<typename T>
+bool isEqualElements(const T *left, const T *right, size_t size);
+
+template<typename T, typename Layout, typename Allocator, typename OtherAllocator>
+QVector<QRect> diff(const Array2D<T, Layout, Allocator> &left, const Array2D<T, Layout, OtherAllocator> &right, size_t tileSize = DIRTY_TILE_SIZE_DEFAULT);
+
+/*****************************/
+/* Define template
+ *      implementation       */
+/*****************************/
+
+/*!
+ * \brief Construct an empty tracked 2D array
+ *
+ * \param[in] tileSize
+ * Size (in rows and columns) of tracked tiles.
+ */
+template<typename T, typename Layout, typename Allocator>
+Array2DTracked<T, Layout, Allocator>::Array2DTracked(size_t tileSize)
+    : m_array(), m_tiles(tileSize)
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Construct a tracked 2D array at specified size
+ * \details
+ * All tiles are initially dirty.
+ *
+ * \param[in] nbRows
+ * Number of rows.
+ * \param[in] nbCols
+ * Number of colums
+ * \param[in] tileSize
+ * Size (in rows and columns) of tracked tiles.
+ *
+ * \note
+ * If memory can't be allocated, array will be
+ * empty, use resize() to detect allocation failure.
+ */
+template<typename T, typename Layout, typename Allocator>
+Array2DTracked<T, Layout, Allocator>::Array2DTracked(size_t nbRows, size_t nbCols, size_t tileSize)
+    : m_array(), m_tiles(tileSize)
+{
+    resize(nbRows, nbCols);
+}
+
+/*!
+ * \brief Construct a tracked 2D array from an array
+ * \details
+ * All tiles are initially dirty.
+ *
+ * \param[in] array
+ * Array to track, use \c std::move() to avoid a copy.
+ * \param[in] tileSize
+ * Size (in rows and columns) of tracked tiles.
+ */
+template<typename T, typename Layout, typename Allocator>
+Array2DTracked<T, Layout, Allocator>::Array2DTracked(ArrayType array, size_t tileSize)
+    : m_array(std::move(array)), m_tiles(tileSize)
+{
+    m_tiles.resize(m_array.getRows(), m_array.getCols());
+    m_tiles.markAll();
+}
+
+/*!
+ * \brief Get number of rows
+ *
+ * \return
+ * Returns number of rows available
+ */
+template<typename T, typename Layout, typename Allocator>
+size_t Array2DTracked<T, Layout, Allocator>::getRows() const
+{
+    return m_array.getRows();
+}
+
+/*!
+ * \brief Get number of columns
+ *
+ * \return
+ * Returns number of columns available
+ */
+template<typename T, typename Layout, typename Allocator>
+size_t Array2DTracked<T, Layout, Allocator>::getCols() const
+{
+    return m_array.getCols();
+}
+
+/*!
+ * \brief Get number of elements
+ *
+ * \return
+ * Returns number of elements available
+ */
+template<typename T, typename Layout, typename Allocator>
+size_t Array2DTracked<T, Layout, Allocator>::getSize() const
+{
+    return m_array.getSize();
+}
+
+/*!
+ * \brief Get size of tracked tiles
+ *
+ * \return
+ * Returns size (in rows and columns) of tiles
+ */
+template<typename T, typename Layout, typename Allocator>
+size_t Array2DTracked<T, Layout, Allocator>::getTileSize() const
+{
+    return m_tiles.getTileSize();
+}
+
+/*!
+ * \brief Get tracked array
+ *
+ * \return
+ * Returns read-only reference to array
+ */
+template<typename T, typename Layout, typename Allocator>
+const typename Array2DTracked<T, Layout, Allocator>::ArrayType& Array2DTracked<T, Layout, Allocator>::getArray() const
+{
+    return m_array;
+}
+
+/*!
+ * \brief Get tracked array for writes which
+ * are not tracked
+ * \details
+ * Useful for bulk writes with algorithms taking
+ * a tbq::Array2D. Modified elements must then be
+ * declared with markDirty(). \n
+ * Array must not be resized through this reference.
+ *
+ * \return
+ * Returns reference to array
+ */
+template<typename T, typename Layout, typename Allocator>
+typename Array2DTracked<T, Layout, Allocator>::ArrayType& Array2DTracked<T, Layout, Allocator>::getArrayUntracked()
+{
+    return m_array;
+}
+
+/*!
+ * \brief Use to know if some elements have been
+ * modified since last call to takeDirtyRegion()
+ *
+ * \return
+ * Returns \c true if at least one tile is dirty
+ */
+template<typename T, typename Layout, typename Allocator>
+bool Array2DTracked<T, Layout, Allocator>::isDirty() const
+{
+    return m_tiles.isDirty();
+}
+
+/*!
+ * \brief Resize array
+ * \details
+ * All tiles are marked dirty.
+ *
+ * \param[in] nbRows
+ * Number of rows.
+ * \param[in] nbCols
+ * Number of colums
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if memory can't be allocated, array
+ * is not modified.
+ *
+ * \sa tbq::Array2D::resize()
+ */
+template<typename T, typename Layout, typename Allocator>
+bool Array2DTracked<T, Layout, Allocator>::resize(size_t nbRows, size_t nbCols)
+{
+    if(!m_array.resize(nbRows, nbCols)){
+        return false;
+    }
+
+    m_tiles.resize(nbRows, nbCols);
+    m_tiles.markAll();
+
+    return true;
+}
+
+/*!
+ * \brief Set value of an element
+ *
+ * \param[in] row
+ * Row index of element.
+ * \param[in] col
+ * Column index of element.
+ * \param[in] value
+ * Value to set.
+ */
+template<typename T, typename Layout, typename Allocator>
+void Array2DTracked<T, Layout, Allocator>::insert(size_t row, size_t col, const T &value)
+{
+    m_array.insert(row, col, value);
+    m_tiles.mark(row, col);
+}
+
+/*!
+ * \brief Set all elements to a value
+ * \details
+ * All tiles are marked dirty.
+ *
+ * \param[in] value
+ * Value to use.
+ */
+template<typename T, typename Layout, typename Allocator>
+void Array2DTracked<T, Layout, Allocator>::fill(const T &value)
+{
+    std::fill(m_array.data(), m_array.data() + m_array.getSize(), value);
+    m_tiles.markAll();
+}
+
+/*!
+ * \brief Mark an element as modified
+ *
+ * \param[in] row
+ * Row index of element.
+ * \param[in] col
+ * Column index of element.
+ */
+template<typename T, typename Layout, typename Allocator>
+void Array2DTracked<T, Layout, Allocator>::markDirty(size_t row, size_t col)
+{
+    m_tiles.mark(row, col);
+}
+
+/*!
+ * \overload
+ * \details
+ * Region is clipped to array bounds.
+ *
+ * \param[in] row
+ * Index of first row of modified region.
+ * \param[in] col
+ * Index of first column of modified region.
+ * \param[in] nbRows
+ * Number of rows of modified region.
+ * \param[in] nbCols
+ * Number of columns of modified region.
+ */
+template<typename T, typename Layout, typename Allocator>
+void Array2DTracked<T, Layout, Allocator>::markDirty(size_t row, size_t col, size_t nbRows, size_t nbCols)
+{
+    m_tiles.mark(row, col, nbRows, nbCols);
+}
+
+/*!
+ * \brief Mark all elements as modified
+ */
+template<typename T, typename Layout, typename Allocator>
+void Array2DTracked<T, Layout, Allocator>::markAllDirty()
+{
+    m_tiles.markAll();
+}
+
+/*!
+ * \brief Get modified region and reset tracking
+ *
+ * \return
+ * Returns list of rectangles containing modified elements
+ * (coordinates \c x and \c y being respectively column and row
+ * indexes), aligned on tiles and clipped to array bounds.
+ *
+ * \sa tbq::Array2DDirtyTiles::takeRegion()
+ */
+template<typename T, typename Layout, typename Allocator>
+QVector<QRect> Array2DTracked<T, Layout, Allocator>::takeDirtyRegion()
+{
+    return m_tiles.takeRegion();
+}
+
+/*!
+ * \brief Access element at specified position,
+ * marking it as modified
+ *
+ * \param[in] row
+ * Row index of element.
+ * \param[in] col
+ * Column index of element.
+ *
+ * \return
+ * Returns reference to element
+ */
+template<typename T, typename Layout, typename Allocator>
+T& Array2DTracked<T, Layout, Allocator>::operator()(size_t row, size_t col)
+{
+    m_tiles.mark(row, col);
+    return m_array(row, col);
+}
+
+/*!
+ * \brief Access element at specified position
+ *
+ * \param[in] row
+ * Row index of element.
+ * \param[in] col
+ * Column index of element.
+ *
+ * \return
+ * Returns read-only reference to element
+ */
+template<typename T, typename Layout, typename Allocator>
+const T& Array2DTracked<T, Layout, Allocator>::operator()(size_t row, size_t col) const
+{
+    return m_array(row, col);
+}
+
+/*!
+ * \brief Compare two ranges of elements
+ * \details
+ * For integer, enumeration and pointer types, bitwise comparison
+ * (\c std::memcmp()) is used. Other types use \c operator== (so
+ * floating-point values follow IEEE rules: <tt>-0.0 == 0.0</tt>
+ * and \c NaN values are never equal).
+ *
+ * \param[in] left
+ * First range.
+ * \param[in] right
+ * Second range.
+ * \param[in] size
+ * Number of elements of each range.
+ *
+ * \return
+ * Returns \c true if all elements are equal
+ */
+template<typename T>
+bool isEqualElements(const T *left, const T *right, size_t size)
+{
+    if(std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value){
+        return size == 0 || std::memcmp(left, right, size * sizeof(T)) == 0;
+    }
+
+    return std::equal(left, left + size, right);
+}
+
+/*!
+ * \brief Compute region which differs between two 2D arrays
+ * \details
+ * Arrays are compared tile by tile, each storage line being first
+ * compared as a whole (see isEqualElements()), so cost is close to
+ * a \c std::memcmp() of arrays when few elements differ.
+ *
+ * \param[in] left
+ * First array.
+ * \param[in] right
+ * Second array.
+ * \param[in] tileSize
+ * Size (in rows and columns) of compared tiles.
+ *
+ * \return
+ * Returns list of rectangles containing differing elements
+ * (coordinates \c x and \c y being respectively column and row
+ * indexes), aligned on tiles. \n
+ * If arrays sizes differ, returns a single rectangle covering
+ * both arrays.
+ *
+ * \sa tbq::Array2DTracked
+ */
+template<typename T, typename Layout, typename Allocator, typename OtherAllocator>
+QVector<QRect> diff(const Array2D<T, Layout, Allocator> &left, const Array2D<T, Layout, OtherAllocator> &right, size_t tileSize)
+{
+    if(left.getRows() != right.getRows() || left.getCols() != right.getCols()){
+        const size_t nbRows = std::max(left.getRows(), right.getRows());
+        const size_t nbCols = std::max(left.getCols(), right.getCols());
+
+        Array2DDirtyTiles tiles(nbRows > 0 && nbCols > 0 ? std::max(nbRows, nbCols) : 1);
+        tiles.resize(nbRows, nbCols);
+        tiles.markAll();
+
+        return tiles.takeRegion();
+    }
+
+    Array2DDirtyTiles tiles(tileSize);
+    tiles.resize(left.getRows(), left.getCols());
+
+    /* Work on storage lines (rows for row-major layout, columns otherwise) */
+    const size_t storeRows = Layout::IS_ROW_MAJOR ? left.getRows() : left.getCols();
+    const size_t storeCols = Layout::IS_ROW_MAJOR ? left.getCols() : left.getRows();
+    const size_t segmentSize = tiles.getTileSize();
+
+    for(size_t line = 0; line < storeRows; ++line){
+        const T *ptrLeft = left.data() + line * storeCols;
+        const T *ptrRight = right.data() + line * storeCols;
+        if(isEqualElements(ptrLeft, ptrRight, storeCols)){
+            continue;
+        }
+
+        for(size_t begin = 0; begin < storeCols; begin += segmentSize){
+            const size_t row = Layout::IS_ROW_MAJOR ? line : begin;
+            const size_t col = Layout::IS_ROW_MAJOR ? begin : line;
+            if(tiles.isTileDirty(row / segmentSize, col / segmentSize)){
+                continue;
+            }
+
+            const size_t size = std::min(segmentSize, storeCols - begin);
+            if(!isEqualElements(ptrLeft + begin, ptrRight + begin, size)){
+                tiles.mark(row, col);
+            }
+        }
+    }
+
+    return tiles.takeRegion();
+}
+
+} // namespace tbq
+
+#endif // TBQ_CONTAINER_ARRAY2DTRACKED_H
@@ -0,0 +1,622 @@
+#ifndef TBQ_CONTAINER_ARRAY2DVIEW_H
+#define TBQ_CONTAINER_ARRAY2DVIEW_H
+
+#include "toolboxqt/toolboxqt_global.h"
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/* Define template interface */
+/*****************************/
+
+/*!
+ * \class Array2DLineIterator
+ * \brief Random access iterator used to walk
+ * through a tbq::Array2DLineView
+ */
+template <typename T>
+class Array2DLineIterator
+{
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = typename std::remove_cv<T>::type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+public:
+    Array2DLineIterator() : m_ptr(nullptr), m_step(1) {}
+    Array2DLineIterator(T *ptr, std::ptrdiff_t step) : m_ptr(ptr), m_step(step) {}
+
+    operator Array2DLineIterator<const T>() const { return Array2DLineIterator<const T>(m_ptr, m_step); }
+
+public:
+    reference operator*() const { return *m_ptr; }
+    pointer operator->() const { return m_ptr; }
+    reference operator[](difference_type n) const { return m_ptr[n * m_step]; }
+
+    Array2DLineIterator& operator++() { m_ptr += m_step; return *this; }
+    Array2DLineIterator operator++(int) { Array2DLineIterator it(*this); m_ptr += m_step; return it; }
+    Array2DLineIterator& operator--() { m_ptr -= m_step; return *this; }
+    Array2DLineIterator operator--(int) { Array2DLineIterator it(*this); m_ptr -= m_step; return it; }
+
+    Array2DLineIterator& operator+=(difference_type n) { m_ptr += n * m_step; return *this; }
+    Array2DLineIterator& operator-=(difference_type n) { m_ptr -= n * m_step; return *this; }
+
+public:
+    friend Array2DLineIterator operator+(Array2DLineIterator it, difference_type n) { return it += n; }
+    friend Array2DLineIterator operator+(difference_type n, Array2DLineIterator it) { return it += n; }
+    friend Array2DLineIterator operator-(Array2DLineIterator it, difference_type n) { return it -= n; }
+    friend difference_type operator-(const Array2DLineIterator &left, const Array2DLineIterator &right) { return (left.m_ptr - right.m_ptr) / left.m_step; }
+
+    friend bool operator==(const Array2DLineIterator &left, const Array2DLineIterator &right) { return left.m_ptr == right.m_ptr; }
+    friend bool operator!=(const Array2DLineIterator &left, const Array2DLineIterator &right) { return left.m_ptr != right.m_ptr; }
+    friend bool operator<(const Array2DLineIterator &left, const Array2DLineIterator &right) { return left.m_ptr < right.m_ptr; }
+    friend bool operator>(const Array2DLineIterator &left, const Array2DLineIterator &right) { return left.m_ptr > right.m_ptr; }
+    friend bool operator<=(const Array2DLineIterator &left, const Array2DLineIterator &right) { return left.m_ptr <= right.m_ptr; }
+    friend bool operator>=(const Array2DLineIterator &left, const Array2DLineIterator &right) { return left.m_ptr >= right.m_ptr; }
+
+private:
+    T *m_ptr;
+    std::ptrdiff_t m_step;
+};
+
+/*!
+ * \class Array2DLineView
+ * \brief Non-owning view over a single row or
+ * column of a 2-dimensional array
+ */
+template <typename T>
+class Array2DLineView
+{
+
+public:
+    using value_type = typename std::remove_cv<T>::type;
+    using iterator = Array2DLineIterator<T>;
+    using const_iterator = Array2DLineIterator<const T>;
+
+public:
+    explicit Array2DLineView();
+    explicit Array2DLineView(T *data, size_t size, size_t step = 1);
+
+    operator Array2DLineView<const T>() const;
+
+public:
+    size_t getSize() const;
+    size_t getStep() const;
+
+    bool isEmpty() const;
+    bool isContiguous() const;
+
+    T* data() const;
+
+public:
+    iterator begin() const;
+    iterator end() const;
+
+public:
+    T& operator[](size_t index) const;
+
+private:
+    T *m_data;
+    size_t m_size;
+    size_t m_step;
+};
+
+/*!
+ * \class Array2DViewIterator
+ * \brief Forward iterator used to walk through
+ * all elements of a tbq::Array2DView
+ */
+template <typename T>
+class Array2DViewIterator
+{
+
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename std::remove_cv<T>::type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+public:
+    Array2DViewIterator() : m_ptrRow(nullptr), m_row(0), m_col(0), m_rows(0), m_cols(0), m_rowStride(0), m_colStride(1) {}
+    Array2DViewIterator(T *ptrRow, size_t row, size_t rows, size_t cols, size_t rowStride, size_t colStride)
+        : m_ptrRow(ptrRow), m_row(row), m_col(0), m_rows(rows), m_cols(cols), m_rowStride(rowStride), m_colStride(colStride) {}
+
+public:
+    reference operator*() const { return m_ptrRow[m_col * m_colStride]; }
+    pointer operator->() const { return &m_ptrRow[m_col * m_colStride]; }
+
+    Array2DViewIterator& operator++()
+    {
+        if(++m_col == m_cols){
+            m_col = 0;
+            if(++m_row < m_rows){
+                m_ptrRow += m_rowStride;
+            }
+        }
+        return *this;
+    }
+
+    Array2DViewIterator operator++(int) { Array2DViewIterator it(*this); ++(*this); return it; }
+
+public:
+    friend bool operator==(const Array2DViewIterator &left, const Array2DViewIterator &right) { return left.m_row == right.m_row && left.m_col == right.m_col; }
+    friend bool operator!=(const Array2DViewIterator &left, const Array2DViewIterator &right) { return !(left == right); }
+
+private:
+    T *m_ptrRow;
+    size_t m_row;
+    size_t m_col;
+
+    size_t m_rows;
+    size_t m_cols;
+    size_t m_rowStride;
+    size_t m_colStride;
+};
+
+/*!
+ * \class Array2DView
+ * \brief Non-owning view over a rectangular region
+ * of a 2-dimensional array
+ */
+template <typename T>
+class Array2DView
+{
+
+public:
+    using value_type = typename std::remove_cv<T>::type;
+    using iterator = Array2DViewIterator<T>;
+
+public:
+    explicit Array2DView();
+    explicit Array2DView(T *data, size_t nbRows, size_t nbCols, size_t rowStride, size_t colStride = 1);
+
+    operator Array2DView<const T>() const;
+
+public:
+    size_t getRows() const;
+    size_t getCols() const;
+    size_t getSize() const;
+
+    size_t getRowStride() const;
+    size_t getColStride() const;
+
+    bool isEmpty() const;
+    bool isContiguous() const;
+
+    T* data() const;
+
+public:
+    Array2DLineView<T> rowView(size_t row) const;
+    Array2DLineView<T> colView(size_t col) const;
+    Array2DView<T> subView(size_t row, size_t col, size_t nbRows, size_t nbCols) const;
+
+public:
+    iterator begin() const;
+    iterator end() const;
+
+public:
+    T& operator()(size_t row, size_t col) const;
+
+private:
+    T *m_data;
+    size_t m_rows;
+    size_t m_cols;
+    size_t m_rowStride;
+    size_t m_colStride;
+};
+
+/*****************************/
+/* Define template
+ *      implementation       */
+/*****************************/
+
+/*!
+ * \brief Construct an empty line view
+ */
+template<typename T>
+Array2DLineView<T>::Array2DLineView()
+    : m_data(nullptr), m_size(0), m_step(1)
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Construct a line view over existing memory
+ *
+ * \param[in] data
+ * Pointer to first element of the line. \n
+ * Memory is not owned by the view and must outlive it.
+ * \param[in] size
+ * Number of elements of the line.
+ * \param[in] step
+ * Distance (in elements) between two consecutive elements
+ * of the line. \n
+ * A step of \c 1 means that line is contiguous in memory.
+ */
+template<typename T>
+Array2DLineView<T>::Array2DLineView(T *data, size_t size, size_t step)
+    : m_data(data), m_size(size), m_step(step)
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Allow implicit conversion to a read-only view
+ */
+template<typename T>
+Array2DLineView<T>::operator Array2DLineView<const T>() const
+{
+    return Array2DLineView<const T>(m_data, m_size, m_step);
+}
+
+/*!
+ * \brief Get number of elements of the line
+ *
+ * \return
+ * Returns number of elements
+ */
+template<typename T>
+size_t Array2DLineView<T>::getSize() const
+{
+    return m_size;
+}
+
+/*!
+ * \brief Get distance between two consecutive elements
+ *
+ * \return
+ * Returns distance in number of elements
+ *
+ * \sa isContiguous()
+ */
+template<typename T>
+size_t Array2DLineView<T>::getStep() const
+{
+    return m_step;
+}
+
+/*!
+ * \brief Use to know if line view is empty
+ *
+ * \return
+ * Returns \c true if line contains no elements
+ */
+template<typename T>
+bool Array2DLineView<T>::isEmpty() const
+{
+    return m_size == 0;
+}
+
+/*!
+ * \brief Use to know if elements of the line are
+ * contiguous in memory
+ * \details
+ * When contiguous, data() can be used as a regular
+ * C-array of getSize() elements.
+ *
+ * \return
+ * Returns \c true if line is contiguous
+ *
+ * \sa getStep()
+ */
+template<typename T>
+bool Array2DLineView<T>::isContiguous() const
+{
+    return m_step == 1;
+}
+
+/*!
+ * \brief Get pointer to first element of the line
+ *
+ * \return
+ * Returns pointer to first element
+ */
+template<typename T>
+T* Array2DLineView<T>::data() const
+{
+    return m_data;
+}
+
+/*!
+ * \brief Get iterator to the first element
+ */
+template<typename T>
+typename Array2DLineView<T>::iterator Array2DLineView<T>::begin() const
+{
+    return iterator(m_data, static_cast<std::ptrdiff_t>(m_step));
+}
+
+/*!
+ * \brief Get iterator past the last element
+ */
+template<typename T>
+typename Array2DLineView<T>::iterator Array2DLineView<T>::end() const
+{
+    return begin() + static_cast<std::ptrdiff_t>(m_size);
+}
+
+/*!
+ * \brief Get reference to an element
+ *
+ * \param[in] index
+ * Index of the element. \n
+ * Must be valid (i.e <tt>0 <= index < getSize()</tt>).
+ *
+ * \return
+ * Returns reference to an element
+ */
+template<typename T>
+T& Array2DLineView<T>::operator[](size_t index) const
+{
+    return m_data[index * m_step];
+}
+
+/*!
+ * \brief Construct an empty view
+ */
+template<typename T>
+Array2DView<T>::Array2DView()
+    : m_data(nullptr), m_rows(0), m_cols(0), m_rowStride(0), m_colStride(1)
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Construct a view over existing memory
+ *
+ * \param[in] data
+ * Pointer to element at position <tt>(0, 0)</tt>. \n
+ * Memory is not owned by the view and must outlive it.
+ * \param[in] nbRows
+ * Number of rows.
+ * \param[in] nbCols
+ * Number of columns.
+ * \param[in] rowStride
+ * Distance (in elements) between two consecutive rows.
+ * \param[in] colStride
+ * Distance (in elements) between two consecutive columns.
+ */
+template<typename T>
+Array2DView<T>::Array2DView(T *data, size_t nbRows, size_t nbCols, size_t rowStride, size_t colStride)
+    : m_data(data), m_rows(nbRows), m_cols(nbCols), m_rowStride(rowStride), m_colStride(colStride)
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Allow implicit conversion to a read-only view
+ */
+template<typename T>
+Array2DView<T>::operator Array2DView<const T>() const
+{
+    return Array2DView<const T>(m_data, m_rows, m_cols, m_rowStride, m_colStride);
+}
+
+/*!
+ * \brief Get number of rows
+ *
+ * \return
+ * Returns number of rows available
+ *
+ * \sa getCols(), getSize()
+ */
+template<typename T>
+size_t Array2DView<T>::getRows() const
+{
+    return m_rows;
+}
+
+/*!
+ * \brief Get number of columns
+ *
+ * \return
+ * Returns number of columns available
+ *
+ * \sa getRows(), getSize()
+ */
+template<typename T>
+size_t Array2DView<T>::getCols() const
+{
+    return m_cols;
+}
+
+/*!
+ * \brief Get total number of elements of the view
+ *
+ * \return
+ * Returns number of elements
+ *
+ * \sa getRows(), getCols()
+ */
+template<typename T>
+size_t Array2DView<T>::getSize() const
+{
+    return m_rows * m_cols;
+}
+
+/*!
+ * \brief Get distance between two consecutive rows
+ *
+ * \return
+ * Returns distance in number of elements
+ *
+ * \sa getColStride()
+ */
+template<typename T>
+size_t Array2DView<T>::getRowStride() const
+{
+    return m_rowStride;
+}
+
+/*!
+ * \brief Get distance between two consecutive columns
+ *
+ * \return
+ * Returns distance in number of elements
+ *
+ * \sa getRowStride()
+ */
+template<typename T>
+size_t Array2DView<T>::getColStride() const
+{
+    return m_colStride;
+}
+
+/*!
+ * \brief Use to know if view is empty
+ *
+ * \return
+ * Returns \c true if view contains no elements
+ */
+template<typename T>
+bool Array2DView<T>::isEmpty() const
+{
+    return m_rows == 0 || m_cols == 0;
+}
+
+/*!
+ * \brief Use to know if all elements of the view are
+ * contiguous in memory
+ * \details
+ * This is the case when view cover full rows of a
+ * row-major array.
+ *
+ * \return
+ * Returns \c true if view is contiguous
+ */
+template<typename T>
+bool Array2DView<T>::isContiguous() const
+{
+    return m_colStride == 1 && (m_rows <= 1 || m_rowStride == m_cols);
+}
+
+/*!
+ * \brief Get pointer to element at position <tt>(0, 0)</tt>
+ *
+ * \return
+ * Returns pointer to first element
+ */
+template<typename T>
+T* Array2DView<T>::data() const
+{
+    return m_data;
+}
+
+/*!
+ * \brief Get view of a row
+ *
+ * \param[in] row
+ * Row index to use. \n
+ * Must be valid (i.e <tt>0 <= row < getRows()</tt>).
+ *
+ * \return
+ * Returns line view of the row
+ *
+ * \sa colView()
+ */
+template<typename T>
+Array2DLineView<T> Array2DView<T>::rowView(size_t row) const
+{
+    return Array2DLineView<T>(m_data + row * m_rowStride, m_cols, m_colStride);
+}
+
+/*!
+ * \brief Get view of a column
+ *
+ * \param[in] col
+ * Column index to use. \n
+ * Must be valid (i.e <tt>0 <= col < getCols()</tt>).
+ *
+ * \return
+ * Returns line view of the column
+ *
+ * \sa rowView()
+ */
+template<typename T>
+Array2DLineView<T> Array2DView<T>::colView(size_t col) const
+{
+    return Array2DLineView<T>(m_data + col * m_colStride, m_rows, m_rowStride);
+}
+
+/*!
+ * \brief Get view of a rectangular region
+ *
+ * \param[in] row
+ * Index of first row of the region.
+ * \param[in] col
+ * Index of first column of the region.
+ * \param[in] nbRows
+ * Number of rows of the region. \n
+ * Must be valid (i.e <tt>row + nbRows <= getRows()</tt>).
+ * \param[in] nbCols
+ * Number of columns of the region. \n
+ * Must be valid (i.e <tt>col + nbCols <= getCols()</tt>).
+ *
+ * \return
+ * Returns view of the region, sharing strides of this view.
+ */
+template<typename T>
+Array2DView<T> Array2DView<T>::subView(size_t row, size_t col, size_t nbRows, size_t nbCols) const
+{
+    return Array2DView<T>(m_data + row * m_rowStride + col * m_colStride, nbRows, nbCols, m_rowStride, m_colStride);
+}
+
+/*!
+ * \brief Get iterator to the first element
+ * \details
+ * Elements are walked row by row.
+ */
+template<typename T>
+typename Array2DView<T>::iterator Array2DView<T>::begin() const
+{
+    if(isEmpty()){
+        return end();
+    }
+
+    return iterator(m_data, 0, m_rows, m_cols, m_rowStride, m_colStride);
+}
+
+/*!
+ * \brief Get iterator past the last element
+ */
+template<typename T>
+typename Array2DView<T>::iterator Array2DView<T>::end() const
+{
+    return iterator(m_data, m_rows, m_rows, m_cols, m_rowStride, m_colStride);
+}
+
+/*!
+ * \brief Get reference to an element
+ *
+ * \param[in] row
+ * Row index to use. \n
+ * Must be valid (i.e <tt>0 <= row < getRows()</tt>).
+ * \param[in] col
+ * Column index to use. \n
+ * Must be valid (i.e <tt>0 <= col < getCols()</tt>).
+ *
+ * \return
+ * Returns reference to an element
+ */
+template<typename T>
+T& Array2DView<T>::operator()(size_t row, size_t col) const
+{
+    return m_data[row * m_rowStride + col * m_colStride];
+}
+
+} // namespace tbq
+
+#endif // TBQ_CONTAINER_ARRAY2DVIEW_H
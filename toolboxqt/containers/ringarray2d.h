@@ -0,0 +1,567 @@
+#ifndef TBQ_CONTAINER_RINGARRAY2D_H
+#define TBQ_CONTAINER_RINGARRAY2D_H
+
+#include "toolboxqt/toolboxqt_global.h"
+#include "toolboxqt/containers/array2d.h"
+#include "toolboxqt/containers/array2dstorage.h"
+#include "toolboxqt/containers/array2dview.h"
+
+#include <algorithm>
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/* Define template interface */
+/*****************************/
+
+/*!
+ * \class RingArray2D
+ * \brief Use to manage a 2-dimensional array of streamed
+ * rows, with a fixed maximum number of rows
+ * \details
+ * Rows are stored in a circular buffer: pushing a row is
+ * performed in constant time, without moving other rows, and
+ * drops the oldest row once capacity is reached. This is suited
+ * for waterfalls and spectrograms.
+ *
+ * Rows are accessed with logical indexes, row \c 0 being the
+ * oldest one. Physically, rows are stored in at most two contiguous
+ * segments (see getFirstSegment() and getSecondSegment()), which can
+ * be used for bulk copies or rendering:
+ * \code{.cpp}
+ * tbq::RingArray2D<float> waterfall(512, 2048);
+ *
+ * // Acquisition
+ * float *row = waterfall.pushRow();
+ * computeSpectrum(row);
+ *
+ * // Rendering, oldest rows first
+ * const tbq::Array2DView<const float> first = waterfall.getFirstSegment();
+ * const tbq::Array2DView<const float> second = waterfall.getSecondSegment();
+ * \endcode
+ */
+template <typename T, typename Allocator = Array2DAllocatorHeap>
+class RingArray2D
+{
+
+public:
+    explicit RingArray2D();
+    explicit RingArray2D(size_t capacityRows, size_t nbCols);
+
+public:
+    size_t getRows() const;
+    size_t getCols() const;
+    size_t getSize() const;
+    size_t getCapacity() const;
+
+    bool isEmpty() const;
+    bool isFull() const;
+
+public:
+    bool resize(size_t capacityRows, size_t nbCols);
+    void clear();
+
+    T* pushRow();
+    void pushRow(const T *values);
+    void pushRows(const T *values, size_t nbRows);
+    void popRow();
+
+public:
+    template<typename Layout = Array2DLayoutRowMajor, typename OutAllocator = Array2DAllocatorHeap>
+    Array2D<T, Layout, OutAllocator> toArray2D() const;
+
+public:
+    Array2DView<T> getFirstSegment();
+    Array2DView<const T> getFirstSegment() const;
+    Array2DView<T> getSecondSegment();
+    Array2DView<const T> getSecondSegment() const;
+
+    Array2DLineView<T> rowView(size_t row);
+    Array2DLineView<const T> rowView(size_t row) const;
+
+    T* rowData(size_t row);
+    const T* rowData(size_t row) const;
+
+public:
+    T& operator()(size_t row, size_t col);
+    const T& operator()(size_t row, size_t col) const;
+
+private:
+    size_t physicalRow(size_t row) const;
+    size_t firstSegmentRows() const;
+
+private:
+    size_t m_capacity;
+    size_t m_cols;
+    size_t m_head;
+    size_t m_count;
+
+    Array2DStorage<T, Allocator> m_data;
+};
+
+/*****************************/
+/* Define template
+ *      implementation       */
+/*****************************/
+
+/*!
+ * \brief Construct an empty ring 2D array, without capacity
+ *
+ * \sa resize()
+ */
+template<typename T, typename Allocator>
+RingArray2D<T, Allocator>::RingArray2D()
+    : m_capacity(0), m_cols(0), m_head(0), m_count(0)
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Construct an empty ring 2D array
+ * \details
+ * If memory can't be allocated, capacity will be \c 0.
+ *
+ * \param[in] capacityRows
+ * Maximum number of rows.
+ * \param[in] nbCols
+ * Number of columns of each row.
+ *
+ * \sa resize()
+ */
+template<typename T, typename Allocator>
+RingArray2D<T, Allocator>::RingArray2D(size_t capacityRows, size_t nbCols)
+    : m_capacity(0), m_cols(0), m_head(0), m_count(0)
+{
+    resize(capacityRows, nbCols);
+}
+
+/*!
+ * \brief Get number of rows currently stored
+ *
+ * \return
+ * Returns number of rows, lower or equal
+ * to capacity.
+ */
+template<typename T, typename Allocator>
+size_t RingArray2D<T, Allocator>::getRows() const
+{
+    return m_count;
+}
+
+/*!
+ * \brief Get number of columns
+ *
+ * \return
+ * Returns number of columns
+ */
+template<typename T, typename Allocator>
+size_t RingArray2D<T, Allocator>::getCols() const
+{
+    return m_cols;
+}
+
+/*!
+ * \brief Get number of elements currently stored
+ *
+ * \return
+ * Returns number of elements
+ */
+template<typename T, typename Allocator>
+size_t RingArray2D<T, Allocator>::getSize() const
+{
+    return m_count * m_cols;
+}
+
+/*!
+ * \brief Get maximum number of rows
+ *
+ * \return
+ * Returns number of rows which can be stored
+ * before dropping oldest ones.
+ */
+template<typename T, typename Allocator>
+size_t RingArray2D<T, Allocator>::getCapacity() const
+{
+    return m_capacity;
+}
+
+/*!
+ * \brief Use to know if no row is stored
+ *
+ * \return
+ * Returns \c true if empty
+ */
+template<typename T, typename Allocator>
+bool RingArray2D<T, Allocator>::isEmpty() const
+{
+    return m_count == 0;
+}
+
+/*!
+ * \brief Use to know if capacity is reached
+ *
+ * \return
+ * Returns \c true if next pushed row will
+ * drop the oldest one.
+ */
+template<typename T, typename Allocator>
+bool RingArray2D<T, Allocator>::isFull() const
+{
+    return m_count == m_capacity;
+}
+
+/*!
+ * \brief Set capacity and number of columns
+ * \details
+ * Stored rows are removed.
+ *
+ * \param[in] capacityRows
+ * Maximum number of rows.
+ * \param[in] nbCols
+ * Number of columns of each row.
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if memory can't be allocated, capacity
+ * is then \c 0.
+ */
+template<typename T, typename Allocator>
+bool RingArray2D<T, Allocator>::resize(size_t capacityRows, size_t nbCols)
+{
+    clear();
+
+    if(nbCols != 0 && capacityRows > Array2DStorage<T, Allocator>::getMaxSize() / nbCols){
+        m_capacity = 0;
+        m_cols = 0;
+        return false;
+    }
+
+    if(!m_data.resize(capacityRows * nbCols)){
+        m_capacity = 0;
+        m_cols = 0;
+        return false;
+    }
+
+    m_capacity = nbCols != 0 ? capacityRows : 0;
+    m_cols = nbCols;
+
+    return true;
+}
+
+/*!
+ * \brief Remove all rows
+ * \details
+ * Capacity is kept, elements are not destroyed
+ * but will be overwritten by next pushed rows.
+ */
+template<typename T, typename Allocator>
+void RingArray2D<T, Allocator>::clear()
+{
+    m_head = 0;
+    m_count = 0;
+}
+
+/*!
+ * \brief Append a row
+ * \details
+ * When capacity is reached, oldest row is dropped. \n
+ * Returned row still contains elements of the dropped row
+ * (or default-constructed elements), so all its elements
+ * should be written.
+ *
+ * \return
+ * Returns pointer to elements of new row (contiguous),
+ * which is valid until next call to pushRow(). \n
+ * Returns \c nullptr if capacity is \c 0.
+ */
+template<typename T, typename Allocator>
+T* RingArray2D<T, Allocator>::pushRow()
+{
+    if(m_capacity == 0){
+        return nullptr;
+    }
+
+    size_t row;
+    if(m_count < m_capacity){
+        row = physicalRow(m_count);
+        ++m_count;
+    }else{
+        row = m_head;
+        m_head = (m_head + 1 == m_capacity) ? 0 : m_head + 1;
+    }
+
+    return m_data.data() + row * m_cols;
+}
+
+/*!
+ * \overload
+ *
+ * \param[in] values
+ * Elements of new row, must contain getCols()
+ * elements.
+ */
+template<typename T, typename Allocator>
+void RingArray2D<T, Allocator>::pushRow(const T *values)
+{
+    T *row = pushRow();
+    if(row){
+        std::copy(values, values + m_cols, row);
+    }
+}
+
+/*!
+ * \brief Append multiple rows
+ * \details
+ * Rows are copied with at most two bulk copies. When
+ * capacity is exceeded, oldest rows are dropped (including
+ * first rows of \c values if \c nbRows is greater than capacity).
+ *
+ * \param[in] values
+ * Elements of rows (row-major), must contain
+ * <tt>nbRows * getCols()</tt> elements.
+ * \param[in] nbRows
+ * Number of rows to append.
+ */
+template<typename T, typename Allocator>
+void RingArray2D<T, Allocator>::pushRows(const T *values, size_t nbRows)
+{
+    if(m_capacity == 0 || nbRows == 0){
+        return;
+    }
+
+    /* Only last rows can be kept */
+    if(nbRows > m_capacity){
+        values += (nbRows - m_capacity) * m_cols;
+        nbRows = m_capacity;
+    }
+
+    const size_t tail = physicalRow(m_count);
+    const size_t firstRows = std::min(nbRows, m_capacity - tail);
+
+    T *data = m_data.data();
+    std::copy(values, values + firstRows * m_cols, data + tail * m_cols);
+    std::copy(values + firstRows * m_cols, values + nbRows * m_cols, data);
+
+    const size_t dropped = (m_count + nbRows > m_capacity) ? m_count + nbRows - m_capacity : 0;
+    m_count = std::min(m_count + nbRows, m_capacity);
+    m_head = (m_head + dropped) % m_capacity;
+}
+
+/*!
+ * \brief Remove oldest row
+ * \details
+ * Do nothing if array is empty.
+ */
+template<typename T, typename Allocator>
+void RingArray2D<T, Allocator>::popRow()
+{
+    if(m_count == 0){
+        return;
+    }
+
+    m_head = (m_head + 1 == m_capacity) ? 0 : m_head + 1;
+    --m_count;
+}
+
+/*!
+ * \brief Copy stored rows to a 2D array
+ *
+ * \return
+ * Returns 2D array of getRows() rows, oldest
+ * row first. \n
+ * Returns empty array if memory can't be allocated.
+ */
+template<typename T, typename Allocator>
+template<typename Layout, typename OutAllocator>
+Array2D<T, Layout, OutAllocator> RingArray2D<T, Allocator>::toArray2D() const
+{
+    Array2D<T, Layout, OutAllocator> array;
+    if(!array.resize(m_count, m_cols)){
+        return array;
+    }
+
+    if(Layout::IS_ROW_MAJOR){
+        const Array2DView<const T> first = getFirstSegment();
+        const Array2DView<const T> second = getSecondSegment();
+
+        T *out = array.data();
+        out = std::copy(first.data(), first.data() + first.getSize(), out);
+        std::copy(second.data(), second.data() + second.getSize(), out);
+
+        return array;
+    }
+
+    for(size_t row = 0; row < m_count; ++row){
+        const T *values = rowData(row);
+        for(size_t col = 0; col < m_cols; ++col){
+            array(row, col) = values[col];
+        }
+    }
+
+    return array;
+}
+
+/*!
+ * \brief Get physical segment containing oldest rows
+ * \details
+ * Segment is contiguous (row-major) and contains
+ * logical rows <tt>[0, n[</tt>.
+ *
+ * \return
+ * Returns view of segment, empty if no row is stored.
+ *
+ * \sa getSecondSegment()
+ */
+template<typename T, typename Allocator>
+Array2DView<T> RingArray2D<T, Allocator>::getFirstSegment()
+{
+    return Array2DView<T>(m_data.data() + m_head * m_cols, firstSegmentRows(), m_cols, m_cols);
+}
+
+/*!
+ * \overload
+ */
+template<typename T, typename Allocator>
+Array2DView<const T> RingArray2D<T, Allocator>::getFirstSegment() const
+{
+    return Array2DView<const T>(m_data.data() + m_head * m_cols, firstSegmentRows(), m_cols, m_cols);
+}
+
+/*!
+ * \brief Get physical segment containing newest rows
+ * \details
+ * Segment is contiguous (row-major) and contains
+ * logical rows following those of getFirstSegment().
+ *
+ * \return
+ * Returns view of segment, empty if stored rows
+ * don't wrap around the buffer.
+ *
+ * \sa getFirstSegment()
+ */
+template<typename T, typename Allocator>
+Array2DView<T> RingArray2D<T, Allocator>::getSecondSegment()
+{
+    return Array2DView<T>(m_data.data(), m_count - firstSegmentRows(), m_cols, m_cols);
+}
+
+/*!
+ * \overload
+ */
+template<typename T, typename Allocator>
+Array2DView<const T> RingArray2D<T, Allocator>::getSecondSegment() const
+{
+    return Array2DView<const T>(m_data.data(), m_count - firstSegmentRows(), m_cols, m_cols);
+}
+
+/*!
+ * \brief Get view of a row
+ *
+ * \param[in] row
+ * Logical row index, \c 0 being the oldest row.
+ *
+ * \return
+ * Returns view of the row
+ */
+template<typename T, typename Allocator>
+Array2DLineView<T> RingArray2D<T, Allocator>::rowView(size_t row)
+{
+    return Array2DLineView<T>(rowData(row), m_cols);
+}
+
+/*!
+ * \overload
+ */
+template<typename T, typename Allocator>
+Array2DLineView<const T> RingArray2D<T, Allocator>::rowView(size_t row) const
+{
+    return Array2DLineView<const T>(rowData(row), m_cols);
+}
+
+/*!
+ * \brief Get pointer to elements of a row
+ *
+ * \param[in] row
+ * Logical row index, \c 0 being the oldest row.
+ *
+ * \return
+ * Returns pointer to contiguous elements of the row
+ */
+template<typename T, typename Allocator>
+T* RingArray2D<T, Allocator>::rowData(size_t row)
+{
+    return m_data.data() + physicalRow(row) * m_cols;
+}
+
+/*!
+ * \overload
+ */
+template<typename T, typename Allocator>
+const T* RingArray2D<T, Allocator>::rowData(size_t row) const
+{
+    return m_data.data() + physicalRow(row) * m_cols;
+}
+
+/*!
+ * \brief Access element at specified position
+ *
+ * \param[in] row
+ * Logical row index, \c 0 being the oldest row.
+ * \param[in] col
+ * Column index.
+ *
+ * \return
+ * Returns reference to element
+ */
+template<typename T, typename Allocator>
+T& RingArray2D<T, Allocator>::operator()(size_t row, size_t col)
+{
+    return rowData(row)[col];
+}
+
+/*!
+ * \overload
+ */
+template<typename T, typename Allocator>
+const T& RingArray2D<T, Allocator>::operator()(size_t row, size_t col) const
+{
+    return rowData(row)[col];
+}
+
+/*!
+ * \brief Convert a logical row index to a physical one
+ *
+ * \param[in] row
+ * Logical row index, lower than capacity.
+ *
+ * \return
+ * Returns physical row index in storage
+ */
+template<typename T, typename Allocator>
+size_t RingArray2D<T, Allocator>::physicalRow(size_t row) const
+{
+    const size_t index = m_head + row;
+    return index >= m_capacity ? index - m_capacity : index;
+}
+
+/*!
+ * \brief Get number of rows of first physical segment
+ *
+ * \return
+ * Returns number of rows stored after head
+ * of circular buffer.
+ */
+template<typename T, typename Allocator>
+size_t RingArray2D<T, Allocator>::firstSegmentRows() const
+{
+    return std::min(m_count, m_capacity - m_head);
+}
+
+} // namespace tbq
+
+#endif // TBQ_CONTAINER_RINGARRAY2D_H
@@ -0,0 +1,625 @@
+#ifndef TBQ_CONTAINER_SPARSEARRAY2D_H
+#define TBQ_CONTAINER_SPARSEARRAY2D_H
+
+#include "toolboxqt/toolboxqt_global.h"
+#include "toolboxqt/containers/array2d.h"
+
+#include <QHash>
+#include <QVector>
+
+#include <algorithm>
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/* Define template interface */
+/*****************************/
+
+/*!
+ * \class SparseArray2D
+ * \brief Use to manage a 2-dimensional array mostly
+ * filled with a default value
+ * \details
+ * Only cells which doesn't contains the default value
+ * are stored. Two storage modes are used:
+ * - <b>Build mode:</b> cells are stored in a hash table, insertion of
+ * any cell is performed in constant time. This is the mode used after
+ * construction or after insertion of a new cell.
+ * - <b>Compressed mode:</b> cells are stored using <em>compressed sparse rows</em>
+ * format (CSR), which use less memory, allow to iterate cells in order and
+ * is faster to read. Use squeeze() to switch to this mode once array is built.
+ *
+ * \code{.cpp}
+ * tbq::SparseArray2D<quint8> occupancy(100000, 100000);
+ * occupancy.insert(12, 5000, 1);
+ * occupancy.insert(8000, 3, 1);
+ * occupancy.squeeze();
+ *
+ * occupancy.forEachNonDefault([](size_t row, size_t col, const quint8 &value){
+ *     // Cells are walked row by row
+ * });
+ * \endcode
+ */
+template <typename T>
+class SparseArray2D
+{
+
+public:
+    explicit SparseArray2D(const T &defaultValue = T());
+    explicit SparseArray2D(size_t nbRows, size_t nbCols, const T &defaultValue = T());
+
+public:
+    template<typename Layout, typename Allocator>
+    static SparseArray2D fromDense(const Array2D<T, Layout, Allocator> &dense, const T &defaultValue = T());
+
+    template<typename Layout = Array2DLayoutRowMajor, typename Allocator = Array2DAllocatorHeap>
+    Array2D<T, Layout, Allocator> toDense() const;
+
+public:
+    size_t getRows() const;
+    size_t getCols() const;
+    size_t getSize() const;
+
+    size_t getNonDefaultCount() const;
+    const T& getDefaultValue() const;
+
+    bool isCompressed() const;
+
+public:
+    void clear();
+    void resize(size_t nbRows, size_t nbCols);
+    void squeeze();
+
+    void insert(size_t row, size_t col, const T &value);
+    void remove(size_t row, size_t col);
+
+public:
+    bool contains(size_t row, size_t col) const;
+
+    template<typename Fct>
+    void forEachNonDefault(Fct fct) const;
+
+    template<typename Fct>
+    void forEachNonDefaultInRow(size_t row, Fct fct) const;
+
+public:
+    const T& operator()(size_t row, size_t col) const;
+
+private:
+    quint64 keyOf(size_t row, size_t col) const;
+    const T* find(size_t row, size_t col) const;
+    int findCompressed(size_t row, size_t col) const;
+
+    void expand();
+
+private:
+    size_t m_rows;
+    size_t m_cols;
+    T m_defaultValue;
+
+    QHash<quint64, T> m_cells;
+
+    bool m_compressed;
+    QVector<quint64> m_csrRowOffsets;
+    QVector<quint64> m_csrCols;
+    QVector<T> m_csrValues;
+};
+
+/*****************************/
+/* Define template
+ *      implementation       */
+/*****************************/
+
+/*!
+ * \brief Construct an empty sparse 2D array
+ *
+ * \param[in] defaultValue
+ * Value of cells which are not stored.
+ */
+template<typename T>
+SparseArray2D<T>::SparseArray2D(const T &defaultValue)
+    : m_rows(0), m_cols(0), m_defaultValue(defaultValue), m_compressed(false)
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Construct a sparse 2D array at specified
+ * size, all cells having default value
+ *
+ * \param[in] nbRows
+ * Number of rows.
+ * \param[in] nbCols
+ * Number of colums
+ * \param[in] defaultValue
+ * Value of cells which are not stored.
+ */
+template<typename T>
+SparseArray2D<T>::SparseArray2D(size_t nbRows, size_t nbCols, const T &defaultValue)
+    : m_rows(nbRows), m_cols(nbCols), m_defaultValue(defaultValue), m_compressed(false)
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Build a sparse 2D array from a dense one
+ *
+ * \param[in] dense
+ * Dense array to convert.
+ * \param[in] defaultValue
+ * Value of cells which must not be stored.
+ *
+ * \return
+ * Returns sparse array in compressed mode.
+ *
+ * \sa toDense()
+ */
+template<typename T>
+template<typename Layout, typename Allocator>
+SparseArray2D<T> SparseArray2D<T>::fromDense(const Array2D<T, Layout, Allocator> &dense, const T &defaultValue)
+{
+    SparseArray2D<T> sparse(dense.getRows(), dense.getCols(), defaultValue);
+
+    /* Directly build compressed storage, rows are walked in order */
+    sparse.m_compressed = true;
+    sparse.m_csrRowOffsets.reserve(static_cast<int>(dense.getRows() + 1));
+    sparse.m_csrRowOffsets.append(0);
+
+    for(size_t row = 0; row < dense.getRows(); ++row){
+        const Array2DLineView<const T> line = dense.rowView(row);
+        for(size_t col = 0; col < line.getSize(); ++col){
+            const T &value = line[col];
+            if(!(value == defaultValue)){
+                sparse.m_csrCols.append(col);
+                sparse.m_csrValues.append(value);
+            }
+        }
+        sparse.m_csrRowOffsets.append(static_cast<quint64>(sparse.m_csrCols.size()));
+    }
+
+    return sparse;
+}
+
+/*!
+ * \brief Convert sparse array to a dense 2D array
+ *
+ * \return
+ * Returns dense array where all cells are set.
+ *
+ * \sa fromDense()
+ */
+template<typename T>
+template<typename Layout, typename Allocator>
+Array2D<T, Layout, Allocator> SparseArray2D<T>::toDense() const
+{
+    Array2D<T, Layout, Allocator> dense(m_rows, m_cols);
+    if(dense.getSize() == 0){
+        return dense;
+    }
+
+    std::fill(dense.data(), dense.data() + dense.getSize(), m_defaultValue);
+
+    forEachNonDefault([&dense](size_t row, size_t col, const T &value){
+        dense(row, col) = value;
+    });
+
+    return dense;
+}
+
+/*!
+ * \brief Get number of rows
+ *
+ * \return
+ * Returns number of rows available
+ *
+ * \sa getCols(), getSize()
+ */
+template<typename T>
+size_t SparseArray2D<T>::getRows() const
+{
+    return m_rows;
+}
+
+/*!
+ * \brief Get number of columns
+ *
+ * \return
+ * Returns number of columns available
+ *
+ * \sa getRows(), getSize()
+ */
+template<typename T>
+size_t SparseArray2D<T>::getCols() const
+{
+    return m_cols;
+}
+
+/*!
+ * \brief Get total size of 2D array (a.k.a number
+ * of cells, stored or not)
+ *
+ * \return
+ * Returns number of cells
+ *
+ * \sa getNonDefaultCount()
+ */
+template<typename T>
+size_t SparseArray2D<T>::getSize() const
+{
+    return m_rows * m_cols;
+}
+
+/*!
+ * \brief Get number of stored cells
+ *
+ * \return
+ * Returns number of cells which doesn't contains
+ * default value
+ */
+template<typename T>
+size_t SparseArray2D<T>::getNonDefaultCount() const
+{
+    return m_compressed ? static_cast<size_t>(m_csrValues.size()) : static_cast<size_t>(m_cells.size());
+}
+
+/*!
+ * \brief Get value of cells which are not stored
+ *
+ * \return
+ * Returns reference to default value
+ */
+template<typename T>
+const T& SparseArray2D<T>::getDefaultValue() const
+{
+    return m_defaultValue;
+}
+
+/*!
+ * \brief Use to know if compressed storage is used
+ *
+ * \return
+ * Returns \c true if compressed
+ *
+ * \sa squeeze()
+ */
+template<typename T>
+bool SparseArray2D<T>::isCompressed() const
+{
+    return m_compressed;
+}
+
+/*!
+ * \brief Clear content of 2D array
+ * \details
+ * Size will be reset to \c 0 and all cells will
+ * be removed
+ */
+template<typename T>
+void SparseArray2D<T>::clear()
+{
+    m_rows = 0;
+    m_cols = 0;
+
+    m_cells.clear();
+
+    m_compressed = false;
+    m_csrRowOffsets.clear();
+    m_csrCols.clear();
+    m_csrValues.clear();
+}
+
+/*!
+ * \brief Resize array to specified size
+ * \details
+ * Stored cells outside of new size are removed.
+ *
+ * \param[in] nbRows
+ * Number of rows.
+ * \param[in] nbCols
+ * Number of colums
+ */
+template<typename T>
+void SparseArray2D<T>::resize(size_t nbRows, size_t nbCols)
+{
+    if(nbRows == m_rows && nbCols == m_cols){
+        return;
+    }
+
+    /* Keys depends on number of columns, so rebuild cells */
+    QHash<quint64, T> cells;
+    forEachNonDefault([&](size_t row, size_t col, const T &value){
+        if(row < nbRows && col < nbCols){
+            cells.insert(static_cast<quint64>(row) * nbCols + col, value);
+        }
+    });
+
+    m_rows = nbRows;
+    m_cols = nbCols;
+    m_cells.swap(cells);
+
+    m_compressed = false;
+    m_csrRowOffsets.clear();
+    m_csrCols.clear();
+    m_csrValues.clear();
+}
+
+/*!
+ * \brief Switch to compressed storage
+ * \details
+ * Compressed storage use less memory and allow faster reads, it
+ * should be used once array is built. \n
+ * Inserting a cell which is not already stored will switch back
+ * to build mode.
+ *
+ * \sa isCompressed()
+ */
+template<typename T>
+void SparseArray2D<T>::squeeze()
+{
+    if(m_compressed){
+        return;
+    }
+
+    /* Sort stored cells */
+    QVector<quint64> keys;
+    keys.reserve(m_cells.size());
+    for(auto it = m_cells.cbegin(); it != m_cells.cend(); ++it){
+        keys.append(it.key());
+    }
+    std::sort(keys.begin(), keys.end());
+
+    /* Build compressed rows */
+    m_csrRowOffsets.fill(0, static_cast<int>(m_rows + 1));
+    m_csrCols.clear();
+    m_csrCols.reserve(keys.size());
+    m_csrValues.clear();
+    m_csrValues.reserve(keys.size());
+
+    for(const quint64 key : keys){
+        const size_t row = static_cast<size_t>(key / m_cols);
+        m_csrCols.append(key % m_cols);
+        m_csrValues.append(m_cells.value(key));
+        ++m_csrRowOffsets[static_cast<int>(row + 1)];
+    }
+
+    for(size_t row = 0; row < m_rows; ++row){
+        m_csrRowOffsets[static_cast<int>(row + 1)] += m_csrRowOffsets[static_cast<int>(row)];
+    }
+
+    m_cells.clear();
+    m_cells.squeeze();
+    m_compressed = true;
+}
+
+/*!
+ * \brief Use to insert a value at specified
+ * indexes.
+ * \details
+ * Inserting default value removes the cell.
+ *
+ * \param[in] row
+ * Row index to use. \n
+ * Must be valid (i.e <tt>0 <= row < getRows()</tt>).
+ * \param[in] col
+ * Column index to use. \n
+ * Must be valid (i.e <tt>0 <= col < getCols()</tt>).
+ * \param[in] value
+ * Value to insert
+ *
+ * \sa remove()
+ */
+template<typename T>
+void SparseArray2D<T>::insert(size_t row, size_t col, const T &value)
+{
+    if(value == m_defaultValue){
+        remove(row, col);
+        return;
+    }
+
+    /* Existing compressed cells can be updated in-place */
+    if(m_compressed){
+        const int idCell = findCompressed(row, col);
+        if(idCell >= 0){
+            m_csrValues[idCell] = value;
+            return;
+        }
+        expand();
+    }
+
+    m_cells.insert(keyOf(row, col), value);
+}
+
+/*!
+ * \brief Reset a cell to default value
+ *
+ * \param[in] row
+ * Row index to use. \n
+ * Must be valid (i.e <tt>0 <= row < getRows()</tt>).
+ * \param[in] col
+ * Column index to use. \n
+ * Must be valid (i.e <tt>0 <= col < getCols()</tt>).
+ */
+template<typename T>
+void SparseArray2D<T>::remove(size_t row, size_t col)
+{
+    if(m_compressed){
+        if(findCompressed(row, col) < 0){
+            return;
+        }
+        expand();
+    }
+
+    m_cells.remove(keyOf(row, col));
+}
+
+/*!
+ * \brief Use to know if a cell is stored
+ *
+ * \param[in] row
+ * Row index to use. \n
+ * Must be valid (i.e <tt>0 <= row < getRows()</tt>).
+ * \param[in] col
+ * Column index to use. \n
+ * Must be valid (i.e <tt>0 <= col < getCols()</tt>).
+ *
+ * \return
+ * Returns \c true if cell doesn't contain default value
+ */
+template<typename T>
+bool SparseArray2D<T>::contains(size_t row, size_t col) const
+{
+    return find(row, col) != nullptr;
+}
+
+/*!
+ * \brief Call a function for each stored cell
+ * \details
+ * In compressed mode, cells are walked row by row, otherwise
+ * order is unspecified.
+ *
+ * \param[in] fct
+ * Function to call, signature must be equivalent to
+ * <tt>void fct(size_t row, size_t col, const T &value)</tt>. \n
+ * Array must not be modified by this function.
+ *
+ * \sa forEachNonDefaultInRow()
+ */
+template<typename T>
+template<typename Fct>
+void SparseArray2D<T>::forEachNonDefault(Fct fct) const
+{
+    if(m_compressed){
+        for(size_t row = 0; row < m_rows; ++row){
+            forEachNonDefaultInRow(row, fct);
+        }
+        return;
+    }
+
+    for(auto it = m_cells.cbegin(); it != m_cells.cend(); ++it){
+        fct(static_cast<size_t>(it.key() / m_cols), static_cast<size_t>(it.key() % m_cols), it.value());
+    }
+}
+
+/*!
+ * \brief Call a function for each stored cell of
+ * a row
+ * \details
+ * This method is efficient in compressed mode only, in build
+ * mode all stored cells have to be walked.
+ *
+ * \param[in] row
+ * Row index to use. \n
+ * Must be valid (i.e <tt>0 <= row < getRows()</tt>).
+ * \param[in] fct
+ * Function to call, signature must be equivalent to
+ * <tt>void fct(size_t row, size_t col, const T &value)</tt>. \n
+ * Array must not be modified by this function.
+ *
+ * \sa forEachNonDefault()
+ */
+template<typename T>
+template<typename Fct>
+void SparseArray2D<T>::forEachNonDefaultInRow(size_t row, Fct fct) const
+{
+    if(m_compressed){
+        const int idEnd = static_cast<int>(m_csrRowOffsets[static_cast<int>(row + 1)]);
+        for(int id = static_cast<int>(m_csrRowOffsets[static_cast<int>(row)]); id < idEnd; ++id){
+            fct(row, static_cast<size_t>(m_csrCols[id]), m_csrValues[id]);
+        }
+        return;
+    }
+
+    for(auto it = m_cells.cbegin(); it != m_cells.cend(); ++it){
+        if(it.key() / m_cols == row){
+            fct(row, static_cast<size_t>(it.key() % m_cols), it.value());
+        }
+    }
+}
+
+/*!
+ * \brief Get constant reference to an element
+ * \details
+ * Only read access is available, use insert() to
+ * modify a cell (this allow to not store cells containing
+ * default value).
+ *
+ * \param[in] row
+ * Row index to use. \n
+ * Must be valid (i.e <tt>0 <= row < getRows()</tt>).
+ * \param[in] col
+ * Column index to use. \n
+ * Must be valid (i.e <tt>0 <= col < getCols()</tt>).
+ *
+ * \return
+ * Returns constant reference to an element, or to
+ * default value if cell is not stored
+ */
+template<typename T>
+const T& SparseArray2D<T>::operator()(size_t row, size_t col) const
+{
+    const T *cell = find(row, col);
+    return cell ? *cell : m_defaultValue;
+}
+
+template<typename T>
+quint64 SparseArray2D<T>::keyOf(size_t row, size_t col) const
+{
+    return static_cast<quint64>(row) * m_cols + col;
+}
+
+template<typename T>
+const T* SparseArray2D<T>::find(size_t row, size_t col) const
+{
+    if(!m_compressed){
+        const auto it = m_cells.constFind(keyOf(row, col));
+        return it != m_cells.cend() ? &it.value() : nullptr;
+    }
+
+    const int idCell = findCompressed(row, col);
+    return idCell >= 0 ? m_csrValues.constData() + idCell : nullptr;
+}
+
+template<typename T>
+int SparseArray2D<T>::findCompressed(size_t row, size_t col) const
+{
+    /* Columns of a row are sorted */
+    const quint64 *colsBegin = m_csrCols.constData() + m_csrRowOffsets[static_cast<int>(row)];
+    const quint64 *colsEnd = m_csrCols.constData() + m_csrRowOffsets[static_cast<int>(row + 1)];
+
+    const quint64 *it = std::lower_bound(colsBegin, colsEnd, static_cast<quint64>(col));
+    if(it == colsEnd || *it != col){
+        return -1;
+    }
+
+    return static_cast<int>(it - m_csrCols.constData());
+}
+
+template<typename T>
+void SparseArray2D<T>::expand()
+{
+    QHash<quint64, T> cells;
+    cells.reserve(m_csrValues.size());
+
+    for(size_t row = 0; row < m_rows; ++row){
+        const int idEnd = static_cast<int>(m_csrRowOffsets[static_cast<int>(row + 1)]);
+        for(int id = static_cast<int>(m_csrRowOffsets[static_cast<int>(row)]); id < idEnd; ++id){
+            cells.insert(keyOf(row, static_cast<size_t>(m_csrCols[id])), m_csrValues[id]);
+        }
+    }
+
+    m_cells.swap(cells);
+
+    m_compressed = false;
+    m_csrRowOffsets.clear();
+    m_csrCols.clear();
+    m_csrValues.clear();
+}
+
+} // namespace tbq
+
+#endif // TBQ_CONTAINER_SPARSEARRAY2D_H
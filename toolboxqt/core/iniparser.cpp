@@ -0,0 +1,806 @@
+#include "iniparser.h"
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QFile>
+#include <QPoint>
+#include <QRect>
+#include <QSize>
+
+/*****************************/
+/* Class documentations      */
+/*****************************/
+
+/*!
+ * \class tbq::IniParser
+ * \brief Fast parser of INI files, compatible with \c QSettings
+ * \details
+ * This class reads INI files written by \c QSettings::IniFormat
+ * (and by hand or by other tools), and produces same keys and values
+ * than \c QSettings::allKeys() and \c QSettings::value():
+ * - Sections, with \c [General] being the root section
+ * - Keys and sections escaping (\c %XX, \c %UXXXX and \c \\ for \c /)
+ * - Values escaping (C-style escapes, quotes, line continuations),
+ *   string lists (values separated by commas) and special values
+ *   (\c @ByteArray(), \c @Variant(), \c @Rect()...)
+ * - Comments starting with \c ;
+ *
+ * File is memory-mapped and parsed in a single pass, without copying
+ * lines: only keys and values are allocated, directly in the
+ * resulting hash. It is much faster than \c QSettings on large files,
+ * but is read-only (tbq::SettingsIni still uses \c QSettings to write).
+ *
+ * \code{.cpp}
+ * tbq::IniParser::Values values;
+ * if(tbq::IniParser::parseFile("/etc/app/tuning.ini", values)){
+ *     const int gain = values.value("tuning/gain").toInt();
+ * }
+ * \endcode
+ *
+ * \note
+ * Values are decoded from UTF-8 with Qt 6, and from Latin-1 with Qt 5,
+ * as \c QSettings does without custom codec. Keys are always case
+ * sensitive.
+ */
+
+/*****************************/
+/*      Custom types
+ *     documentations        */
+/*****************************/
+
+/*!
+ * \typedef IniParser::Values
+ * \brief Map of parsed values, keys being full
+ * paths (<tt>"section/key"</tt>)
+ */
+
+/*****************************/
+/* Macro definitions         */
+/*****************************/
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/* Constants definitions     */
+/*****************************/
+
+/* Same classification than QSettings INI reader */
+struct CharTraits
+{
+    enum Trait
+    {
+        TRAIT_SPACE = 0x1,
+        TRAIT_SPECIAL = 0x2
+    };
+
+    CharTraits()
+    {
+        for(int c = 0; c < 256; ++c){
+            traits[c] = 0;
+        }
+
+        for(char c : {' ', '\t', '\n', '\r', '\f', '\v'}){
+            traits[static_cast<uchar>(c)] |= TRAIT_SPACE;
+        }
+
+        for(char c : {'\n', '\r', '"', ';', '=', '\\'}){
+            traits[static_cast<uchar>(c)] |= TRAIT_SPECIAL;
+        }
+    }
+
+    bool isSpace(char c) const
+    {
+        return traits[static_cast<uchar>(c)] & TRAIT_SPACE;
+    }
+
+    bool isSpecial(char c) const
+    {
+        return traits[static_cast<uchar>(c)] & TRAIT_SPECIAL;
+    }
+
+    uchar traits[256];
+};
+
+static const CharTraits g_charTraits;
+
+/*****************************/
+/* Functions implementation  */
+/*         Local             */
+/*****************************/
+
+static void appendBytes(QString &result, const char *data, qint64 size)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    result += QString::fromUtf8(data, static_cast<qsizetype>(size));
+#else
+    result += QString::fromLatin1(data, static_cast<int>(size));
+#endif
+}
+
+static void trimBytes(const char *data, qint64 &begin, qint64 &end)
+{
+    while(begin < end && g_charTraits.isSpace(data[begin])){
+        ++begin;
+    }
+    while(end > begin && g_charTraits.isSpace(data[end - 1])){
+        --end;
+    }
+}
+
+static qint64 skipBlanks(const char *data, qint64 size, qint64 pos)
+{
+    while(pos < size && (data[pos] == ' ' || data[pos] == '\t')){
+        ++pos;
+    }
+
+    return pos;
+}
+
+static void chopBlanks(QString &str, int limit)
+{
+    int size = str.size();
+    while(size > limit && (str.at(size - 1) == QLatin1Char(' ') || str.at(size - 1) == QLatin1Char('\t'))){
+        --size;
+    }
+
+    str.truncate(size);
+}
+
+static int hexValue(char c)
+{
+    if(c >= '0' && c <= '9'){
+        return c - '0';
+    }
+    if(c >= 'a' && c <= 'f'){
+        return c - 'a' + 10;
+    }
+    if(c >= 'A' && c <= 'F'){
+        return c - 'A' + 10;
+    }
+
+    return -1;
+}
+
+static char escapedChar(char code)
+{
+    switch(code){
+        case 'a':   return '\a';
+        case 'b':   return '\b';
+        case 'f':   return '\f';
+        case 'n':   return '\n';
+        case 'r':   return '\r';
+        case 't':   return '\t';
+        case 'v':   return '\v';
+        case '"':   return '"';
+        case '?':   return '?';
+        case '\'':  return '\'';
+        case '\\':  return '\\';
+        default:    return 0;
+    }
+}
+
+static bool isSafeKeyChar(char c)
+{
+    return c != '\\' && c != '%';
+}
+
+static bool startsWithNoCase(const char *data, qint64 size, const char *prefix, qint64 sizePrefix)
+{
+    if(size != sizePrefix){
+        return false;
+    }
+
+    for(qint64 i = 0; i < size; ++i){
+        char c = data[i];
+        if(c >= 'A' && c <= 'Z'){
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+        if(c != prefix[i]){
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static QStringList splitArgs(const QString &str, int idx)
+{
+    QStringList result;
+    QString item;
+
+    for(++idx; idx < str.size(); ++idx){
+        const QChar c = str.at(idx);
+        if(c == QLatin1Char(')')){
+            result.append(item);
+        }else if(c == QLatin1Char(' ')){
+            result.append(item);
+            item.clear();
+        }else{
+            item.append(c);
+        }
+    }
+
+    return result;
+}
+
+/*****************************/
+/* Functions implementation  */
+/*         Class             */
+/*****************************/
+
+/*!
+ * \brief Parse an INI file
+ * \details
+ * File is memory-mapped when possible and allowed, otherwise
+ * it is read. \n
+ * Malformed lines are ignored, like \c QSettings does.
+ *
+ * \param[in] filePath
+ * Path of INI file.
+ * \param[out] values
+ * Parsed values are inserted in it, existing values with
+ * same keys are replaced.
+ * \param[in] mapFile
+ * Set to \c false to read file instead of mapping it.
+ *
+ * \warning
+ * A mapped file truncated by another process while it is parsed
+ * raises \c SIGBUS. Don't map files which may be rewritten in
+ * place during parsing (watched files for example).
+ *
+ * \return
+ * Returns \c true if succeed. \n
+ * Returns \c false if file can't be read.
+ */
+bool IniParser::parseFile(const QString &filePath, Values &values, bool mapFile)
+{
+    QFile file(filePath);
+    if(!file.open(QIODevice::ReadOnly)){
+        return false;
+    }
+
+    const qint64 size = file.size();
+    if(size <= 0){
+        return true;
+    }
+
+    /* Prefer mapping, fallback on reading (for files which can't be mapped) */
+    uchar *data = mapFile ? file.map(0, size) : nullptr;
+    if(data){
+        parseData(reinterpret_cast<const char*>(data), size, values);
+        file.unmap(data);
+        return true;
+    }
+
+    const QByteArray content = file.readAll();
+    parseData(content.constData(), content.size(), values);
+
+    return true;
+}
+
+/*!
+ * \brief Parse INI content
+ * \details
+ * Content is parsed in a single pass. Malformed
+ * lines are ignored, like \c QSettings does.
+ *
+ * \param[in] data
+ * INI content (a UTF-8 byte order mark is allowed).
+ * \param[in] size
+ * Size of content in bytes.
+ * \param[out] values
+ * Parsed values are inserted in it, existing values with
+ * same keys are replaced.
+ */
+void IniParser::parseData(const char *data, qint64 size, Values &values)
+{
+    /* Skip possible UTF-8 BOM */
+    if(size >= 3 && data[0] == '\xef' && data[1] == '\xbb' && data[2] == '\xbf'){
+        data += 3;
+        size -= 3;
+    }
+
+    QString section;
+    QString strValue;
+    QStringList listValue;
+
+    qint64 pos = 0;
+    qint64 lineStart = 0;
+    qint64 lineLen = 0;
+    qint64 equalsPos = -1;
+
+    while(readLine(data, size, pos, lineStart, lineLen, equalsPos)){
+        const char *line = data + lineStart;
+
+        /* Start of a section */
+        if(line[0] == '['){
+            qint64 idx = 1;
+            while(idx < lineLen && line[idx] != ']'){
+                ++idx;
+            }
+
+            qint64 begin = 1;
+            qint64 end = idx;
+            trimBytes(line, begin, end);
+
+            section.clear();
+            if(startsWithNoCase(line + begin, end - begin, "general", 7)){
+                continue;
+            }
+
+            if(startsWithNoCase(line + begin, end - begin, "%general", 8)){
+                section = QString::fromLatin1(line + begin + 1, static_cast<int>(end - begin - 1));
+            }else{
+                unescapeKey(line + begin, end - begin, section);
+            }
+            section += QLatin1Char('/');
+
+            continue;
+        }
+
+        /* Lines without key are ignored (comments or malformed lines) */
+        if(equalsPos < 0){
+            continue;
+        }
+
+        qint64 keyBegin = 0;
+        qint64 keyEnd = equalsPos - lineStart;
+        trimBytes(line, keyBegin, keyEnd);
+
+        QString key;
+        key.reserve(section.size() + static_cast<int>(keyEnd - keyBegin));
+        key += section;
+        unescapeKey(line + keyBegin, keyEnd - keyBegin, key);
+
+        normalizeKey(key);
+        if(key.isEmpty()){
+            continue;
+        }
+
+        const qint64 valueBegin = equalsPos - lineStart + 1;
+        /* Keep buffer allocated, an empty value must not be a null string (like QSettings) */
+        strValue.resize(0);
+
+        if(unescapeValue(line + valueBegin, lineLen - valueBegin, strValue, listValue)){
+            values.insert(key, listToVariant(listValue));
+        }else{
+            values.insert(key, stringToVariant(strValue));
+        }
+    }
+}
+
+/*!
+ * \brief Read next logical line
+ * \details
+ * Same rules than \c QSettings are used: empty lines and
+ * comments are skipped, quoted values and escaped line
+ * terminators can span multiple physical lines.
+ *
+ * \param[in] data
+ * INI content.
+ * \param[in] size
+ * Size of content.
+ * \param[in, out] pos
+ * Position to read from, will be set to end of line.
+ * \param[out] lineStart
+ * Position of first character of line.
+ * \param[out] lineLen
+ * Length of line.
+ * \param[out] equalsPos
+ * Position of first \c = (outside of quotes),
+ * \c -1 if none.
+ *
+ * \return
+ * Returns \c false if there is no more line.
+ */
+bool IniParser::readLine(const char *data, qint64 size, qint64 &pos, qint64 &lineStart, qint64 &lineLen, qint64 &equalsPos)
+{
+    bool inQuotes = false;
+    equalsPos = -1;
+
+    lineStart = pos;
+    while(lineStart < size && g_charTraits.isSpace(data[lineStart])){
+        ++lineStart;
+    }
+
+    qint64 i = lineStart;
+    while(i < size){
+        /* Skip regular characters */
+        char ch = data[i];
+        while(!g_charTraits.isSpecial(ch)){
+            if(++i == size){
+                pos = i;
+                lineLen = i - lineStart;
+                return lineLen > 0;
+            }
+            ch = data[i];
+        }
+
+        ++i;
+        if(ch == '='){
+            if(!inQuotes && equalsPos == -1){
+                equalsPos = i - 1;
+            }
+        }else if(ch == '\n' || ch == '\r'){
+            if(i == lineStart + 1){
+                ++lineStart;
+            }else if(!inQuotes){
+                --i;
+                break;
+            }
+        }else if(ch == '\\'){
+            /* Escaped character, line terminators may be two characters long */
+            if(i < size){
+                const char escaped = data[i++];
+                if(i < size){
+                    const char next = data[i];
+                    if((escaped == '\n' && next == '\r') || (escaped == '\r' && next == '\n')){
+                        ++i;
+                    }
+                }
+            }
+        }else if(ch == '"'){
+            inQuotes = !inQuotes;
+        }else{
+            /* Comment: skip it if it starts the line, otherwise it ends the line */
+            if(i == lineStart + 1){
+                while(i < size && data[i] != '\n' && data[i] != '\r'){
+                    ++i;
+                }
+                while(i < size && g_charTraits.isSpace(data[i])){
+                    ++i;
+                }
+                lineStart = i;
+            }else if(!inQuotes){
+                --i;
+                break;
+            }
+        }
+    }
+
+    pos = i;
+    lineLen = i - lineStart;
+    return lineLen > 0;
+}
+
+/*!
+ * \brief Unescape a key or a section name
+ * \details
+ * \c \\ is converted to \c /, and \c %XX and \c %UXXXX
+ * are converted to the corresponding character.
+ *
+ * \param[in] data
+ * Escaped key.
+ * \param[in] size
+ * Size of escaped key.
+ * \param[out] result
+ * Unescaped key is appended to it.
+ */
+void IniParser::unescapeKey(const char *data, qint64 size, QString &result)
+{
+    /* Fast path: most keys doesn't contain escaped characters */
+    qint64 i = 0;
+    while(i < size && isSafeKeyChar(data[i])){
+        ++i;
+    }
+
+    result += QString::fromLatin1(data, static_cast<int>(i));
+
+    while(i < size){
+        const char ch = data[i];
+
+        if(ch == '\\'){
+            result += QLatin1Char('/');
+            ++i;
+            continue;
+        }
+
+        if(ch != '%' || i == size - 1){
+            result += QChar(static_cast<uchar>(ch));
+            ++i;
+            continue;
+        }
+
+        int nbDigits = 2;
+        qint64 firstDigit = i + 1;
+        if(data[firstDigit] == 'U'){
+            ++firstDigit;
+            nbDigits = 4;
+        }
+
+        /* Invalid escape sequences are kept as is */
+        int value = 0;
+        bool valid = firstDigit + nbDigits <= size;
+        for(int d = 0; valid && d < nbDigits; ++d){
+            const int digit = hexValue(data[firstDigit + d]);
+            valid = digit >= 0;
+            value = value * 16 + digit;
+        }
+
+        if(!valid){
+            result += QLatin1Char('%');
+            ++i;
+            continue;
+        }
+
+        result += QChar(static_cast<ushort>(value));
+        i = firstDigit + nbDigits;
+    }
+}
+
+/*!
+ * \brief Unescape a value
+ * \details
+ * Leading blanks are skipped and trailing blanks are removed
+ * (excepting in quoted values). C-style escapes are converted,
+ * and values separated by commas (outside of quotes) are
+ * considered as string list.
+ *
+ * \param[in] data
+ * Escaped value.
+ * \param[in] size
+ * Size of escaped value.
+ * \param[out] stringResult
+ * Unescaped value, if not a string list.
+ * \param[out] listResult
+ * Unescaped values, if a string list.
+ *
+ * \return
+ * Returns \c true if value is a string list.
+ */
+bool IniParser::unescapeValue(const char *data, qint64 size, QString &stringResult, QStringList &listResult)
+{
+    bool isList = false;
+    bool inQuotes = false;
+    bool quoted = false;
+
+    qint64 i = skipBlanks(data, size, 0);
+    int chopLimit = stringResult.size();
+
+    while(i < size){
+        const char ch = data[i];
+
+        if(ch == '\\'){
+            ++i;
+            if(i >= size){
+                chopLimit = stringResult.size();
+                break;
+            }
+
+            const char code = data[i++];
+            const char escaped = escapedChar(code);
+            if(escaped != 0){
+                stringResult += QLatin1Char(escaped);
+
+            }else if(code == 'x' || (code >= '0' && code <= '7')){
+                /* Hexadecimal and octal escapes have any number of digits */
+                const int base = code == 'x' ? 16 : 8;
+                ushort value = code == 'x' ? 0 : static_cast<ushort>(code - '0');
+                bool hasDigit = code != 'x';
+
+                while(i < size){
+                    const int digit = hexValue(data[i]);
+                    if(digit < 0 || digit >= base){
+                        break;
+                    }
+                    value = static_cast<ushort>(value * base + digit);
+                    hasDigit = true;
+                    ++i;
+                }
+
+                if(hasDigit){
+                    stringResult += QChar(value);
+                }
+
+            }else if(code == '\n' || code == '\r'){
+                /* Escaped line terminator continues the value on next line */
+                if(i < size && (data[i] == '\n' || data[i] == '\r') && data[i] != code){
+                    ++i;
+                }
+            }
+
+            chopLimit = stringResult.size();
+            continue;
+        }
+
+        if(ch == '"'){
+            ++i;
+            quoted = true;
+            inQuotes = !inQuotes;
+            if(!inQuotes){
+                i = skipBlanks(data, size, i);
+                chopLimit = stringResult.size();
+            }
+            continue;
+        }
+
+        if(ch == ',' && !inQuotes){
+            if(!quoted){
+                chopBlanks(stringResult, chopLimit);
+            }
+            if(!isList){
+                isList = true;
+                listResult.clear();
+            }
+
+            listResult.append(stringResult);
+            stringResult.clear();
+            quoted = false;
+
+            i = skipBlanks(data, size, i + 1);
+            chopLimit = 0;
+            continue;
+        }
+
+        /* Regular characters, commas in quotes are regular ones */
+        qint64 j = i + 1;
+        while(j < size && data[j] != '\\' && data[j] != '"' && data[j] != ','){
+            ++j;
+        }
+
+        appendBytes(stringResult, data + i, j - i);
+        i = j;
+    }
+
+    if(!quoted){
+        chopBlanks(stringResult, chopLimit);
+    }
+
+    if(isList){
+        listResult.append(stringResult);
+    }
+
+    return isList;
+}
+
+/*!
+ * \brief Convert an unescaped string to a value
+ * \details
+ * Special values written by \c QSettings (starting
+ * with \c @) are converted back.
+ *
+ * \param[in] str
+ * Unescaped string.
+ *
+ * \return
+ * Returns converted value.
+ */
+QVariant IniParser::stringToVariant(const QString &str)
+{
+    if(!str.startsWith(QLatin1Char('@'))){
+        return QVariant(str);
+    }
+
+    if(str.endsWith(QLatin1Char(')'))){
+        if(str.startsWith(QLatin1String("@ByteArray("))){
+            return QVariant(str.mid(11, str.size() - 12).toLatin1());
+        }
+        if(str.startsWith(QLatin1String("@String("))){
+            return QVariant(str.mid(8, str.size() - 9));
+        }
+        if(str.startsWith(QLatin1String("@Variant(")) || str.startsWith(QLatin1String("@DateTime("))){
+            const bool isDateTime = str.at(1) == QLatin1Char('D');
+
+            QByteArray bytes = str.mid(isDateTime ? 10 : 9).toLatin1();
+            QDataStream stream(&bytes, QIODevice::ReadOnly);
+            stream.setVersion(isDateTime ? QDataStream::Qt_5_6 : QDataStream::Qt_4_0);
+
+            QVariant result;
+            stream >> result;
+            return result;
+        }
+        if(str.startsWith(QLatin1String("@Rect("))){
+            const QStringList args = splitArgs(str, 5);
+            if(args.size() == 4){
+                return QVariant(QRect(args[0].toInt(), args[1].toInt(), args[2].toInt(), args[3].toInt()));
+            }
+        }
+        if(str.startsWith(QLatin1String("@Size("))){
+            const QStringList args = splitArgs(str, 5);
+            if(args.size() == 2){
+                return QVariant(QSize(args[0].toInt(), args[1].toInt()));
+            }
+        }
+        if(str.startsWith(QLatin1String("@Point("))){
+            const QStringList args = splitArgs(str, 6);
+            if(args.size() == 2){
+                return QVariant(QPoint(args[0].toInt(), args[1].toInt()));
+            }
+        }
+        if(str == QLatin1String("@Invalid()")){
+            return QVariant();
+        }
+    }
+
+    if(str.startsWith(QLatin1String("@@"))){
+        return QVariant(str.mid(1));
+    }
+
+    return QVariant(str);
+}
+
+/*!
+ * \brief Convert unescaped strings to a value
+ *
+ * \param[in] list
+ * Unescaped strings of a string list.
+ *
+ * \return
+ * Returns a \c QStringList, or a \c QVariantList
+ * if a string is a special value.
+ */
+QVariant IniParser::listToVariant(const QStringList &list)
+{
+    QStringList result = list;
+    for(int i = 0; i < result.size(); ++i){
+        const QString &str = result.at(i);
+        if(!str.startsWith(QLatin1Char('@'))){
+            continue;
+        }
+
+        if(str.size() < 2 || str.at(1) != QLatin1Char('@')){
+            QVariantList variants;
+            variants.reserve(list.size());
+            for(const QString &item : list){
+                variants.append(stringToVariant(item));
+            }
+            return variants;
+        }
+
+        result[i].remove(0, 1);
+    }
+
+    return result;
+}
+
+/*!
+ * \brief Normalize slashes of a key like \c QSettings does
+ * \details
+ * Leading, trailing and repeated slashes are removed.
+ *
+ * \param[in, out] key
+ * Key to normalize.
+ */
+void IniParser::normalizeKey(QString &key)
+{
+    /* Fast path: most keys are already normalized */
+    bool normalized = !key.startsWith(QLatin1Char('/')) && !key.endsWith(QLatin1Char('/'));
+    for(int i = 1; normalized && i < key.size(); ++i){
+        normalized = !(key.at(i) == QLatin1Char('/') && key.at(i - 1) == QLatin1Char('/'));
+    }
+
+    if(normalized){
+        return;
+    }
+
+    QString result;
+    result.reserve(key.size());
+
+    for(const QChar c : key){
+        if(c == QLatin1Char('/') && (result.isEmpty() || result.endsWith(QLatin1Char('/')))){
+            continue;
+        }
+        result.append(c);
+    }
+
+    if(result.endsWith(QLatin1Char('/'))){
+        result.chop(1);
+    }
+
+    key = result;
+}
+
+/*****************************/
+/* End namespace             */
+/*****************************/
+
+} // namespace tbq
+
+/*****************************/
+/* End file                  */
+/*****************************/
@@ -0,0 +1,38 @@
+#ifndef TBQ_CORE_INIPARSER_H
+#define TBQ_CORE_INIPARSER_H
+
+#include "toolboxqt/toolboxqt_global.h"
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+
+namespace tbq
+{
+
+class TOOLBOXQT_EXPORT IniParser final
+{
+
+public:
+    using Values = QHash<QString, QVariant>;
+
+public:
+    static bool parseFile(const QString &filePath, Values &values, bool mapFile = true);
+    static void parseData(const char *data, qint64 size, Values &values);
+
+private:
+    static bool readLine(const char *data, qint64 size, qint64 &pos, qint64 &lineStart, qint64 &lineLen, qint64 &equalsPos);
+
+    static void unescapeKey(const char *data, qint64 size, QString &result);
+    static bool unescapeValue(const char *data, qint64 size, QString &stringResult, QStringList &listResult);
+
+    static QVariant stringToVariant(const QString &str);
+    static QVariant listToVariant(const QStringList &list);
+
+    static void normalizeKey(QString &key);
+};
+
+} // namespace tbq
+
+#endif // TBQ_CORE_INIPARSER_H
@@ -0,0 +1,379 @@
+#ifndef TBQ_CORE_SETTINGKEY_H
+#define TBQ_CORE_SETTINGKEY_H
+
+#include "toolboxqt/toolboxqt_global.h"
+#include "toolboxqt/core/settingsini.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
+
+#include <atomic>
+
+/*****************************/
+/* Start namespace           */
+/*****************************/
+
+namespace tbq
+{
+
+/*****************************/
+/* Define template interface */
+/*****************************/
+
+/*!
+ * \class SettingKey
+ * \brief Pre-resolved and typed handle to a key of
+ * tbq::SettingsIni
+ * \details
+ * Full key (group and key) and default value are resolved once, when
+ * handle is constructed, so handles are meant to be declared once
+ * (as static or member variables) and used many times:
+ * \code{.cpp}
+ * static const tbq::SettingKey<int> keyPort("network", "port", 8080);
+ *
+ * // Hot path
+ * const int port = keyPort.get();
+ * \endcode
+ *
+ * Each handle owns a slot in a per-thread cache of values already
+ * converted to \c T. get() only compares version of current snapshot
+ * (see tbq::SettingsIni::getSnapshotVersion()) with version of cached
+ * value: no key building, no hashing, no lock and no \c QVariant
+ * conversion. Value is only looked up and converted again (once
+ * per thread) after settings have been loaded or written. \n
+ * Slots of destroyed handles are reused by new handles, so
+ * handles can also be created dynamically.
+ *
+ * \note
+ * \c T must be default-constructible, copyable and
+ * convertible from \c QVariant (see \c QVariant::value()).
+ *
+ * \warning
+ * Handles must not be used before settings are loaded,
+ * default value will be returned.
+ */
+template <typename T>
+class SettingKey
+{
+
+public:
+    explicit SettingKey(const QString &key, const T &defaultValue = T());
+    SettingKey(const QString &group, const QString &key, const T &defaultValue);
+    SettingKey(const SettingKey &other);
+    ~SettingKey();
+
+    SettingKey& operator=(const SettingKey &other);
+
+public:
+    const QString& getKey() const;
+    const T& getDefaultValue() const;
+
+public:
+    T get() const;
+    void set(const T &value) const;
+
+private:
+    struct Entry
+    {
+        quint64 version = 0;
+        quint64 id = 0;
+        T value;
+    };
+
+private:
+    const T& resolve(Entry &entry, quint64 version) const;
+
+    static QVector<Entry>& getCache();
+    static QVector<int>& getFreeSlots();
+    static QMutex& getMutexSlots();
+
+    static int allocateSlot();
+    static void releaseSlot(int slot);
+
+private:
+    QString m_key;
+    T m_defaultValue;
+    int m_slot;
+    quint64 m_id;
+
+    static std::atomic<int> s_nbSlots;
+    static std::atomic<quint64> s_nbIds;
+};
+
+/*****************************/
+/* Define template           */
+/* implementation            */
+/*****************************/
+
+template <typename T>
+std::atomic<int> SettingKey<T>::s_nbSlots{0};
+
+template <typename T>
+std::atomic<quint64> SettingKey<T>::s_nbIds{0};
+
+/*!
+ * \brief Construct a handle to a key
+ *
+ * \param[in] key
+ * Full key (<tt>"section/key"</tt>), current group of
+ * tbq::SettingsIni is not used.
+ * \param[in] defaultValue
+ * Value to return if key doesn't exist.
+ */
+template <typename T>
+SettingKey<T>::SettingKey(const QString &key, const T &defaultValue)
+    : m_key(SettingsIni::normalizeKey(key)), m_defaultValue(defaultValue), m_slot(allocateSlot()), m_id(s_nbIds.fetch_add(1, std::memory_order_relaxed) + 1)
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Construct a handle to a key of a group
+ *
+ * \param[in] group
+ * Group of the key (<tt>"section"</tt>).
+ * \param[in] key
+ * Key relative to \c group.
+ * \param[in] defaultValue
+ * Value to return if key doesn't exist.
+ */
+template <typename T>
+SettingKey<T>::SettingKey(const QString &group, const QString &key, const T &defaultValue)
+    : SettingKey(group + QLatin1Char('/') + key, defaultValue)
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Construct a copy of a handle
+ * \details
+ * Copy uses its own slot.
+ *
+ * \param[in] other
+ * Handle to copy.
+ */
+template <typename T>
+SettingKey<T>::SettingKey(const SettingKey &other)
+    : m_key(other.m_key), m_defaultValue(other.m_defaultValue), m_slot(allocateSlot()), m_id(s_nbIds.fetch_add(1, std::memory_order_relaxed) + 1)
+{
+    /* Nothing to do */
+}
+
+/*!
+ * \brief Destroy the handle and release its slot,
+ * which can be reused by a new handle
+ */
+template <typename T>
+SettingKey<T>::~SettingKey()
+{
+    releaseSlot(m_slot);
+}
+
+/*!
+ * \brief Copy key and default value of a handle
+ * \details
+ * Handle keeps its own slot, cached values of
+ * previous key are discarded.
+ *
+ * \param[in] other
+ * Handle to copy.
+ *
+ * \return
+ * Returns reference to this handle.
+ */
+template <typename T>
+SettingKey<T>& SettingKey<T>::operator=(const SettingKey &other)
+{
+    if(this != &other){
+        m_key = other.m_key;
+        m_defaultValue = other.m_defaultValue;
+        m_id = s_nbIds.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    return *this;
+}
+
+/*!
+ * \brief Get full key of the handle
+ *
+ * \return
+ * Returns normalized full key (<tt>"section/key"</tt>)
+ */
+template <typename T>
+const QString& SettingKey<T>::getKey() const
+{
+    return m_key;
+}
+
+/*!
+ * \brief Get default value of the handle
+ *
+ * \return
+ * Returns value used when key doesn't exist.
+ */
+template <typename T>
+const T& SettingKey<T>::getDefaultValue() const
+{
+    return m_defaultValue;
+}
+
+/*!
+ * \brief Get value of the key
+ * \details
+ * Can be called from any thread.
+ *
+ * \return
+ * Returns value of the key converted to \c T. \n
+ * Returns default value if key doesn't exist or
+ * if settings are not loaded.
+ */
+template <typename T>
+T SettingKey<T>::get() const
+{
+    const quint64 version = mSettings.getSnapshotVersion();
+
+    QVector<Entry> &cache = getCache();
+    if(m_slot >= cache.size()){
+        cache.resize(qMax(m_slot + 1, s_nbSlots.load(std::memory_order_relaxed)));
+    }
+
+    /* Slot may have been used by a destroyed handle */
+    Entry &entry = cache[m_slot];
+    if(entry.version != version || entry.id != m_id){
+        return resolve(entry, version);
+    }
+
+    return entry.value;
+}
+
+/*!
+ * \brief Set value of the key
+ * \details
+ * Equivalent of tbq::SettingsIni::setValue(), without
+ * using current group.
+ *
+ * \param[in] value
+ * Value to set.
+ */
+template <typename T>
+void SettingKey<T>::set(const T &value) const
+{
+    mSettings.setValueFullKey(m_key, QVariant::fromValue(value));
+}
+
+/*!
+ * \brief Look up and convert value of the key from
+ * current snapshot
+ *
+ * \param[in, out] entry
+ * Cache entry of the handle, for calling thread.
+ * \param[in] version
+ * Snapshot version read before looking up.
+ *
+ * \return
+ * Returns converted value.
+ */
+template <typename T>
+const T& SettingKey<T>::resolve(Entry &entry, quint64 version) const
+{
+    const std::shared_ptr<const SettingsIni::Snapshot> snapshot = mSettings.getSnapshot();
+
+    entry.value = m_defaultValue;
+    if(snapshot){
+        const SettingsIni::Snapshot::const_iterator it = snapshot->constFind(m_key);
+        if(it != snapshot->constEnd() && it.value().template canConvert<T>()){
+            entry.value = it.value().template value<T>();
+        }
+    }
+
+    /*
+     * Snapshot may be newer than version, entry
+     * will then be resolved again on next call
+     */
+    entry.version = version;
+    entry.id = m_id;
+
+    return entry.value;
+}
+
+/*!
+ * \brief Get cache of values of calling thread
+ *
+ * \return
+ * Returns cache, indexed by slots of handles.
+ */
+template <typename T>
+QVector<typename SettingKey<T>::Entry>& SettingKey<T>::getCache()
+{
+    static thread_local QVector<Entry> cache;
+    return cache;
+}
+
+/*!
+ * \brief Get slots released by destroyed handles
+ *
+ * \return
+ * Returns free slots, must be used with getMutexSlots() locked.
+ */
+template <typename T>
+QVector<int>& SettingKey<T>::getFreeSlots()
+{
+    static QVector<int> freeSlots;
+    return freeSlots;
+}
+
+/*!
+ * \brief Get mutex protecting free slots
+ *
+ * \return
+ * Returns mutex to use.
+ */
+template <typename T>
+QMutex& SettingKey<T>::getMutexSlots()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+/*!
+ * \brief Allocate a slot in caches of values
+ * \details
+ * Slots released by destroyed handles are reused first.
+ *
+ * \return
+ * Returns slot of a new handle.
+ */
+template <typename T>
+int SettingKey<T>::allocateSlot()
+{
+    QMutexLocker locker(&getMutexSlots());
+
+    QVector<int> &freeSlots = getFreeSlots();
+    if(!freeSlots.isEmpty()){
+        return freeSlots.takeLast();
+    }
+
+    return s_nbSlots.fetch_add(1, std::memory_order_relaxed);
+}
+
+/*!
+ * \brief Release slot of a destroyed handle
+ *
+ * \param[in] slot
+ * Slot to release.
+ */
+template <typename T>
+void SettingKey<T>::releaseSlot(int slot)
+{
+    QMutexLocker locker(&getMutexSlots());
+    getFreeSlots().append(slot);
+}
+
+/*****************************/
+/* End namespace             */
+/*****************************/
+
+} // namespace tbq
+
+#endif // TBQ_CORE_SETTINGKEY_H
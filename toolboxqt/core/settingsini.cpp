@@ -1,6 +1,9 @@
 #include "settingsini.h"
 
+#include "toolboxqt/core/iniparser.h"
+
 #include <QFile>
+#include <QMutexLocker>
 
 /*****************************/
 /* Class documentations      */
@@ -44,6 +47,61 @@
  *
  * - <em>Main file :</em>
  * \include{lineno} maincustom.cpp
+ *
+ * All keys are kept in an immutable in-memory snapshot (see getSnapshot()),
+ * so getValue() never goes through \c QSettings: it is a lookup in the
+ * snapshot cached by calling thread, without locks (excepting first read
+ * after a write), and can be called from any thread (for example
+ * in render or network loops). \n
+ * setValue() writes to \c QSettings and publishes a new snapshot, writes
+ * are serialized and should stay occasional. \n
+ * Keys read in hot paths can use a tbq::SettingKey handle, which
+ * also skips key building and \c QVariant conversions.
+ *
+ * By default, setValue() writes to \c QSettings, which may write the
+ * file from calling thread. With setWriteBehind(), written values are
+ * only published in memory, and a background thread coalesces them
+ * and writes them to the file after a delay, atomically (file is
+ * replaced, see \c QSettings::setAtomicSyncRequired()). Pending values
+ * can be written with flush(), which is also called on destruction.
+ *
+ * With setHotReload(), file is watched: when it is modified (by an
+ * operator, a deployment tool...), it is parsed again in a background
+ * thread and compared to current values. Only modified keys
+ * (added, changed or removed) are published, and are notified
+ * at once with signal sSettingsChanged():
+ * \code{.cpp}
+ * mSettings.setHotReload(true);
+ * QObject::connect(&mSettings, &tbq::SettingsIni::sSettingsChanged, this, [](const QStringList &keys){
+ *     if(keys.contains("tuning/gain")){
+ *         updateGain();
+ *     }
+ * });
+ * \endcode
+ *
+ * Large files can be loaded with tbq::IniParser instead of \c QSettings
+ * (see loadSettings() and tbq::SettingsIni::Backend). \c QSettings is
+ * then only instantiated on first write.
+ *
+ * \note
+ * Current group (see groupBegin()) is shared by all threads, use
+ * full keys when reading from multiple threads.
+ */
+
+/*!
+ * \fn tbq::SettingsIni::sSettingsChanged(const QStringList &keys)
+ * \brief Signal emitted when values have been reloaded
+ * from modified file
+ * \details
+ * Signal is emitted from a background thread, once per reload,
+ * and only if at least one value changed. New values are already
+ * available when it is emitted.
+ *
+ * \param keys
+ * Sorted list of full keys which have been added,
+ * modified or removed.
+ *
+ * \sa setHotReload()
  */
 
 /*****************************/
@@ -68,6 +126,26 @@
  * \sa setHooksPreLoadSettings(), setHooksPostLoadSettings()
  */
 
+/*!
+ * \enum tbq::SettingsIni::Backend
+ * \brief List of backends used to read INI file
+ *
+ * \var tbq::SettingsIni::BACKEND_QSETTINGS
+ * Use \c QSettings, default backend.
+ *
+ * \var tbq::SettingsIni::BACKEND_PARSER
+ * Use tbq::IniParser (memory-mapped single-pass parser, compatible
+ * with \c QSettings), much faster on large files.
+ */
+
+/*!
+ * \typedef SettingsIni::Snapshot
+ * \brief Immutable map of all settings, keys being full
+ * paths (<tt>"section/key"</tt>)
+ *
+ * \sa getSnapshot()
+ */
+
 /*!
  * \def mSettings
  * \details
@@ -89,6 +167,72 @@ namespace tbq
 /* Constants definitions     */
 /*****************************/
 
+/*
+ * Each thread keeps last snapshot it used, so reads only need to check
+ * version of published snapshot (there is only one instance of SettingsIni)
+ */
+struct SnapshotCache
+{
+    quint64 version = 0;
+    std::shared_ptr<const SettingsIni::Snapshot> snapshot;
+};
+
+static thread_local SnapshotCache g_snapshotCache;
+
+/*****************************/
+/* Functions implementation  */
+/*         Local             */
+/*****************************/
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 4, 0)
+static QString toQString(QAnyStringView str)
+{
+    return str.toString();
+}
+#else
+static QString toQString(const QString &str)
+{
+    return str;
+}
+#endif
+
+static bool isListValue(const QVariant &value)
+{
+    const int type = value.userType();
+    return type == QMetaType::QStringList || type == QMetaType::QVariantList;
+}
+
+static bool isSameValue(const QVariant &left, const QVariant &right)
+{
+    if(left == right){
+        return true;
+    }
+
+    /* Lists are compared by elements (lists read from file are string lists) */
+    if(isListValue(left) || isListValue(right)){
+        if(!isListValue(left) || !isListValue(right)){
+            return false;
+        }
+
+        const QVariantList listLeft = left.toList();
+        const QVariantList listRight = right.toList();
+        if(listLeft.size() != listRight.size()){
+            return false;
+        }
+
+        for(int i = 0; i < listLeft.size(); ++i){
+            if(!isSameValue(listLeft.at(i), listRight.at(i))){
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /* Values read from file are strings, values written keep their type */
+    return left.canConvert<QString>() && right.canConvert<QString>() && left.toString() == right.toString();
+}
+
 /*****************************/
 /* Functions implementation  */
 /*         Class             */
@@ -101,9 +245,28 @@ SettingsIni &SettingsIni::instance()
 }
 
 SettingsIni::SettingsIni()
-    : m_settings(nullptr), m_hookPreload(defaultHook), m_hookPostLoad(defaultHook)
+    : m_settings(nullptr), m_backend(BACKEND_QSETTINGS), m_snapshot(nullptr), m_snapshotVersion(1),
+      m_writeBehind(false), m_writeDelay(SETTINGS_WRITE_DELAY_DEFAULT), m_writerStop(false),
+      m_hotReload(false), m_watcher(nullptr), m_reloadScheduled(false),
+      m_hookPreload(defaultHook), m_hookPostLoad(defaultHook)
+{
+    /* Reloads are serialized */
+    m_poolReload.setMaxThreadCount(1);
+}
+
+/*!
+ * \brief Destroy settings
+ * \details
+ * Pending reload is finished, background writer
+ * is stopped, and pending values are written.
+ *
+ * \sa flush()
+ */
+SettingsIni::~SettingsIni()
 {
-    /* Nothing to do */
+    m_poolReload.waitForDone();
+    stopWriter();
+    flush();
 }
 
 /*!
@@ -111,13 +274,16 @@ SettingsIni::SettingsIni()
 
  * \param fileInfo
  * INI configuration file to use
+ * \param backend
+ * Backend used to read the file (and to reload it, see
+ * setHotReload()).
  *
  * \return
  * Return \c true if loading succeed.
  *
  * \sa setHooksPreLoadSettings(), setHooksPostLoadSettings()
  */
-bool SettingsIni::loadSettings(const QFileInfo &fileInfo)
+bool SettingsIni::loadSettings(const QFileInfo &fileInfo, Backend backend)
 {
     /* Perform pre-operations */
     bool succeed = m_hookPreload(fileInfo);
@@ -125,41 +291,326 @@ bool SettingsIni::loadSettings(const QFileInfo &fileInfo)
         return false;
     }
 
-    /* Instantiate settings */
-    m_settings = std::make_unique<QSettings>(fileInfo.absoluteFilePath(), QSettings::IniFormat);
+    /* Pending values belong to previous file */
+    flush();
+
+    /* Parse file, a missing file is an empty configuration (like with QSettings) */
+    const QString filePath = fileInfo.absoluteFilePath();
+    std::shared_ptr<Snapshot> snapshot = std::make_shared<Snapshot>();
+
+    if(backend == BACKEND_PARSER && !IniParser::parseFile(filePath, *snapshot) && fileInfo.exists()){
+        return false;
+    }
+
+    /* Instantiate settings and read all keys */
+    {
+        QMutexLocker locker(&m_mutexWrite);
+        m_filePath = filePath;
+        m_backend = backend;
+        m_settings.reset();
+
+        {
+            QMutexLocker lockerPending(&m_mutexPending);
+            m_pendingFile = filePath;
+        }
+
+        if(backend == BACKEND_QSETTINGS){
+            QSettings *settings = getSettings();
+            const QStringList keys = settings->allKeys();
+            for(const QString &key : keys){
+                snapshot->insert(key, settings->value(key));
+            }
+        }
+
+        publishSnapshot(snapshot);
+    }
+
+    updateWatcher();
 
     /* Perform post operations */
     return m_hookPostLoad(fileInfo);
 }
 
+/*!
+ * \brief Begin a group of keys
+ * \details
+ * Next keys will be relative to this group,
+ * until groupEnd() is called. Groups can be nested.
+ *
+ * \param keyGroup
+ * Group to use (<tt>"section"</tt> for example)
+ */
 void SettingsIni::groupBegin(TB_QTCOMPAT_STR_VIEW keyGroup)
 {
-    if(m_settings){
-        m_settings->beginGroup(keyGroup);
+    const QString group = normalizeKey(toQString(keyGroup));
+
+    m_groupStack.append(m_groupPrefix);
+    if(!group.isEmpty()){
+        m_groupPrefix += group + QLatin1Char('/');
     }
 }
 
+/*!
+ * \brief End current group of keys
+ *
+ * \sa groupBegin()
+ */
 void SettingsIni::groupEnd()
 {
-    if(m_settings){
-        m_settings->endGroup();
+    if(!m_groupStack.isEmpty()){
+        m_groupPrefix = m_groupStack.takeLast();
     }
 }
 
+/*!
+ * \brief Set value of a key
+ * \details
+ * Value is written to \c QSettings (and so will be saved
+ * to file), or queued to background writer if write-behind
+ * mode is enabled (see setWriteBehind()), then a new snapshot
+ * is published.
+ *
+ * \note
+ * Publishing a snapshot copies all values (readers may still use
+ * current one), so each call costs <tt>O(n)</tt>. When many values
+ * are written at once, prefer setValues() which publishes a
+ * single snapshot.
+ *
+ * \param key
+ * Key to set, relative to current group.
+ * \param value
+ * Value to set.
+ *
+ * \sa setValues()
+ */
 void SettingsIni::setValue(TB_QTCOMPAT_STR_VIEW key, const QVariant &value)
 {
-    if(m_settings){
-        m_settings->setValue(key, value);
+    setValueFullKey(toFullKey(key), value);
+}
+
+/*!
+ * \brief Set values of multiple keys
+ * \details
+ * Equivalent of calling setValue() for each key, but
+ * only one snapshot is published for all values.
+ *
+ * \param values
+ * Values to set, keys being relative to current group.
+ *
+ * \sa setValue()
+ */
+void SettingsIni::setValues(const QVariantHash &values)
+{
+    QMutexLocker locker(&m_mutexWrite);
+    if(m_filePath.isEmpty() || values.isEmpty()){
+        return;
     }
+
+    std::shared_ptr<Snapshot> snapshot = copySnapshot();
+    for(QVariantHash::const_iterator it = values.constBegin(); it != values.constEnd(); ++it){
+        storeValue(*snapshot, toFullKey(it.key()), it.value());
+    }
+
+    publishSnapshot(snapshot);
 }
 
+/*!
+ * \brief Get value of a key
+ * \details
+ * Value is read from current snapshot (see getSnapshot()).
+ *
+ * \param key
+ * Key to read, relative to current group.
+ * \param defaultValue
+ * Value to return if key doesn't exist.
+ *
+ * \return
+ * Returns value of the key. \n
+ * Returns invalid value if settings are not loaded.
+ */
 QVariant SettingsIni::getValue(TB_QTCOMPAT_STR_VIEW key, const QVariant &defaultValue) const
 {
-    if(!m_settings){
+    const std::shared_ptr<const Snapshot> snapshot = getSnapshot();
+    if(!snapshot){
         return QVariant();
     }
 
-    return m_settings->value(key, defaultValue);
+    const Snapshot::const_iterator it = findKey(*snapshot, key);
+    if(it == snapshot->constEnd()){
+        return defaultValue;
+    }
+
+    return it.value();
+}
+
+/*!
+ * \brief Get snapshot of all settings
+ * \details
+ * Snapshot is immutable: later writes publish new snapshots,
+ * this one stays valid as long as it is referenced. \n
+ * Can be called from any thread. Each thread keeps a reference to
+ * last snapshot it used, so only its first call following a write
+ * takes a (short) lock to get the new one.
+ *
+ * \return
+ * Returns current snapshot. \n
+ * Returns \c nullptr if settings are not loaded.
+ */
+std::shared_ptr<const SettingsIni::Snapshot> SettingsIni::getSnapshot() const
+{
+    const quint64 version = m_snapshotVersion.load(std::memory_order_acquire);
+    if(g_snapshotCache.version != version){
+        QMutexLocker locker(&m_mutexSnapshot);
+        g_snapshotCache.snapshot = m_snapshot;
+        g_snapshotCache.version = version;
+    }
+
+    return g_snapshotCache.snapshot;
+}
+
+/*!
+ * \brief Get version of current snapshot
+ * \details
+ * Version is incremented each time a snapshot is published
+ * (on loading and on each write), so it can be used to know
+ * if values cached from previous snapshot are still valid.
+ *
+ * \return
+ * Returns version of current snapshot.
+ *
+ * \sa getSnapshot()
+ */
+quint64 SettingsIni::getSnapshotVersion() const
+{
+    return m_snapshotVersion.load(std::memory_order_acquire);
+}
+
+/*!
+ * \brief Check if write-behind mode is enabled
+ *
+ * \return
+ * Returns \c true if written values are saved
+ * by background writer.
+ *
+ * \sa setWriteBehind()
+ */
+bool SettingsIni::isWriteBehind() const
+{
+    return m_writeBehind.load();
+}
+
+/*!
+ * \brief Enable or disable write-behind mode
+ * \details
+ * When enabled, setValue() only publishes values in memory
+ * (readers see them immediately) and queues them. A background
+ * thread waits \c msecDelay milliseconds after first queued
+ * value, so values written meanwhile are coalesced (only last
+ * value of each key is kept), then writes them to the file. \n
+ * When disabled, pending values are written before returning.
+ *
+ * \param enable
+ * Set to \c true to enable write-behind mode.
+ * \param msecDelay
+ * Delay (in milliseconds) used to coalesce writes.
+ *
+ * \note
+ * Should be configured from the thread which loaded
+ * settings, not concurrently with other configuration calls.
+ *
+ * \sa flush()
+ */
+void SettingsIni::setWriteBehind(bool enable, int msecDelay)
+{
+    QMutexLocker locker(&m_mutexWrite);
+
+    {
+        QMutexLocker lockerPending(&m_mutexPending);
+        m_writeDelay = qMax(0, msecDelay);
+    }
+
+    if(enable == m_writeBehind.load()){
+        return;
+    }
+
+    if(enable){
+        /* Values set before must be in file before writer uses it */
+        if(m_settings){
+            m_settings->sync();
+        }
+
+        m_writeBehind.store(true);
+        startWriter();
+        return;
+    }
+
+    m_writeBehind.store(false);
+    locker.unlock();
+
+    stopWriter();
+    flush();
+}
+
+/*!
+ * \brief Write all pending values to the file
+ * \details
+ * Pending values of write-behind mode are written by
+ * calling thread, then \c QSettings is synchronized. \n
+ * Can be called at any time (before leaving application
+ * for example), this is also done on destruction.
+ *
+ * \return
+ * Returns \c true if succeed.
+ *
+ * \sa setWriteBehind()
+ */
+bool SettingsIni::flush()
+{
+    bool succeed = writePending();
+
+    QMutexLocker locker(&m_mutexWrite);
+    if(m_settings){
+        m_settings->sync();
+        succeed = succeed && m_settings->status() == QSettings::NoError;
+    }
+
+    return succeed;
+}
+
+/*!
+ * \brief Check if hot reload is enabled
+ *
+ * \return
+ * Returns \c true if file is watched.
+ *
+ * \sa setHotReload()
+ */
+bool SettingsIni::isHotReload() const
+{
+    return m_hotReload;
+}
+
+/*!
+ * \brief Enable or disable hot reload of the file
+ * \details
+ * When enabled, loaded file (and files loaded later) is watched,
+ * and modified values are reloaded without restarting application
+ * (see sSettingsChanged()). \n
+ * Values queued by write-behind mode (see setWriteBehind()) are newer
+ * than the file, so they are kept. Hooks are not called on reload.
+ *
+ * \param enable
+ * Set to \c true to enable hot reload.
+ *
+ * \note
+ * Must be called from thread of this object (main thread usually),
+ * which must run an event loop. For the same reason, loadSettings()
+ * must also be called from this thread when hot reload is enabled.
+ */
+void SettingsIni::setHotReload(bool enable)
+{
+    m_hotReload = enable;
+    updateWatcher();
 }
 
 /*!
@@ -186,6 +637,519 @@ void SettingsIni::setHooksPostLoadSettings(CbHook hookPostload)
     m_hookPostLoad = hookPostload;
 }
 
+/*!
+ * \brief Get \c QSettings used to write values
+ * \details
+ * With parser backend, \c QSettings is only instantiated
+ * here, on first need. \n
+ * Must be called with \c m_mutexWrite locked.
+ *
+ * \return
+ * Returns \c QSettings of loaded file. \n
+ * Returns \c nullptr if settings are not loaded.
+ */
+QSettings* SettingsIni::getSettings()
+{
+    if(!m_settings && !m_filePath.isEmpty()){
+        m_settings = std::make_unique<QSettings>(m_filePath, QSettings::IniFormat);
+    }
+
+    return m_settings.get();
+}
+
+/*!
+ * \brief Convert a key to a full key (including
+ * current group), as stored in snapshots
+ *
+ * \param key
+ * Key relative to current group.
+ *
+ * \return
+ * Returns normalized full key
+ */
+QString SettingsIni::toFullKey(TB_QTCOMPAT_STR_VIEW key) const
+{
+    const QString normalized = normalizeKey(toQString(key));
+    if(m_groupPrefix.isEmpty()){
+        return normalized;
+    }
+
+    return m_groupPrefix + normalized;
+}
+
+/*!
+ * \brief Find a key in a snapshot
+ * \details
+ * Keys of snapshots are normalized, so when no group is used, key
+ * is first looked up as is: keys found don't need to be normalized
+ * (nor copied when using \c QString). Key is normalized only if
+ * not found.
+ *
+ * \param snapshot
+ * Snapshot to use.
+ * \param key
+ * Key relative to current group.
+ *
+ * \return
+ * Returns iterator to value of the key, or end
+ * iterator if key doesn't exist.
+ */
+SettingsIni::Snapshot::const_iterator SettingsIni::findKey(const Snapshot &snapshot, TB_QTCOMPAT_STR_VIEW key) const
+{
+    if(!m_groupPrefix.isEmpty()){
+        return snapshot.constFind(toFullKey(key));
+    }
+
+    const QString keyStr = toQString(key);
+    const Snapshot::const_iterator it = snapshot.constFind(keyStr);
+    if(it != snapshot.constEnd()){
+        return it;
+    }
+
+    const QString normalized = normalizeKey(keyStr);
+    if(normalized == keyStr){
+        return snapshot.constEnd();
+    }
+
+    return snapshot.constFind(normalized);
+}
+
+/*!
+ * \brief Set value of a full key
+ * \details
+ * Value is written to \c QSettings (or queued to
+ * background writer), then a new snapshot is published.
+ *
+ * \param fullKey
+ * Normalized full key (see toFullKey()).
+ * \param value
+ * Value to set.
+ */
+void SettingsIni::setValueFullKey(const QString &fullKey, const QVariant &value)
+{
+    QMutexLocker locker(&m_mutexWrite);
+    if(m_filePath.isEmpty()){
+        return;
+    }
+
+    std::shared_ptr<Snapshot> snapshot = copySnapshot();
+    storeValue(*snapshot, fullKey, value);
+
+    publishSnapshot(snapshot);
+}
+
+/*!
+ * \brief Store value of a full key
+ * \details
+ * Value is written to \c QSettings (or queued to background
+ * writer) and inserted in snapshot which will be published. \n
+ * Must be called with \c m_mutexWrite locked.
+ *
+ * \param snapshot
+ * Snapshot to update.
+ * \param fullKey
+ * Normalized full key (see toFullKey()).
+ * \param value
+ * Value to set.
+ */
+void SettingsIni::storeValue(Snapshot &snapshot, const QString &fullKey, const QVariant &value)
+{
+    if(m_writeBehind.load()){
+        QMutexLocker lockerPending(&m_mutexPending);
+        if(m_pendingWrites.isEmpty()){
+            m_condPending.wakeAll();
+        }
+        m_pendingWrites.insert(fullKey, value);
+    }else{
+        getSettings()->setValue(fullKey, value);
+    }
+
+    snapshot.insert(fullKey, value);
+}
+
+/*!
+ * \brief Copy current snapshot, to be modified then published
+ * \details
+ * Current snapshot may be in use by readers, so it is never modified. \n
+ * Must be called with \c m_mutexWrite locked.
+ *
+ * \return
+ * Returns copy of current snapshot (empty if no
+ * snapshot is published).
+ */
+std::shared_ptr<SettingsIni::Snapshot> SettingsIni::copySnapshot() const
+{
+    return m_snapshot ? std::make_shared<Snapshot>(*m_snapshot) : std::make_shared<Snapshot>();
+}
+
+/*!
+ * \brief Publish a new snapshot
+ * \details
+ * Snapshot is stored before incrementing version, so
+ * readers seeing new version will always get it. \n
+ * Must be called with \c m_mutexWrite locked.
+ *
+ * \param snapshot
+ * Snapshot to publish.
+ */
+void SettingsIni::publishSnapshot(const std::shared_ptr<const Snapshot> &snapshot)
+{
+    {
+        QMutexLocker locker(&m_mutexSnapshot);
+        m_snapshot = snapshot;
+    }
+
+    m_snapshotVersion.fetch_add(1, std::memory_order_release);
+}
+
+/*!
+ * \brief Start background writer of
+ * write-behind mode
+ */
+void SettingsIni::startWriter()
+{
+    if(m_writer.joinable()){
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_mutexPending);
+        m_writerStop = false;
+    }
+
+    m_writer = std::thread(&SettingsIni::runWriter, this);
+}
+
+/*!
+ * \brief Stop background writer of write-behind mode
+ * \details
+ * Returns once writer thread is finished, pending
+ * values are kept (see flush()).
+ */
+void SettingsIni::stopWriter()
+{
+    if(!m_writer.joinable()){
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_mutexPending);
+        m_writerStop = true;
+        m_condPending.wakeAll();
+    }
+
+    m_writer.join();
+}
+
+/*!
+ * \brief Loop of background writer
+ * \details
+ * Writer waits for a first pending value, then waits
+ * during delay so following values are coalesced, and
+ * writes all of them at once.
+ */
+void SettingsIni::runWriter()
+{
+    QMutexLocker locker(&m_mutexPending);
+    while(!m_writerStop){
+        if(m_pendingWrites.isEmpty()){
+            m_condPending.wait(&m_mutexPending);
+            continue;
+        }
+
+        /* Only a stop request wakes up writer during delay */
+        m_condPending.wait(&m_mutexPending, static_cast<unsigned long>(m_writeDelay));
+
+        locker.unlock();
+        writePending();
+        locker.relock();
+    }
+}
+
+/*!
+ * \brief Write pending values of write-behind mode
+ * \details
+ * A dedicated \c QSettings is used, so writing doesn't depend
+ * on thread affinity of main one. File is replaced atomically. \n
+ * Calls are serialized, so values are written in order.
+ *
+ * \return
+ * Returns \c true if succeed (or if there is nothing to write).
+ */
+bool SettingsIni::writePending()
+{
+    QMutexLocker lockerFlush(&m_mutexFlush);
+
+    QString filePath;
+    Snapshot pending;
+    {
+        QMutexLocker locker(&m_mutexPending);
+        filePath = m_pendingFile;
+        pending.swap(m_pendingWrites);
+    }
+
+    if(pending.isEmpty() || filePath.isEmpty()){
+        return true;
+    }
+
+    QSettings settings(filePath, QSettings::IniFormat);
+    settings.setAtomicSyncRequired(true);
+
+    for(Snapshot::const_iterator it = pending.cbegin(); it != pending.cend(); ++it){
+        settings.setValue(it.key(), it.value());
+    }
+
+    settings.sync();
+    return settings.status() == QSettings::NoError;
+}
+
+/*!
+ * \brief Watch loaded file, or stop watching
+ * it, depending on hot reload status
+ */
+void SettingsIni::updateWatcher()
+{
+    QString filePath;
+    {
+        QMutexLocker locker(&m_mutexWrite);
+        filePath = m_filePath;
+    }
+
+    if(!m_watcher){
+        if(!m_hotReload){
+            return;
+        }
+
+        m_watcher = new QFileSystemWatcher(this); // Using "this" as parent, object will be automatically destroyed
+        connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &SettingsIni::eventFileChanged);
+    }
+
+    const QStringList files = m_watcher->files();
+    if(!files.isEmpty()){
+        m_watcher->removePaths(files);
+    }
+
+    if(m_hotReload && !filePath.isEmpty()){
+        m_watcher->addPath(filePath);
+    }
+}
+
+/*!
+ * \brief Parse file again and publish modified values
+ * \details
+ * Called from reload thread, file is parsed with
+ * backend used to load it (see readValues()). \n
+ * Parsed values are compared to current snapshot, and only
+ * modified keys are published, then notified with
+ * sSettingsChanged(). \n
+ * Runs with \c m_mutexFlush locked, so values of write-behind
+ * mode are either pending or already written. Values written to
+ * \c QSettings are synchronized before reading, and reload is
+ * scheduled again if values are written during it.
+ *
+ * \param filePath
+ * Path of modified file.
+ */
+void SettingsIni::reloadSettings(const QString &filePath)
+{
+    /* Modifications from now will need another reload */
+    m_reloadScheduled.store(false);
+
+    /*
+     * Pending values being written are no longer in pending
+     * ones but may not be in file yet: wait for them
+     */
+    QMutexLocker lockerFlush(&m_mutexFlush);
+
+    Backend backend;
+    quint64 version;
+    {
+        QMutexLocker locker(&m_mutexWrite);
+        backend = m_backend;
+
+        /* Values written to QSettings may not be in file yet (file access is synchronized by QSettings) */
+        if(m_settings){
+            m_settings->sync();
+        }
+        version = m_snapshotVersion.load(std::memory_order_acquire);
+    }
+
+    Snapshot values;
+    if(!readValues(filePath, backend, values)){
+        return;
+    }
+
+    /* Compare with current values */
+    QStringList keysChanged;
+    {
+        QMutexLocker locker(&m_mutexWrite);
+        if(!m_snapshot || m_filePath != filePath){
+            return;
+        }
+
+        /* Values written meanwhile may be missing from read file (pending ones are skipped below) */
+        if(!m_writeBehind.load() && m_snapshotVersion.load(std::memory_order_acquire) != version){
+            locker.unlock();
+            scheduleReload(filePath);
+            return;
+        }
+
+        std::shared_ptr<Snapshot> snapshot = std::make_shared<Snapshot>(*m_snapshot);
+
+        QMutexLocker lockerPending(&m_mutexPending);
+        for(Snapshot::const_iterator it = m_snapshot->cbegin(); it != m_snapshot->cend(); ++it){
+            if(!values.contains(it.key()) && !m_pendingWrites.contains(it.key())){
+                snapshot->remove(it.key());
+                keysChanged.append(it.key());
+            }
+        }
+
+        for(Snapshot::const_iterator it = values.cbegin(); it != values.cend(); ++it){
+            if(m_pendingWrites.contains(it.key())){
+                continue;
+            }
+
+            const Snapshot::const_iterator itCurrent = m_snapshot->constFind(it.key());
+            if(itCurrent == m_snapshot->constEnd() || !isSameValue(itCurrent.value(), it.value())){
+                snapshot->insert(it.key(), it.value());
+                keysChanged.append(it.key());
+            }
+        }
+
+        if(keysChanged.isEmpty()){
+            return;
+        }
+
+        publishSnapshot(snapshot);
+    }
+
+    keysChanged.sort();
+    emit sSettingsChanged(keysChanged);
+}
+
+/*!
+ * \brief Called when watched file is modified
+ * \details
+ * Reload is scheduled in background, successive
+ * modifications are coalesced while it is pending.
+ *
+ * \param path
+ * Path of modified file.
+ */
+void SettingsIni::eventFileChanged(const QString &path)
+{
+    /* Files replaced when saved (by editors for example) are no longer watched */
+    if(m_hotReload && !m_watcher->files().contains(path) && QFileInfo::exists(path)){
+        m_watcher->addPath(path);
+    }
+
+    scheduleReload(path);
+}
+
+/*!
+ * \brief Schedule a reload of the file
+ * \details
+ * Does nothing if a reload is already scheduled
+ * and not started yet.
+ *
+ * \param filePath
+ * Path of file to reload.
+ */
+void SettingsIni::scheduleReload(const QString &filePath)
+{
+    if(!m_reloadScheduled.exchange(true)){
+        m_poolReload.start([this, filePath](){
+            reloadSettings(filePath);
+        });
+    }
+}
+
+/*!
+ * \brief Read all values of a file
+ * \details
+ * Used to reload watched file. \n
+ * With \c QSettings backend, a dedicated \c QSettings is
+ * used, since main one may belong to another thread.
+ *
+ * \param filePath
+ * Path of INI file.
+ * \param backend
+ * Backend to use.
+ * \param values
+ * Read values are inserted in it.
+ *
+ * \return
+ * Returns \c true if succeed.
+ */
+bool SettingsIni::readValues(const QString &filePath, Backend backend, Snapshot &values)
+{
+    /* File may be rewritten while it is parsed, so it is not mapped */
+    if(backend == BACKEND_PARSER){
+        return IniParser::parseFile(filePath, values, false);
+    }
+
+    QSettings settings(filePath, QSettings::IniFormat);
+    settings.sync();
+    if(settings.status() != QSettings::NoError){
+        return false;
+    }
+
+    const QStringList keys = settings.allKeys();
+    for(const QString &key : keys){
+        values.insert(key, settings.value(key));
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Normalize a key like \c QSettings does
+ * \details
+ * Backslashes are converted to slashes, and empty
+ * sections (leading, trailing or repeated slashes)
+ * are removed. Keys already normalized are returned
+ * without copy.
+ *
+ * \param key
+ * Key to normalize.
+ *
+ * \return
+ * Returns normalized key
+ */
+QString SettingsIni::normalizeKey(const QString &key)
+{
+    /* Fast path: most keys are already normalized */
+    bool normalized = !key.startsWith(QLatin1Char('/')) && !key.endsWith(QLatin1Char('/'));
+    for(int i = 0; normalized && i < key.size(); ++i){
+        const QChar c = key.at(i);
+        normalized = c != QLatin1Char('\\') && !(c == QLatin1Char('/') && i > 0 && key.at(i - 1) == QLatin1Char('/'));
+    }
+
+    if(normalized){
+        return key;
+    }
+
+    QString result;
+    result.reserve(key.size());
+
+    for(QChar c : key){
+        if(c == QLatin1Char('\\')){
+            c = QLatin1Char('/');
+        }
+        if(c == QLatin1Char('/') && (result.isEmpty() || result.endsWith(QLatin1Char('/')))){
+            continue;
+        }
+
+        result.append(c);
+    }
+
+    if(result.endsWith(QLatin1Char('/'))){
+        result.chop(1);
+    }
+
+    return result;
+}
+
 bool SettingsIni::defaultHook(const QFileInfo &fileInfo)
 {
     return true;
@@ -4,21 +4,42 @@
 #include "toolboxqt/toolboxqt_global.h"
 
 #include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
 #include <QSettings>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVariant>
+#include <QWaitCondition>
 
+#include <atomic>
 #include <memory>
+#include <thread>
 
 #define mSettings   tbq::SettingsIni::instance()
 
 namespace tbq
 {
 
-class TOOLBOXQT_EXPORT SettingsIni final
+constexpr int SETTINGS_WRITE_DELAY_DEFAULT = 500;
+
+class TOOLBOXQT_EXPORT SettingsIni final : public QObject
 {
+    Q_OBJECT
     TOOLBOXQT_DISABLE_COPY_MOVE(SettingsIni)
 
+public:
+    enum Backend
+    {
+        BACKEND_QSETTINGS = 0,
+        BACKEND_PARSER
+    };
+
 public:
     using CbHook = std::function<bool(const QFileInfo &fileInfo)>;
+    using Snapshot = QHash<QString, QVariant>;
 
 public:
     static SettingsIni& instance();
@@ -27,26 +48,96 @@ private:
     explicit SettingsIni();
 
 public:
-    bool loadSettings(const QFileInfo &fileInfo);
+    ~SettingsIni();
+
+public:
+    bool loadSettings(const QFileInfo &fileInfo, Backend backend = BACKEND_QSETTINGS);
 
     void groupBegin(TB_QTCOMPAT_STR_VIEW keyGroup);
     void groupEnd();
 
     void setValue(TB_QTCOMPAT_STR_VIEW key, const QVariant &value);
+    void setValues(const QVariantHash &values);
     QVariant getValue(TB_QTCOMPAT_STR_VIEW key, const QVariant &defaultValue = QVariant()) const;
 
+    std::shared_ptr<const Snapshot> getSnapshot() const;
+    quint64 getSnapshotVersion() const;
+
+    bool isWriteBehind() const;
+    void setWriteBehind(bool enable, int msecDelay = SETTINGS_WRITE_DELAY_DEFAULT);
+
+    bool flush();
+
+    bool isHotReload() const;
+    void setHotReload(bool enable);
+
 public:
     void setHooksPreLoadSettings(CbHook hookPreload);
     void setHooksPostLoadSettings(CbHook hookPostload);
 
+signals:
+    void sSettingsChanged(const QStringList &keys);
+
 private:
+    QSettings* getSettings();
+
+    QString toFullKey(TB_QTCOMPAT_STR_VIEW key) const;
+    Snapshot::const_iterator findKey(const Snapshot &snapshot, TB_QTCOMPAT_STR_VIEW key) const;
+
+    void setValueFullKey(const QString &fullKey, const QVariant &value);
+    void storeValue(Snapshot &snapshot, const QString &fullKey, const QVariant &value);
+    std::shared_ptr<Snapshot> copySnapshot() const;
+    void publishSnapshot(const std::shared_ptr<const Snapshot> &snapshot);
+
+    void startWriter();
+    void stopWriter();
+    void runWriter();
+    bool writePending();
+
+    void updateWatcher();
+    void reloadSettings(const QString &filePath);
+    void scheduleReload(const QString &filePath);
+
+    void eventFileChanged(const QString &path);
+
+private:
+    static bool readValues(const QString &filePath, Backend backend, Snapshot &values);
+    static QString normalizeKey(const QString &key);
     static bool defaultHook(const QFileInfo &fileInfo);
 
 private:
     std::unique_ptr<QSettings> m_settings;
+    QString m_filePath;
+    Backend m_backend;
+    QMutex m_mutexWrite;
+
+    std::shared_ptr<const Snapshot> m_snapshot;
+    std::atomic<quint64> m_snapshotVersion;
+    mutable QMutex m_mutexSnapshot;
+
+    std::atomic<bool> m_writeBehind;
+    int m_writeDelay;
+    QString m_pendingFile;
+    Snapshot m_pendingWrites;
+    QMutex m_mutexPending;
+    QMutex m_mutexFlush;
+    QWaitCondition m_condPending;
+    std::thread m_writer;
+    bool m_writerStop;
+
+    bool m_hotReload;
+    QFileSystemWatcher *m_watcher;
+    QThreadPool m_poolReload;
+    std::atomic<bool> m_reloadScheduled;
+
+    QString m_groupPrefix;
+    QStringList m_groupStack;
 
     CbHook m_hookPreload;
     CbHook m_hookPostLoad;
+
+    template <typename T>
+    friend class SettingKey;
 };
 
 } // namespace tbq